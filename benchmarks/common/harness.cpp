@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+
+#include "harness.hpp"
+
+namespace {
+
+/***********************************************************************************************************************
+ * Vars
+ **********************************************************************************************************************/
+
+std::atomic_size_t sAllocationCount {};
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Allocation counting
+ **********************************************************************************************************************/
+
+void* operator new(size_t size)
+{
+    sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr) {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace aos::common::benchmark {
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+Runner::Runner(int argc, char** argv)
+{
+    const std::string minTimeArg = "--min-time=";
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg.compare(0, minTimeArg.size(), minTimeArg) == 0) {
+            mMinTime = std::atof(arg.c_str() + minTimeArg.size());
+        } else {
+            mFilter = arg;
+        }
+    }
+
+    std::printf("%-56s %10s %14s %12s %14s\n", "Benchmark", "Iterations", "ns/iter", "MB/s", "allocs/iter");
+}
+
+void Runner::Run(const std::string& name, size_t bytes, const std::function<void()>& func)
+{
+    if (name.find(mFilter) == std::string::npos) {
+        return;
+    }
+
+    // Warm up caches and lazy initialization.
+    func();
+
+    size_t iterations  = 0;
+    size_t batch       = 1;
+    auto   elapsed     = std::chrono::nanoseconds::zero();
+    auto   allocations = GetAllocationCount();
+
+    while (elapsed < std::chrono::duration<double>(mMinTime)) {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < batch; i++) {
+            func();
+        }
+
+        elapsed += std::chrono::steady_clock::now() - start;
+        iterations += batch;
+        batch *= 2;
+    }
+
+    allocations = GetAllocationCount() - allocations;
+
+    Result result;
+
+    result.mName                    = name;
+    result.mIterations              = iterations;
+    result.mNsPerIteration          = static_cast<double>(elapsed.count()) / iterations;
+    result.mBytesPerSecond          = static_cast<double>(bytes) * 1e9 / result.mNsPerIteration;
+    result.mAllocationsPerIteration = static_cast<double>(allocations) / iterations;
+
+    char throughput[32] = "-";
+
+    if (bytes != 0) {
+        std::snprintf(throughput, sizeof(throughput), "%.2f", result.mBytesPerSecond / (1024 * 1024));
+    }
+
+    std::printf("%-56s %10zu %14.1f %12s %14.1f\n", result.mName.c_str(), result.mIterations,
+        result.mNsPerIteration, throughput, result.mAllocationsPerIteration);
+    std::fflush(stdout);
+
+    mResults.push_back(std::move(result));
+}
+
+size_t GetAllocationCount()
+{
+    return sAllocationCount.load(std::memory_order_relaxed);
+}
+
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream file(path);
+
+    if (!file) {
+        std::fprintf(stderr, "can't read file: %s\n", path.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+} // namespace aos::common::benchmark
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BENCHMARK_HARNESS_HPP_
+#define BENCHMARK_HARNESS_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace aos::common::benchmark {
+
+/***********************************************************************************************************************
+ * Types
+ **********************************************************************************************************************/
+
+/**
+ * Benchmark result.
+ */
+struct Result {
+    std::string mName;
+    size_t      mIterations {};
+    double      mNsPerIteration {};
+    double      mBytesPerSecond {};
+    double      mAllocationsPerIteration {};
+};
+
+/**
+ * Benchmark runner. Each benchmark function is called in growing batches until the minimal run time is reached. Time
+ * and heap allocations (global operator new calls) are measured over all batches.
+ *
+ * Command line: [--min-time=<seconds>] [filter], only benchmarks which name contains filter are run.
+ */
+class Runner {
+public:
+    /**
+     * Constructor.
+     *
+     * @param argc argument count.
+     * @param argv arguments.
+     */
+    Runner(int argc, char** argv);
+
+    /**
+     * Runs benchmark and prints its result.
+     *
+     * @param name benchmark name.
+     * @param bytes number of bytes processed by one call.
+     * @param func benchmark function.
+     */
+    void Run(const std::string& name, size_t bytes, const std::function<void()>& func);
+
+    /**
+     * Returns results of all run benchmarks.
+     *
+     * @return const std::vector<Result>&.
+     */
+    const std::vector<Result>& GetResults() const { return mResults; }
+
+private:
+    double              mMinTime {0.5};
+    std::string         mFilter;
+    std::vector<Result> mResults;
+};
+
+/***********************************************************************************************************************
+ * Functions
+ **********************************************************************************************************************/
+
+/**
+ * Returns number of heap allocations done by the process.
+ *
+ * @return size_t.
+ */
+size_t GetAllocationCount();
+
+/**
+ * Prevents compiler from optimizing out computation of the value.
+ *
+ * @param value value.
+ */
+template <typename T>
+void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+/**
+ * Reads file content. Terminates the process if file can't be read.
+ *
+ * @param path file path.
+ * @return std::string.
+ */
+std::string ReadFile(const std::string& path);
+
+} // namespace aos::common::benchmark
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BENCHMARKS_UTILS_BENCHMARKS_HPP_
+#define BENCHMARKS_UTILS_BENCHMARKS_HPP_
+
+#include <string>
+
+#include "harness.hpp"
+
+/**
+ * Runs json benchmarks.
+ *
+ * @param runner benchmark runner.
+ * @param tmpDir directory for temporary files.
+ */
+void RunJsonBenchmarks(aos::common::benchmark::Runner& runner, const std::string& tmpDir);
+
+/**
+ * Runs image benchmarks.
+ *
+ * @param runner benchmark runner.
+ * @param tmpDir directory for temporary files.
+ */
+void RunImageBenchmarks(aos::common::benchmark::Runner& runner, const std::string& tmpDir);
+
+/**
+ * Runs parser benchmarks.
+ *
+ * @param runner benchmark runner.
+ */
+void RunParserBenchmarks(aos::common::benchmark::Runner& runner);
+
+#endif
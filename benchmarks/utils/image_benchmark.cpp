@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <Poco/DigestEngine.h>
+#include <Poco/DigestStream.h>
+#include <Poco/SHA2Engine.h>
+#include <Poco/StreamCopier.h>
+
+#include "benchmarks.hpp"
+#include "harness.hpp"
+#include "utils/digest.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/image.hpp"
+
+using namespace aos::common::benchmark;
+using namespace aos::common::utils;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/***********************************************************************************************************************
+ * Types
+ **********************************************************************************************************************/
+
+struct FileSet {
+    const char* mName;
+    size_t      mFileCount;
+    size_t      mFileSize;
+};
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+// Service directory with many small files and layer with a few big blobs.
+const FileSet cFileSets[] = {{"small", 4096, 4 * 1024}, {"large", 4, 32 * 1024 * 1024}};
+
+constexpr auto cDirCount = 64;
+
+constexpr size_t cHasherDataSize = 64 * 1024 * 1024;
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+size_t CreateFileSet(const std::string& dir, const FileSet& fileSet)
+{
+    std::string content(fileSet.mFileSize, '\0');
+
+    for (size_t i = 0; i < content.size(); i++) {
+        content[i] = static_cast<char>((i * 2654435761u) >> 13);
+    }
+
+    for (size_t i = 0; i < fileSet.mFileCount; i++) {
+        const auto subdir = fs::path(dir) / std::to_string(i % cDirCount);
+
+        fs::create_directories(subdir);
+
+        content[0] = static_cast<char>(i);
+
+        std::ofstream(subdir / std::to_string(i), std::ios::binary) << content;
+    }
+
+    // Written pages should be clean to be dropped from the page cache.
+    sync();
+
+    return fileSet.mFileCount * fileSet.mFileSize;
+}
+
+void DropPageCache(const std::string& dir)
+{
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+
+        const auto fd = open(entry.path().c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd >= 0) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+}
+
+// Directory walk based on std::filesystem used as the baseline. Paths are compared component by component, so sorted
+// paths are in the WalkFiles order.
+std::vector<fs::path> CollectFiles(const std::string& dir)
+{
+    std::vector<fs::path> files;
+
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry.path());
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+
+    return files;
+}
+
+// HashDir implementation based on std::ifstream and Poco::DigestOutputStream used as the baseline.
+std::string HashDirStream(const std::string& dir)
+{
+    Poco::SHA2Engine h;
+
+    for (const auto& file : CollectFiles(fs::canonical(dir).string())) {
+        std::ifstream            fileStream(file, std::ios::binary);
+        Poco::SHA2Engine         hf;
+        Poco::DigestOutputStream dos(hf);
+
+        Poco::StreamCopier::copyStream(fileStream, dos);
+
+        h.update(Poco::DigestEngine::digestToHex(hf.digest()) + "\n");
+    }
+
+    return "sha256:" + Poco::DigestEngine::digestToHex(h.digest());
+}
+
+void RunHashDir(Runner& runner, const std::string& dir, const FileSet& fileSet)
+{
+    const auto name    = std::string("HashDir/") + fileSet.mName;
+    const auto bytes   = CreateFileSet(dir, fileSet);
+    const auto threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    if (HashDirStream(dir) != HashDir(dir).mValue) {
+        std::fprintf(stderr, "HashDir digest mismatch\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto walkName = std::string("Walk/") + fileSet.mName;
+
+    runner.Run(walkName + "/iterator", bytes, [&dir]() { DoNotOptimize(CollectFiles(dir)); });
+    runner.Run(walkName + "/getdents", bytes, [&dir]() {
+        size_t count = 0;
+
+        WalkFiles(dir, [&count](const WalkEntry&) {
+            count++;
+
+            return aos::ErrorEnum::eNone;
+        });
+
+        DoNotOptimize(count);
+    });
+
+    runner.Run(name + "/stream", bytes, [&dir]() { DoNotOptimize(HashDirStream(dir)); });
+    runner.Run(name + "/read", bytes, [&dir]() { DoNotOptimize(HashDir(dir)); });
+    runner.Run(name + "/read/threads=" + std::to_string(threads), bytes,
+        [&dir, threads]() { DoNotOptimize(HashDir(dir, threads)); });
+
+    // Cold page cache: measures reading from the storage device.
+    runner.Run(name + "/cold/stream", bytes, [&dir]() {
+        DropPageCache(dir);
+        DoNotOptimize(HashDirStream(dir));
+    });
+    runner.Run(name + "/cold/read", bytes, [&dir]() {
+        DropPageCache(dir);
+        DoNotOptimize(HashDir(dir));
+    });
+    runner.Run(name + "/cold/read/threads=" + std::to_string(threads), bytes, [&dir, threads]() {
+        DropPageCache(dir);
+        DoNotOptimize(HashDir(dir, threads));
+    });
+
+    fs::remove_all(dir);
+}
+
+void RunHasher(Runner& runner)
+{
+    std::string data(cHasherDataSize, '\0');
+
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>((i * 2654435761u) >> 13);
+    }
+
+    for (auto algorithm : {HashAlgorithm::eSHA256, HashAlgorithm::eSHA512}) {
+        const auto name = std::string("Hasher/") + GetHashAlgorithmName(algorithm);
+
+        runner.Run(name + "/poco", data.size(), [&data, algorithm]() {
+            Poco::SHA2Engine engine(
+                algorithm == HashAlgorithm::eSHA256 ? Poco::SHA2Engine::SHA_256 : Poco::SHA2Engine::SHA_512);
+
+            engine.update(data);
+            DoNotOptimize(engine.digest());
+        });
+
+        for (auto portable : {true, false}) {
+            Hasher hasher(algorithm, portable);
+
+            // No accelerated kernel for the algorithm on this CPU.
+            if (!portable && std::string(hasher.GetKernelName()) == "portable") {
+                continue;
+            }
+
+            runner.Run(name + "/" + hasher.GetKernelName(), data.size(), [&data, &hasher]() {
+                hasher.Update(data);
+                DoNotOptimize(hasher.Finish());
+            });
+        }
+    }
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+void RunImageBenchmarks(Runner& runner, const std::string& tmpDir)
+{
+    RunHasher(runner);
+
+    for (const auto& fileSet : cFileSets) {
+        RunHashDir(runner, (fs::path(tmpDir) / "hashdir" / fileSet.mName).string(), fileSet);
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cctype>
+#include <filesystem>
+#include <sstream>
+
+#include <Poco/JSON/Object.h>
+
+#include "benchmarks.hpp"
+#include "harness.hpp"
+#include "utils/json.hpp"
+
+using namespace aos::common::benchmark;
+using namespace aos::common::utils;
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+// Representative Aos documents: node config, OCI manifest with image and service config, monitoring data and deeply
+// nested objects.
+const char* const cCorpus[] = {"small_config", "service_manifest", "monitoring", "nested"};
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+Poco::JSON::Object::Ptr Parse(const std::string& json)
+{
+    auto result = ParseJson(json);
+
+    if (!result.mError.IsNone()) {
+        std::fprintf(stderr, "can't parse corpus document\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    return result.mValue.extract<Poco::JSON::Object::Ptr>();
+}
+
+std::string ToUpper(std::string str)
+{
+    for (auto& c : str) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+
+    return str;
+}
+
+void RunParse(Runner& runner, const std::string& name, const std::string& json)
+{
+    runner.Run("ParseJson/string/" + name, json.size(), [&json]() { DoNotOptimize(ParseJson(json)); });
+
+    runner.Run("ParseJson/stream/" + name, json.size(), [&json]() {
+        std::istringstream in(json);
+
+        DoNotOptimize(ParseJson(in));
+    });
+
+    runner.Run("ParseJsonFast/" + name, json.size(), [&json]() { DoNotOptimize(ParseJsonFast(json)); });
+}
+
+void RunWrite(Runner& runner, const std::string& name, const std::string& json, const std::string& dir)
+{
+    const auto object = Parse(json);
+    const auto path   = (std::filesystem::path(dir) / (name + ".json")).string();
+
+    WriteJsonToFile(object, path);
+
+    const auto size = std::filesystem::file_size(path);
+
+    runner.Run("WriteJsonToFile/" + name, size, [&]() { DoNotOptimize(WriteJsonToFile(object, path)); });
+
+    WriteJsonOptions options;
+
+    options.mAtomic = true;
+
+    runner.Run(
+        "WriteJsonToFile/atomic/" + name, size, [&]() { DoNotOptimize(WriteJsonToFile(object, path, options)); });
+}
+
+void RunWrapper(Runner& runner, const std::string& name, const std::string& json)
+{
+    const auto object = Parse(json);
+
+    std::vector<std::string> keys;
+
+    for (const auto& [key, value] : *object) {
+        keys.push_back(ToUpper(key));
+    }
+
+    runner.Run("CaseInsensitiveObjectWrapper/create/" + name, 0,
+        [&object]() { DoNotOptimize(CaseInsensitiveObjectWrapper(object)); });
+
+    const CaseInsensitiveObjectWrapper wrapper(object);
+
+    runner.Run("CaseInsensitiveObjectWrapper/lookup/" + name, 0, [&wrapper, &keys]() {
+        for (const auto& key : keys) {
+            DoNotOptimize(wrapper.Get(key));
+        }
+    });
+}
+
+void RunQueries(Runner& runner, const std::string& corpusDir)
+{
+    const auto nested = Parse(ReadFile(corpusDir + "/nested.json"));
+
+    std::vector<std::string> path;
+
+    for (auto i = 0; i < 200; i++) {
+        path.push_back("level" + std::to_string(i));
+    }
+
+    path.push_back("value");
+
+    runner.Run("FindByPath/nested", 0, [&]() { DoNotOptimize(FindByPath(nested, path)); });
+
+    const auto                         monitoring = Parse(ReadFile(corpusDir + "/monitoring.json"));
+    const CaseInsensitiveObjectWrapper monitoringWrapper(monitoring);
+    const auto                         values = monitoring->getArray("values");
+
+    runner.Run("GetArrayValue/uint64/monitoring", values->size() * sizeof(uint64_t),
+        [&]() { DoNotOptimize(GetArrayValue<uint64_t>(monitoringWrapper, "values")); });
+    runner.Run("GetArrayValue/double/monitoring", values->size() * sizeof(double),
+        [&]() { DoNotOptimize(GetArrayValue<double>(monitoringWrapper, "values")); });
+
+    const CaseInsensitiveObjectWrapper config(Parse(ReadFile(corpusDir + "/small_config.json")));
+
+    runner.Run("GetArrayValue/string/small_config", 0,
+        [&]() { DoNotOptimize(GetArrayValue<std::string>(config, "hostBinds")); });
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+void RunJsonBenchmarks(Runner& runner, const std::string& tmpDir)
+{
+    for (const auto& name : cCorpus) {
+        const auto json = ReadFile(std::string(CORPUS_DIR) + "/" + name + ".json");
+
+        RunParse(runner, name, json);
+        RunWrite(runner, name, json, tmpDir);
+        RunWrapper(runner, name, json);
+    }
+
+    RunQueries(runner, CORPUS_DIR);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+#include "benchmarks.hpp"
+#include "utils/filesystem.hpp"
+
+using namespace aos::common::benchmark;
+using namespace aos::common::utils;
+
+/***********************************************************************************************************************
+ * Main
+ **********************************************************************************************************************/
+
+int main(int argc, char** argv)
+{
+    Runner runner(argc, argv);
+
+    auto [tmpDir, err] = MkTmpDir();
+    if (!err.IsNone()) {
+        std::fprintf(stderr, "can't create temporary directory\n");
+
+        return EXIT_FAILURE;
+    }
+
+    RunJsonBenchmarks(runner, tmpDir);
+    RunImageBenchmarks(runner, tmpDir);
+    RunParserBenchmarks(runner);
+
+    std::filesystem::remove_all(tmpDir);
+
+    return EXIT_SUCCESS;
+}
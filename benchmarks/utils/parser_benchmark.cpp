@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <chrono>
+#include <map>
+#include <regex>
+#include <string>
+
+#include "benchmarks.hpp"
+#include "harness.hpp"
+#include "utils/image.hpp"
+#include "utils/pkcs11helper.hpp"
+#include "utils/time.hpp"
+
+using namespace aos::common::benchmark;
+using namespace aos::common::utils;
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr auto cDigest    = "sha256:e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+constexpr auto cDuration  = "1h20m30s500ms";
+constexpr auto cPKCS11URL = "pkcs11:token=aos;object=diskencryption;id=%2b%3c?"
+                            "module-path=/usr/lib/softhsm/libsofthsm2.so&pin-value=1234";
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+// Former regex based implementations used as the baseline.
+
+bool ValidateDigestRegex(const std::string& digest)
+{
+    static const std::regex encodedRegex(R"(^[a-f0-9]{64}$)");
+
+    const auto pos = digest.find(':');
+
+    return digest.substr(0, pos) == "sha256" && std::regex_match(digest.substr(pos + 1), encodedRegex);
+}
+
+int64_t ParseDurationRegex(const std::string& durationStr)
+{
+    static const std::map<std::string, std::chrono::nanoseconds> units
+        = {{"ns", std::chrono::nanoseconds(1)}, {"us", std::chrono::microseconds(1)},
+            {"µs", std::chrono::microseconds(1)}, {"ms", std::chrono::milliseconds(1)}, {"s", std::chrono::seconds(1)},
+            {"m", std::chrono::minutes(1)}, {"h", std::chrono::hours(1)}, {"d", std::chrono::hours(24)},
+            {"w", std::chrono::hours(24 * 7)}, {"y", std::chrono::hours(24 * 365)}};
+
+    std::chrono::nanoseconds totalDuration {};
+    std::regex               wholeStringPattern(R"((\d+(ns|us|µs|ms|s|m|h|d|w|y))+$)");
+
+    if (!std::regex_match(durationStr, wholeStringPattern)) {
+        return 0;
+    }
+
+    std::regex componentPattern(R"((\d+)(ns|us|µs|ms|s|m|h|d|w|y))");
+
+    for (auto it = std::sregex_iterator(durationStr.begin(), durationStr.end(), componentPattern);
+         it != std::sregex_iterator(); ++it) {
+        totalDuration += units.at((*it)[2].str()) * std::stoll((*it)[1].str());
+    }
+
+    return totalDuration.count();
+}
+
+std::string CreatePKCS11URLRegex(const std::string& url)
+{
+    std::regex objLabelRegex {"object=[^&?;]*[&?;]?"};
+    std::regex modulePathRegex {"module\\-path=[^&?;]*[&?;]?"};
+
+    return std::regex_replace(std::regex_replace(url, objLabelRegex, ""), modulePathRegex, "");
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+void RunParserBenchmarks(Runner& runner)
+{
+    const std::string digest   = cDigest;
+    const std::string duration = cDuration;
+    const std::string url      = cPKCS11URL;
+
+    runner.Run("ValidateDigest/regex", digest.size(), [&digest]() { DoNotOptimize(ValidateDigestRegex(digest)); });
+    runner.Run("ValidateDigest/scanner", digest.size(), [&digest]() { DoNotOptimize(ValidateDigest(digest)); });
+
+    runner.Run(
+        "ParseDuration/regex", duration.size(), [&duration]() { DoNotOptimize(ParseDurationRegex(duration)); });
+    runner.Run("ParseDuration/scanner", duration.size(), [&duration]() { DoNotOptimize(ParseDuration(duration)); });
+
+    runner.Run("CreatePKCS11URL/regex", url.size(), [&url]() { DoNotOptimize(CreatePKCS11URLRegex(url)); });
+    runner.Run("CreatePKCS11URL/scanner", url.size(), [&url]() { DoNotOptimize(CreatePKCS11URL(url.c_str())); });
+}
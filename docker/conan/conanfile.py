@@ -13,6 +13,8 @@ class AosCoreCI(ConanFile):
         self.requires("grpc/1.54.3")
         self.requires("libcurl/8.8.0")
         self.requires("openssl/3.2.1")
+        self.requires("zlib/1.3.1")
+        self.requires("zstd/1.5.5")
 
         if self.options.with_poco :
             self.requires("poco/1.13.2")
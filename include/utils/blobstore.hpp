@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_BLOBSTORE_HPP_
+#define UTILS_BLOBSTORE_HPP_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <aos/common/tools/error.hpp>
+
+#include "utils/image.hpp"
+
+namespace aos::common::utils {
+
+/**
+ * Local content-addressable blob store. Blobs are stored by digest in "<dir>/blobs/<algorithm>/<hex>" and are verified
+ * on insertion, so a stored blob always matches its digest. The total size of blobs is bounded: least recently used
+ * blobs which are not pinned are evicted first, the most recently used blob is never evicted. Blob sizes and usage
+ * order are kept in a compact index file which is loaded on initialization and synced with the stored blobs. Tar index
+ * of a blob archive may be stored next to the blob with cTarIndexSuffix, it is removed with the blob.
+ */
+class BlobStore {
+public:
+    /**
+     * Constructor.
+     */
+    BlobStore() = default;
+
+    BlobStore(const BlobStore&)            = delete;
+    BlobStore& operator=(const BlobStore&) = delete;
+
+    /**
+     * Initializes the store. If the index is missing or corrupted, it is rebuilt from the stored blobs. Entries of
+     * missing blobs are dropped and blobs missing in the index are added as the least recently used.
+     *
+     * @param dir store directory, created if it doesn't exist.
+     * @param maxSize limit of the total size of blobs.
+     * @return Error.
+     */
+    Error Init(const std::string& dir, uint64_t maxSize);
+
+    /**
+     * Adds a copy of the file to the store. The file is hashed while it is copied to a temporary file which is
+     * atomically renamed to the blob path only if the digest matches. Adding a stored blob marks it as recently used,
+     * as Pin does.
+     *
+     * @param digest sha256, sha384 or sha512 digest of the file.
+     * @param path path to the file.
+     * @return Error: eInvalidChecksum if the digest doesn't match.
+     */
+    Error Add(const Digest& digest, const std::string& path);
+
+    /**
+     * Pins the blob, so it is not evicted or removed until it is unpinned. Pins are counted: the blob is unpinned when
+     * Unpin is called for each Pin. The blob is marked as recently used.
+     *
+     * @param digest blob digest.
+     * @return RetWithError<std::string>: path to the blob, eNotFound if the blob is not stored.
+     */
+    RetWithError<std::string> Pin(const Digest& digest);
+
+    /**
+     * Unpins the blob. The store is trimmed to the size limit when the last pin is released.
+     *
+     * @param digest blob digest.
+     * @return Error: eWrongState if the blob is not pinned.
+     */
+    Error Unpin(const Digest& digest);
+
+    /**
+     * Removes the blob.
+     *
+     * @param digest blob digest.
+     * @return Error: eWrongState if the blob is pinned.
+     */
+    Error Remove(const Digest& digest);
+
+    /**
+     * Checks if the blob is stored.
+     *
+     * @param digest blob digest.
+     * @return bool.
+     */
+    bool Contains(const Digest& digest) const;
+
+    /**
+     * Saves the index. Usage order changed by Pin or by adding a stored blob is saved only by this call, other changes
+     * are saved immediately.
+     *
+     * @return Error.
+     */
+    Error Flush();
+
+    /**
+     * Returns total size of stored blobs.
+     *
+     * @return uint64_t.
+     */
+    uint64_t GetSize() const;
+
+private:
+    struct Entry {
+        Digest   mDigest;
+        uint64_t mSize {};
+        size_t   mPins {};
+    };
+
+    std::string GetBlobPath(const Digest& digest) const;
+    Error       LoadIndex();
+    Error       SyncIndex(bool& changed);
+    Error       SaveIndex();
+    void        Insert(const Digest& digest, uint64_t size);
+    Error       RemoveBlob(const Digest& digest) const;
+    Error       Evict();
+
+    mutable std::mutex                                     mMutex;
+    std::string                                            mDir;
+    uint64_t                                               mMaxSize {};
+    uint64_t                                               mSize {};
+    std::list<Entry>                                       mEntries;
+    std::unordered_map<Digest, std::list<Entry>::iterator> mIndex;
+};
+
+} // namespace aos::common::utils
+
+#endif
@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_CBOR_HPP_
+#define UTILS_CBOR_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <Poco/Dynamic/Var.h>
+#include <Poco/JSON/Object.h>
+
+#include <aos/common/tools/error.hpp>
+
+namespace aos::common::utils {
+
+/**
+ * Streaming CBOR (RFC 8949) encoder. Uses the same object model and buffering as JsonWriter: output is accumulated in
+ * a reusable buffer which is either kept as a string or passed to the flush function when it is full. Errors are
+ * sticky.
+ */
+class CborEncoder {
+public:
+    /**
+     * Flush function: receives buffered output.
+     */
+    using FlushFunc = std::function<Error(std::string_view data)>;
+
+    /**
+     * Default buffer size.
+     */
+    static constexpr size_t cDefaultBufferSize = 64 * 1024;
+
+    /**
+     * Size value for containers which size is not known in advance (indefinite length encoding).
+     */
+    static constexpr size_t cIndefinite = std::numeric_limits<size_t>::max();
+
+    /**
+     * Creates encoder which accumulates the whole output in the buffer.
+     *
+     * @param reserve initial buffer capacity.
+     */
+    explicit CborEncoder(size_t reserve = cDefaultBufferSize);
+
+    /**
+     * Creates encoder which passes output to the flush function each time buffer exceeds the buffer size.
+     *
+     * @param flush flush function.
+     * @param bufferSize buffer size.
+     */
+    explicit CborEncoder(FlushFunc flush, size_t bufferSize = cDefaultBufferSize);
+
+    /**
+     * Begins map.
+     *
+     * @param size number of map entries or cIndefinite.
+     * @return CborEncoder&.
+     */
+    CborEncoder& BeginObject(size_t size = cIndefinite);
+
+    /**
+     * Ends map.
+     *
+     * @return CborEncoder&.
+     */
+    CborEncoder& EndObject();
+
+    /**
+     * Begins array.
+     *
+     * @param size number of array items or cIndefinite.
+     * @return CborEncoder&.
+     */
+    CborEncoder& BeginArray(size_t size = cIndefinite);
+
+    /**
+     * Ends array.
+     *
+     * @return CborEncoder&.
+     */
+    CborEncoder& EndArray();
+
+    /**
+     * Writes map key.
+     *
+     * @param key key.
+     * @return CborEncoder&.
+     */
+    CborEncoder& Key(std::string_view key);
+
+    /**
+     * Writes text string value.
+     *
+     * @param value value.
+     * @return CborEncoder&.
+     */
+    CborEncoder& Value(std::string_view value);
+
+    /**
+     * Writes text string value.
+     *
+     * @param value value.
+     * @return CborEncoder&.
+     */
+    CborEncoder& Value(const char* value) { return Value(std::string_view(value)); }
+
+    /**
+     * Writes text string value.
+     *
+     * @param value value.
+     * @return CborEncoder&.
+     */
+    CborEncoder& Value(const std::string& value) { return Value(std::string_view(value)); }
+
+    /**
+     * Writes bool value.
+     *
+     * @param value value.
+     * @return CborEncoder&.
+     */
+    CborEncoder& Value(bool value);
+
+    /**
+     * Writes numeric value. Floating point values are written as single precision if it is exact, otherwise as
+     * double precision.
+     *
+     * @param value value.
+     * @return CborEncoder&.
+     */
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>>
+    CborEncoder& Value(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            return WriteDouble(static_cast<double>(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            return WriteInt(static_cast<int64_t>(value));
+        } else {
+            return WriteUInt(static_cast<uint64_t>(value));
+        }
+    }
+
+    /**
+     * Writes Poco dynamic variable: json objects and arrays are written recursively as definite length maps and
+     * arrays, other values according to their type.
+     *
+     * @param value value.
+     * @return CborEncoder&.
+     */
+    CborEncoder& Value(const Poco::Dynamic::Var& value);
+
+    /**
+     * Writes null value.
+     *
+     * @return CborEncoder&.
+     */
+    CborEncoder& Null();
+
+    /**
+     * Passes buffered output to the flush function. Does nothing for encoder without flush function.
+     *
+     * @return Error.
+     */
+    Error Flush();
+
+    /**
+     * Returns the first error occurred.
+     *
+     * @return Error.
+     */
+    Error GetError() const { return mError; }
+
+    /**
+     * Returns buffered output.
+     *
+     * @return const std::string&.
+     */
+    const std::string& GetString() const { return mBuffer; }
+
+    /**
+     * Moves buffered output out of the encoder.
+     *
+     * @return std::string.
+     */
+    std::string TakeString();
+
+    /**
+     * Resets encoder state keeping the buffer capacity.
+     */
+    void Reset();
+
+private:
+    struct Scope {
+        bool   mObject;
+        size_t mSize;
+        size_t mCount;
+    };
+
+    bool         BeginValue();
+    CborEncoder& BeginContainer(bool object, size_t size);
+    CborEncoder& EndContainer(bool object);
+    CborEncoder& WriteInt(int64_t value);
+    CborEncoder& WriteUInt(uint64_t value);
+    CborEncoder& WriteDouble(double value);
+    void         WriteHead(uint8_t major, uint64_t arg);
+    void         FlushIfFull();
+    void         SetError(const Error& err);
+
+    FlushFunc          mFlush;
+    size_t             mBufferSize;
+    std::string        mBuffer;
+    std::vector<Scope> mScopes;
+    bool               mKeyWritten {};
+    Error              mError;
+};
+
+/**
+ * Streaming CBOR decoder. Decodes a sequence of CBOR data items (RFC 8742) into the same object model as ParseJson:
+ * maps become Poco::JSON::Object::Ptr, arrays Poco::JSON::Array::Ptr, integers Poco::Int64 or Poco::UInt64. Map keys
+ * should be strings. Tags are ignored, byte strings are decoded as strings.
+ */
+class CborDecoder {
+public:
+    /**
+     * Default read buffer size.
+     */
+    static constexpr size_t cDefaultBufferSize = 64 * 1024;
+
+    /**
+     * Max nesting depth.
+     */
+    static constexpr size_t cMaxDepth = 1024;
+
+    /**
+     * Creates decoder from data. The data should outlive the decoder.
+     *
+     * @param data CBOR data.
+     */
+    explicit CborDecoder(std::string_view data);
+
+    /**
+     * Creates decoder from input stream. Data is read in chunks of the buffer size.
+     *
+     * @param in input stream.
+     * @param bufferSize read buffer size.
+     */
+    explicit CborDecoder(std::istream& in, size_t bufferSize = cDefaultBufferSize);
+
+    /**
+     * Decodes next data item.
+     *
+     * @param[out] value decoded value.
+     * @return Error: eNotFound at the end of data, eInvalidArgument on malformed data.
+     */
+    Error Next(Poco::Dynamic::Var& value);
+
+private:
+    Error Decode(Poco::Dynamic::Var& value, size_t depth);
+    Error DecodeHead(uint8_t& major, uint8_t& info, uint64_t& arg);
+    Error DecodeString(uint8_t major, uint8_t info, uint64_t length, std::string& str);
+    Error DecodeObject(uint8_t info, uint64_t size, Poco::Dynamic::Var& value, size_t depth);
+    Error DecodeArray(uint8_t info, uint64_t size, Poco::Dynamic::Var& value, size_t depth);
+    Error DecodeSimple(uint8_t info, uint64_t arg, Poco::Dynamic::Var& value);
+    Error Read(void* data, size_t size);
+    Error Peek(uint8_t& byte);
+    bool  Fill();
+
+    std::istream*    mIn {};
+    std::string      mBuffer;
+    std::string_view mData;
+    size_t           mPos {};
+};
+
+/**
+ * Encodes Poco dynamic variable to CBOR.
+ *
+ * @param value value.
+ * @return RetWithError<std::string>.
+ */
+RetWithError<std::string> EncodeCbor(const Poco::Dynamic::Var& value);
+
+/**
+ * Decodes single CBOR data item.
+ *
+ * @param data CBOR data.
+ * @return RetWithError<Poco::Dynamic::Var>.
+ */
+RetWithError<Poco::Dynamic::Var> DecodeCbor(std::string_view data);
+
+/**
+ * Writes object to file in CBOR format. The file is replaced atomically.
+ *
+ * @param object object.
+ * @param path path to the file.
+ * @param sync flushes file to the storage before return.
+ * @return Error.
+ */
+Error WriteCborToFile(const Poco::JSON::Object::Ptr& object, const std::string& path, bool sync = false);
+
+/**
+ * Reads CBOR file. The file is read into one buffer with ReadFileData and decoded with DecodeCbor.
+ *
+ * @param path path to the file.
+ * @return RetWithError<Poco::Dynamic::Var>.
+ */
+RetWithError<Poco::Dynamic::Var> ParseCborFile(const std::string& path);
+
+} // namespace aos::common::utils
+
+#endif
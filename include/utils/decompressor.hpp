@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_DECOMPRESSOR_HPP_
+#define UTILS_DECOMPRESSOR_HPP_
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <aos/common/tools/error.hpp>
+
+#include "utils/channel.hpp"
+
+namespace aos::common::utils {
+
+/**
+ * Compression type.
+ */
+enum class CompressionType { eNone, eGzip, eBzip2, eXz, eZstd };
+
+/**
+ * Detects compression type by the magic number.
+ *
+ * @param header first bytes of the data.
+ * @return CompressionType.
+ */
+CompressionType DetectCompression(std::string_view header);
+
+/**
+ * Streaming decompressor for gzip and zstd data. Decompression runs on a separate thread, so it is pipelined with the
+ * consumer. Zstd streams of multiple frames with known content size are decompressed in parallel frame by frame.
+ */
+class Decompressor {
+public:
+    /**
+     * Source read function: reads up to size bytes of compressed data to data, returns 0 at the end of data. It is
+     * called on the decompression thread.
+     */
+    using ReadFunc = std::function<RetWithError<size_t>(char* data, size_t size)>;
+
+    /**
+     * Size of the decompressed data chunk.
+     */
+    static constexpr size_t cChunkSize = 1024 * 1024;
+
+    /**
+     * Max content size of zstd frame decompressed in parallel, bigger frames are decompressed as a stream.
+     */
+    static constexpr size_t cMaxParallelFrameSize = 32 * 1024 * 1024;
+
+    /**
+     * Constructor.
+     */
+    Decompressor() = default;
+
+    /**
+     * Destructor.
+     */
+    ~Decompressor();
+
+    Decompressor(const Decompressor&)            = delete;
+    Decompressor& operator=(const Decompressor&) = delete;
+
+    /**
+     * Starts decompression.
+     *
+     * @param type compression type, only gzip and zstd are supported.
+     * @param source source read function.
+     * @param threads max number of zstd frames decompressed in parallel, 0 uses the number of CPUs.
+     * @return Error.
+     */
+    Error Open(CompressionType type, ReadFunc source, size_t threads = 0);
+
+    /**
+     * Reads decompressed data.
+     *
+     * @param data buffer.
+     * @param size buffer size.
+     * @return RetWithError<size_t>: number of bytes read, 0 at the end of data.
+     */
+    RetWithError<size_t> Read(char* data, size_t size);
+
+    /**
+     * Stops decompression. The source is not read after close.
+     */
+    void Close();
+
+private:
+    struct Chunk {
+        std::string mData;
+        Error       mError;
+    };
+
+    using ChunkFuture = std::shared_future<Chunk>;
+
+    void DecompressGzip();
+    void DecompressZstd();
+    bool Send(Chunk chunk);
+    bool SendEnd(const Error& err = ErrorEnum::eNone);
+
+    ReadFunc                              mSource;
+    size_t                                mThreads {};
+    std::thread                           mThread;
+    std::unique_ptr<Channel<ChunkFuture>> mChunks;
+    Chunk                                 mCurrent;
+    size_t                                mOffset {};
+    bool                                  mEnded {};
+};
+
+} // namespace aos::common::utils
+
+#endif
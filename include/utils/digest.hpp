@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_DIGEST_HPP_
+#define UTILS_DIGEST_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <aos/common/tools/error.hpp>
+
+namespace aos::common::utils {
+
+/**
+ * Hash algorithm.
+ */
+enum class HashAlgorithm { eSHA256, eSHA384, eSHA512 };
+
+/**
+ * Returns hash algorithm by its OCI digest name: sha256, sha384 or sha512.
+ *
+ * @param name algorithm name.
+ * @return RetWithError<HashAlgorithm>: eNotSupported for unknown algorithm.
+ */
+RetWithError<HashAlgorithm> ParseHashAlgorithm(std::string_view name);
+
+/**
+ * Returns OCI digest name of the hash algorithm.
+ *
+ * @param algorithm hash algorithm.
+ * @return const char*.
+ */
+const char* GetHashAlgorithmName(HashAlgorithm algorithm);
+
+/**
+ * SHA-2 hasher. Compression kernel is selected at runtime: SHA extensions on x86 and cryptography extensions on ARMv8
+ * are used if the CPU supports them, otherwise the portable implementation is used.
+ */
+class Hasher {
+public:
+    /**
+     * Max digest size in bytes.
+     */
+    static constexpr size_t cMaxDigestSize = 64;
+
+    /**
+     * Constructor.
+     *
+     * @param algorithm hash algorithm.
+     * @param portable uses the portable kernel regardless of the CPU features.
+     */
+    explicit Hasher(HashAlgorithm algorithm = HashAlgorithm::eSHA256, bool portable = false);
+
+    /**
+     * Hashes data.
+     *
+     * @param data data.
+     * @param size data size.
+     */
+    void Update(const void* data, size_t size);
+
+    /**
+     * Hashes data.
+     *
+     * @param data data.
+     */
+    void Update(std::string_view data) { Update(data.data(), data.size()); }
+
+    /**
+     * Returns hex encoded digest of the hashed data and resets the hasher.
+     *
+     * @return std::string.
+     */
+    std::string Finish();
+
+    /**
+     * Returns hash algorithm.
+     *
+     * @return HashAlgorithm.
+     */
+    HashAlgorithm GetAlgorithm() const { return mAlgorithm; }
+
+    /**
+     * Returns name of the compression kernel: "sha-ni", "armv8-ce" or "portable".
+     *
+     * @return const char*.
+     */
+    const char* GetKernelName() const { return mKernelName; }
+
+private:
+    using Compress = void (*)(void* state, const uint8_t* blocks, size_t count);
+
+    void Reset();
+
+    HashAlgorithm mAlgorithm;
+    Compress      mCompress {};
+    const char*   mKernelName {};
+    size_t        mBlockSize {};
+    uint64_t      mLength {};
+    size_t        mBuffered {};
+    uint8_t       mBuffer[128] {};
+
+    union {
+        uint32_t m256[8];
+        uint64_t m512[8];
+    } mState {};
+};
+
+} // namespace aos::common::utils
+
+#endif
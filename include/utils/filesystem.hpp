@@ -8,7 +8,11 @@
 #ifndef UTILS_FILESYSTEM_HPP
 #define UTILS_FILESYSTEM_HPP
 
+#include <functional>
 #include <string>
+#include <string_view>
+
+#include <sys/types.h>
 
 #include <aos/common/tools/error.hpp>
 
@@ -30,6 +34,187 @@ namespace aos::common::utils {
  */
 RetWithError<std::string> MkTmpDir(const std::string& dir = "", const std::string& pattern = "");
 
+/**
+ * File data copy method.
+ */
+enum class CopyMethod { eClone, eCopyRange, eReadWrite };
+
+/**
+ * Copies file data to an empty file. The data is shared with FICLONE reflink if the filesystem supports it, otherwise
+ * it is copied in the kernel by copy_file_range or, as the last resort, by read and write. File offsets are not used
+ * and not changed.
+ *
+ * @param inFD source file descriptor.
+ * @param outFD destination file descriptor opened for writing.
+ * @return RetWithError<CopyMethod>: method used to copy the data.
+ */
+RetWithError<CopyMethod> CopyFileData(int inFD, int outFD);
+
+/**
+ * Reads the whole file into memory. The buffer is allocated once by the size reported by fstat, files which report
+ * zero size, such as procfs and sysfs files, or grow while being read are read up to the end of file. Unlike
+ * MappedFile, a file truncated concurrently by another writer gives short data instead of SIGBUS.
+ *
+ * @param path file path.
+ * @return RetWithError<std::string>: file data, eNotFound if file doesn't exist.
+ */
+RetWithError<std::string> ReadFileData(const std::string& path);
+
+/**
+ * Regular file found by WalkFiles.
+ */
+struct WalkEntry {
+    /**
+     * Path relative to the walked directory.
+     */
+    const std::string& mPath;
+
+    /**
+     * Descriptor of the parent directory, valid only during the handler call.
+     */
+    int mDirFD;
+
+    /**
+     * File name in the parent directory.
+     */
+    const char* mName;
+};
+
+/**
+ * Walk handler: called for each regular file, the walk is stopped if an error is returned.
+ */
+using WalkHandler = std::function<Error(const WalkEntry& entry)>;
+
+/**
+ * Walks the directory tree and passes regular files and symlinks to regular files to the handler. Directories are read
+ * with getdents64 relative to the parent directory descriptor, entry type is taken from d_type, so only symlinks and
+ * entries of filesystems without d_type support are stat'ed. Entries of each directory are visited sorted by name,
+ * subdirectories are visited in place, symlinks to directories are not followed.
+ *
+ * @param dir directory path.
+ * @param handler walk handler.
+ * @return Error.
+ */
+Error WalkFiles(const std::string& dir, const WalkHandler& handler);
+
+/**
+ * Read-only memory mapped file.
+ */
+class MappedFile {
+public:
+    /**
+     * Constructor.
+     */
+    MappedFile() = default;
+
+    /**
+     * Destructor.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Maps file into memory.
+     *
+     * @param path file path.
+     * @param sequential hints the kernel that the mapping will be read sequentially.
+     * @return Error.
+     */
+    Error Open(const std::string& path, bool sequential = false);
+
+    /**
+     * Unmaps file.
+     */
+    void Close();
+
+    /**
+     * Returns pointer to the mapped data.
+     *
+     * @return const char*.
+     */
+    const char* Data() const { return mData; }
+
+    /**
+     * Returns size of the mapped data.
+     *
+     * @return size_t.
+     */
+    size_t Size() const { return mSize; }
+
+    /**
+     * Returns view of the mapped data.
+     *
+     * @return std::string_view.
+     */
+    std::string_view View() const { return {mData, mSize}; }
+
+private:
+    const char* mData {};
+    size_t      mSize {};
+};
+
+/**
+ * File which replaces the target path atomically on commit. Data is written to an unnamed O_TMPFILE file or, if the
+ * filesystem doesn't support it, to a temporary file next to the target. The target is never observed half-written.
+ * Symlinks are resolved, so the file they point to is replaced. Hard links of the target are not kept: other names
+ * keep referring to the old data.
+ */
+class AtomicFile {
+public:
+    /**
+     * Constructor.
+     */
+    AtomicFile() = default;
+
+    /**
+     * Destructor. Discards uncommitted data.
+     */
+    ~AtomicFile();
+
+    AtomicFile(const AtomicFile&)            = delete;
+    AtomicFile& operator=(const AtomicFile&) = delete;
+
+    /**
+     * Creates temporary file for the target path. If the target exists, its permissions and, if the process is
+     * allowed to set them, owner and group are preserved. Otherwise the file is created with the mode masked by umask.
+     *
+     * @param path target path.
+     * @param mode permissions of the new file.
+     * @return Error.
+     */
+    Error Open(const std::string& path, mode_t mode = 0666);
+
+    /**
+     * Writes data to the temporary file.
+     *
+     * @param data data.
+     * @return Error.
+     */
+    Error Write(std::string_view data);
+
+    /**
+     * Replaces the target with the temporary file.
+     *
+     * @param sync flushes file data and parent directory to the storage before return.
+     * @return Error.
+     */
+    Error Commit(bool sync = false);
+
+    /**
+     * Discards temporary file.
+     */
+    void Abort();
+
+private:
+    Error Link();
+
+    int         mFD {-1};
+    std::string mPath;
+    std::string mTmpPath;
+};
+
 } // namespace aos::common::utils
 
 #endif // UTILS_FILESYSTEM_HPP
@@ -17,7 +17,8 @@ namespace aos::common::utils {
 using Digest = std::string;
 
 /**
- * Unpacks an image archive.
+ * Unpacks an image archive. Uncompressed, gzip and zstd archives are extracted in-process by the streaming tar
+ * extractor, bzip2 and xz archives are unpacked by external tar.
  *
  * @param archivePath path to the archive.
  * @param destination path to the destination directory.
@@ -25,6 +26,18 @@ using Digest = std::string;
  */
 Error UnpackTarImage(const std::string& archivePath, const std::string& destination);
 
+/**
+ * Unpacks an image archive verifying its digest. Uncompressed, gzip and zstd archives are hashed while they are
+ * extracted to a staging directory next to the destination, bzip2 and xz archives are hashed before extraction. The
+ * staging directory is renamed to the destination only if the digest matches, otherwise it is removed.
+ *
+ * @param archivePath path to the archive.
+ * @param destination path to the destination directory, it should not exist or be empty.
+ * @param digest expected sha256, sha384 or sha512 digest of the archive.
+ * @return aos::Error: eInvalidChecksum if the digest doesn't match.
+ */
+Error UnpackVerifiedTarImage(const std::string& archivePath, const std::string& destination, const Digest& digest);
+
 /**
  * Parses the digest string.
  *
@@ -41,12 +54,94 @@ std::pair<std::string, std::string> ParseDigest(const std::string& digest);
 Error ValidateDigest(const Digest& digest);
 
 /**
- * Hashes the directory.
+ * HashDir options.
+ */
+struct HashDirOptions {
+    /**
+     * Number of worker threads, 0 hashes files on the calling thread.
+     */
+    size_t mThreads {};
+
+    /**
+     * Path to the persistent hash cache which maps file path relative to the directory to its inode, size,
+     * modification and status change times and hash. Only files which metadata changed are rehashed. The cache should
+     * be outside the hashed directory. Empty path disables the cache.
+     */
+    std::string mCachePath;
+
+    /**
+     * Ignores cached hashes: all files are rehashed and the cache is rewritten.
+     */
+    bool mStrict {};
+
+    /**
+     * Path to the Merkle tree sidecar. If set, chunk hashes of files are computed too and the MerkleTree of the
+     * directory is saved to the sidecar, so single files and subtrees can be verified later. With the hash cache, chunk
+     * hashes of unchanged files are taken from the existing sidecar. The flat digest is returned as without the tree.
+     */
+    std::string mMerklePath;
+};
+
+/**
+ * Hashes the directory: the digest is sha256 of hashes of regular files taken in WalkFiles order, so it doesn't depend
+ * on the order of directory entries on the filesystem. Files are hashed while the directory is walked. If threads is
+ * not zero, files are hashed on the worker pool, the digest is the same as for sequential hashing.
+ *
+ * @param dir directory path.
+ * @param threads number of worker threads, 0 hashes files on the calling thread.
+ * @return std::string.
+ */
+RetWithError<std::string> HashDir(const std::string& dir, size_t threads = 0);
+
+/**
+ * Hashes the directory with options.
  *
  * @param dir directory path.
+ * @param options options.
+ * @return std::string: digest, it is set also if the error is returned because the hash cache or the Merkle tree can't
+ * be saved.
+ */
+RetWithError<std::string> HashDir(const std::string& dir, const HashDirOptions& options);
+
+/**
+ * Installs a layer archive in a single pass: entries are hashed while they are extracted, so the HashDir compatible
+ * digest of the result is computed without reading extracted files back. The archive is extracted to a staging
+ * directory next to the destination which is renamed to the destination only if the digests match. Bzip2 and xz
+ * archives are unpacked by external tar and hashed after extraction.
+ *
+ * @param archivePath path to the archive.
+ * @param destination path to the destination directory, it should not exist or be empty.
+ * @param dirDigest expected sha256 HashDir digest of the extracted layer, empty digest is not checked.
+ * @param archiveDigest expected sha256, sha384 or sha512 digest of the archive file, empty digest is not checked.
+ * @return RetWithError<std::string>: HashDir digest of the extracted layer, eInvalidChecksum if a digest doesn't
+ * match.
+ */
+RetWithError<std::string> InstallLayer(const std::string& archivePath, const std::string& destination,
+    const Digest& dirDigest, const Digest& archiveDigest = "");
+
+/**
+ * Returns path of the layer in a content-addressed layer store: the layer with HashDir digest "<algorithm>:<hex>" is
+ * stored in "<store>/<algorithm>/<hex>". Layers are added to the store by InstallLayer to this path.
+ *
+ * @param store layer store directory.
+ * @param dirDigest HashDir digest of the layer.
  * @return std::string.
  */
-RetWithError<std::string> HashDir(const std::string& dir);
+std::string GetLayerPath(const std::string& store, const Digest& dirDigest);
+
+/**
+ * Materializes a layer from a content-addressed layer store. Regular files share data with the stored layer through
+ * FICLONE reflinks if the filesystem supports them, otherwise they are copied in the kernel by copy_file_range or by
+ * read and write. Directories, symlinks, hard links, special files, permissions, modification times and, if running as
+ * root, ownership are preserved. The layer is copied to a staging directory next to the destination which is renamed
+ * to the destination on success.
+ *
+ * @param store layer store directory.
+ * @param dirDigest HashDir digest of the layer.
+ * @param destination path to the destination directory, it should not exist or be empty.
+ * @return Error: eNotFound if the layer is not in the store.
+ */
+Error MaterializeLayer(const std::string& store, const Digest& dirDigest, const std::string& destination);
 
 } // namespace aos::common::utils
 
@@ -9,12 +9,18 @@
 #define UTILS_JSON_HPP_
 
 #include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include <Poco/Dynamic/Var.h>
+#include <Poco/Exception.h>
 #include <Poco/JSON/JSONException.h>
 #include <Poco/JSON/Object.h>
 #include <Poco/JSON/Parser.h>
@@ -38,14 +44,60 @@ aos::RetWithError<Poco::Dynamic::Var> ParseJson(const std::string& json) noexcep
  */
 aos::RetWithError<Poco::Dynamic::Var> ParseJson(std::istream& in) noexcept;
 
+/**
+ * Parses json string using in-tree SIMD structural scanner. Produces the same object model as ParseJson. Unlike
+ * ParseJson, input is required to be valid UTF-8.
+ *
+ * @param json json string.
+ * @return aos::RetWithError<Poco::Dynamic::Var> .
+ */
+aos::RetWithError<Poco::Dynamic::Var> ParseJsonFast(std::string_view json) noexcept;
+
+/**
+ * Parses json string using in-tree SIMD structural scanner reusing the structural index buffer between calls.
+ *
+ * @param json json string.
+ * @param index structural index buffer.
+ * @return aos::RetWithError<Poco::Dynamic::Var> .
+ */
+aos::RetWithError<Poco::Dynamic::Var> ParseJsonFast(std::string_view json, std::vector<uint32_t>& index) noexcept;
+
+/**
+ * Parses json file. The file is read into one buffer with ReadFileData and parsed with ParseJsonFast.
+ *
+ * @param path path to the file.
+ * @return aos::RetWithError<Poco::Dynamic::Var> .
+ */
+aos::RetWithError<Poco::Dynamic::Var> ParseJsonFile(const std::string& path) noexcept;
+
+/**
+ * Json file write options.
+ */
+struct WriteJsonOptions {
+    /**
+     * Default write buffer size.
+     */
+    static constexpr size_t cDefaultBufferSize = 1024 * 1024;
+
+    // Write to a temporary file which atomically replaces the target, otherwise truncate the target in place. Atomic
+    // mode needs a writable parent directory, gives the target a new inode and can't replace a bind-mounted file.
+    bool mAtomic {};
+    // Flush file data (and directory entry in atomic mode) to the storage with fdatasync before return.
+    bool mSync {};
+    // Output is written in chunks of this size.
+    size_t mBufferSize {cDefaultBufferSize};
+};
+
 /**
  * Writes json to file.
  *
  * @param json json object.
  * @param path path to the file.
+ * @param options write options.
  * @return aos::Error.
  */
-Error WriteJsonToFile(const Poco::JSON::Object::Ptr& json, const std::string& path);
+Error WriteJsonToFile(
+    const Poco::JSON::Object::Ptr& json, const std::string& path, const WriteJsonOptions& options = {});
 
 /**
  * Finds value of the json by path
@@ -56,6 +108,211 @@ Error WriteJsonToFile(const Poco::JSON::Object::Ptr& json, const std::string& pa
  */
 Poco::Dynamic::Var FindByPath(const Poco::Dynamic::Var object, const std::vector<std::string>& path);
 
+/**
+ * Compiled json path.
+ *
+ * Path string consists of segments separated by dots. Each segment is either an object key, a quoted object key
+ * in brackets (["aos.key"]), an array index in brackets ([2]) or a wildcard (* or [*]) that matches all object
+ * values or array items, e.g. "services[*].layers[0].digest".
+ */
+class JsonPath {
+public:
+    /**
+     * Path segment.
+     */
+    struct Segment {
+        /**
+         * Segment type.
+         */
+        enum class Type {
+            eKey,
+            eIndex,
+            eWildcard,
+        };
+
+        Type        mType {Type::eKey};
+        std::string mKey;
+        size_t      mIndex {};
+    };
+
+    /**
+     * Creates empty path that matches the root value.
+     */
+    JsonPath() = default;
+
+    /**
+     * Creates path from the list of object keys.
+     *
+     * @param keys object keys.
+     */
+    explicit JsonPath(const std::vector<std::string>& keys);
+
+    /**
+     * Compiles path string.
+     *
+     * @param path path string.
+     * @return RetWithError<JsonPath>.
+     */
+    static RetWithError<JsonPath> Compile(const std::string& path);
+
+    /**
+     * Returns path segments.
+     *
+     * @return const std::vector<Segment>&.
+     */
+    const std::vector<Segment>& GetSegments() const { return mSegments; }
+
+    /**
+     * Checks if path contains wildcard segments.
+     *
+     * @return bool.
+     */
+    bool HasWildcard() const { return mHasWildcard; }
+
+    /**
+     * Finds value by path. If path contains wildcards, all matched values are returned as Poco::JSON::Array::Ptr:
+     * array items in index order, object values in the object iteration order, which is sorted by key.
+     *
+     * @param object json object.
+     * @return Poco::Dynamic::Var.
+     */
+    Poco::Dynamic::Var Find(const Poco::Dynamic::Var& object) const;
+
+private:
+    void AddSegment(Segment segment);
+
+    std::vector<Segment> mSegments;
+    bool                 mHasWildcard {};
+};
+
+/**
+ * Extracts values of multiple compiled paths in a single traversal of the json document.
+ */
+class JsonPathExtractor {
+public:
+    /**
+     * Adds path to extract.
+     *
+     * @param path compiled path.
+     * @return size_t index of the path value in the extraction result.
+     */
+    size_t Add(const JsonPath& path);
+
+    /**
+     * Extracts values of all added paths. Value of a path without wildcards is empty if the path is not found, value
+     * of a path with wildcards is Poco::JSON::Array::Ptr with all matched values in the order of JsonPath::Find.
+     *
+     * @param object json object.
+     * @return std::vector<Poco::Dynamic::Var>.
+     */
+    std::vector<Poco::Dynamic::Var> Extract(const Poco::Dynamic::Var& object) const;
+
+private:
+    static constexpr size_t cNoNode = static_cast<size_t>(-1);
+
+    struct Node {
+        std::unordered_map<std::string, size_t> mKeys;
+        std::vector<std::pair<size_t, size_t>>  mIndices;
+        size_t                                  mWildcard {cNoNode};
+        std::vector<size_t>                     mPaths;
+    };
+
+    size_t AddChild(size_t parent, const JsonPath::Segment& segment);
+    void   Visit(size_t node, const Poco::Dynamic::Var& value, std::vector<Poco::Dynamic::Var>& result) const;
+
+    std::vector<Node> mNodes {Node {}};
+    std::vector<bool> mWildcardPaths;
+};
+
+/**
+ * Casts number to arithmetic type. Throws Poco::RangeException if number doesn't fit the type as
+ * Poco::Dynamic::Var::convert does.
+ *
+ * @param value number.
+ * @return T.
+ */
+template <typename T, typename S>
+T CastNumber(S value)
+{
+    if constexpr (std::is_integral_v<T> && std::is_floating_point_v<S>) {
+        // Upper bound is max + 1 which is exactly representable as power of two.
+        if (!(value >= static_cast<S>(std::numeric_limits<T>::min())
+                && value < static_cast<S>(std::numeric_limits<T>::max() / 2 + 1) * 2)) {
+            throw Poco::RangeException("Value out of range");
+        }
+    } else if constexpr (std::is_floating_point_v<T> && std::is_floating_point_v<S> && sizeof(T) < sizeof(S)) {
+        // Narrowing is undefined out of the type range, NaN is passed as convert does.
+        if (value < -static_cast<S>(std::numeric_limits<T>::max())
+            || value > static_cast<S>(std::numeric_limits<T>::max())) {
+            throw Poco::RangeException("Value out of range");
+        }
+    } else if constexpr (std::is_integral_v<T>) {
+        if constexpr (std::is_signed_v<S>) {
+            if (value < 0) {
+                if constexpr (std::is_signed_v<T>) {
+                    if (static_cast<int64_t>(value) < static_cast<int64_t>(std::numeric_limits<T>::min())) {
+                        throw Poco::RangeException("Value out of range");
+                    }
+                } else {
+                    throw Poco::RangeException("Value out of range");
+                }
+
+                return static_cast<T>(value);
+            }
+        }
+
+        if (static_cast<uint64_t>(value) > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+            throw Poco::RangeException("Value out of range");
+        }
+    }
+
+    return static_cast<T>(value);
+}
+
+/**
+ * Converts Poco dynamic variable to the specified type. For arithmetic types, numbers held as 64-bit integers, int
+ * or double are cast directly and numeric strings are parsed with std::from_chars, other values are converted with
+ * Poco::Dynamic::Var::convert.
+ *
+ * @param value value.
+ * @return T.
+ */
+template <typename T>
+T ConvertValue(const Poco::Dynamic::Var& value)
+{
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+        const auto& type = value.type();
+
+        if (type == typeid(Poco::Int64)) {
+            return CastNumber<T>(value.extract<Poco::Int64>());
+        }
+
+        if (type == typeid(Poco::UInt64)) {
+            return CastNumber<T>(value.extract<Poco::UInt64>());
+        }
+
+        if (type == typeid(double)) {
+            return CastNumber<T>(value.extract<double>());
+        }
+
+        if (type == typeid(int)) {
+            return CastNumber<T>(value.extract<int>());
+        }
+
+        if (type == typeid(std::string)) {
+            const auto& str    = value.extract<std::string>();
+            T           result = 0;
+            const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
+
+            if (ec == std::errc() && ptr == str.data() + str.size()) {
+                return result;
+            }
+        }
+    }
+
+    return value.convert<T>();
+}
+
 /**
  * Wrapper for Poco::JSON::Object::Ptr with case-insensitive keys.
  */
@@ -102,7 +359,7 @@ public:
     T GetValue(const std::string& key, const T& defaultValue = T {}) const
     {
         if (Has(key)) {
-            return Get(key).convert<T>();
+            return ConvertValue<T>(Get(key));
         }
 
         return defaultValue;
@@ -118,7 +375,7 @@ public:
     std::optional<T> GetOptionalValue(const std::string& key) const
     {
         if (Has(key)) {
-            return Get(key).convert<T>();
+            return ConvertValue<T>(Get(key));
         }
 
         return std::nullopt;
@@ -173,6 +430,8 @@ std::vector<T> GetArrayValue(const CaseInsensitiveObjectWrapper& object, const s
 
     Poco::JSON::Array::Ptr array = object.GetArray(key);
 
+    result.reserve(array->size());
+
     std::transform(array->begin(), array->end(), std::back_inserter(result), parserFunc);
 
     return result;
@@ -188,7 +447,7 @@ std::vector<T> GetArrayValue(const CaseInsensitiveObjectWrapper& object, const s
 template <typename T>
 std::vector<T> GetArrayValue(const CaseInsensitiveObjectWrapper& object, const std::string& key)
 {
-    return GetArrayValue<T>(object, key, [](const Poco::Dynamic::Var& value) { return value.convert<T>(); });
+    return GetArrayValue<T>(object, key, [](const Poco::Dynamic::Var& value) { return ConvertValue<T>(value); });
 }
 
 } // namespace aos::common::utils
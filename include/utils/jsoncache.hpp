@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_JSONCACHE_HPP_
+#define UTILS_JSONCACHE_HPP_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <Poco/Dynamic/Var.h>
+
+#include <aos/common/tools/error.hpp>
+
+namespace aos::common::utils {
+
+/**
+ * Cache of parsed json files. A cached document is returned while the file device, inode, size and modification time
+ * are unchanged. Files modified within cRacyInterval before parsing are not cached: a rewrite of the same size within
+ * one timestamp tick can't be detected. Memory is bounded by the estimated size of cached documents: least recently
+ * used documents are evicted first. The cached document is shared by all callers without copying, so it must not be
+ * modified: a caller which needs to change it should make its own copy.
+ */
+class JsonFileCache {
+public:
+    /**
+     * Default limit of the estimated size of cached documents.
+     */
+    static constexpr size_t cDefaultMaxSize = 16 * 1024 * 1024;
+
+    /**
+     * Returns process-wide cache instance.
+     *
+     * @return JsonFileCache&.
+     */
+    static JsonFileCache& Get();
+
+    /**
+     * Constructor.
+     *
+     * @param maxSize limit of the estimated size of cached documents.
+     */
+    explicit JsonFileCache(size_t maxSize = cDefaultMaxSize);
+
+    JsonFileCache(const JsonFileCache&)            = delete;
+    JsonFileCache& operator=(const JsonFileCache&) = delete;
+
+    /**
+     * Returns parsed json file. The file is parsed with ParseJsonFile if it is not cached or has been changed,
+     * otherwise the cached document is returned without reading the file. The returned document must not be modified.
+     *
+     * @param path path to the file.
+     * @return RetWithError<Poco::Dynamic::Var>.
+     */
+    RetWithError<Poco::Dynamic::Var> ParseFile(const std::string& path);
+
+    /**
+     * Removes file from the cache.
+     *
+     * @param path path to the file.
+     */
+    void Invalidate(const std::string& path);
+
+    /**
+     * Removes all files from the cache.
+     */
+    void Clear();
+
+    /**
+     * Sets limit of the estimated size of cached documents. Evicts documents if the limit is exceeded.
+     *
+     * @param maxSize limit of the estimated size of cached documents.
+     */
+    void SetMaxSize(size_t maxSize);
+
+    /**
+     * Returns estimated size of cached documents.
+     *
+     * @return size_t.
+     */
+    size_t GetSize() const;
+
+private:
+    struct FileID {
+        uint64_t mDevice {};
+        uint64_t mInode {};
+        uint64_t mSize {};
+        int64_t  mModTime {};
+
+        bool operator==(const FileID& other) const
+        {
+            return mDevice == other.mDevice && mInode == other.mInode && mSize == other.mSize
+                && mModTime == other.mModTime;
+        }
+    };
+
+    struct Entry {
+        std::string        mPath;
+        FileID             mID;
+        size_t             mSize {};
+        Poco::Dynamic::Var mDocument;
+    };
+
+    static Error GetFileID(const std::string& path, FileID& id);
+
+    void Remove(std::list<Entry>::iterator it);
+    void Evict();
+
+    mutable std::mutex                                          mMutex;
+    size_t                                                      mMaxSize;
+    size_t                                                      mSize {};
+    std::list<Entry>                                            mEntries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> mIndex;
+};
+
+} // namespace aos::common::utils
+
+#endif
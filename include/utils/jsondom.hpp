@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_JSONDOM_HPP_
+#define UTILS_JSONDOM_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <Poco/Exception.h>
+
+#include <aos/common/tools/error.hpp>
+
+namespace aos::common::utils {
+
+class JsonDocument;
+struct JsonMember;
+
+/**
+ * Read-only range of json DOM nodes.
+ *
+ * @tparam T node type.
+ */
+template <typename T>
+class JsonRange {
+public:
+    /**
+     * Constructor.
+     *
+     * @param begin first node.
+     * @param size number of nodes.
+     */
+    JsonRange(const T* begin = nullptr, size_t size = 0)
+        : mBegin(begin)
+        , mSize(size)
+    {
+    }
+
+    /**
+     * Returns iterator to the first node.
+     *
+     * @return const T*.
+     */
+    const T* begin() const { return mBegin; }
+
+    /**
+     * Returns iterator past the last node.
+     *
+     * @return const T*.
+     */
+    const T* end() const { return mBegin + mSize; }
+
+    /**
+     * Returns number of nodes.
+     *
+     * @return size_t.
+     */
+    size_t Size() const { return mSize; }
+
+    /**
+     * Returns node by index.
+     *
+     * @param index node index.
+     * @return const T&.
+     */
+    const T& operator[](size_t index) const { return mBegin[index]; }
+
+private:
+    const T* mBegin;
+    size_t   mSize;
+};
+
+/**
+ * Json DOM value. Values are allocated in JsonDocument arena and stay valid while the document exists.
+ */
+class JsonValue {
+public:
+    /**
+     * Value type.
+     */
+    enum class Type {
+        eNull,
+        eBool,
+        eInt,
+        eUInt,
+        eDouble,
+        eString,
+        eArray,
+        eObject,
+    };
+
+    /**
+     * Returns value type.
+     *
+     * @return Type.
+     */
+    Type GetType() const { return mType; }
+
+    /**
+     * Checks if value is null.
+     *
+     * @return bool.
+     */
+    bool IsNull() const { return mType == Type::eNull; }
+
+    /**
+     * Checks if value is string.
+     *
+     * @return bool.
+     */
+    bool IsString() const { return mType == Type::eString; }
+
+    /**
+     * Checks if value is array.
+     *
+     * @return bool.
+     */
+    bool IsArray() const { return mType == Type::eArray; }
+
+    /**
+     * Checks if value is object.
+     *
+     * @return bool.
+     */
+    bool IsObject() const { return mType == Type::eObject; }
+
+    /**
+     * Checks if value is number.
+     *
+     * @return bool.
+     */
+    bool IsNumber() const { return mType == Type::eInt || mType == Type::eUInt || mType == Type::eDouble; }
+
+    /**
+     * Returns string value. Throws Poco::BadCastException if value is not string.
+     *
+     * @return std::string_view.
+     */
+    std::string_view GetString() const;
+
+    /**
+     * Returns array items. Throws Poco::BadCastException if value is not array.
+     *
+     * @return JsonRange<JsonValue>.
+     */
+    JsonRange<JsonValue> GetItems() const;
+
+    /**
+     * Returns object members in document order. Throws Poco::BadCastException if value is not object.
+     *
+     * @return JsonRange<JsonMember>.
+     */
+    JsonRange<JsonMember> GetMembers() const;
+
+    /**
+     * Converts value to the specified type. Supported types are bool, arithmetic types, std::string and
+     * std::string_view. Throws Poco::BadCastException if value can't be converted and Poco::RangeException if
+     * number doesn't fit the type.
+     *
+     * @return T.
+     */
+    template <typename T>
+    T As() const
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            if (mType != Type::eBool) {
+                throw Poco::BadCastException("json value is not bool");
+            }
+
+            return mBool;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return NumberAs<T>();
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            return GetString();
+        } else {
+            static_assert(std::is_same_v<T, std::string>, "unsupported json value type");
+
+            return std::string(GetString());
+        }
+    }
+
+private:
+    friend class JsonDocument;
+
+    template <typename T>
+    T NumberAs() const
+    {
+        switch (mType) {
+        case Type::eBool:
+            return static_cast<T>(mBool);
+
+        case Type::eInt:
+            if constexpr (std::is_integral_v<T>) {
+                if (mInt < 0 ? !std::is_signed_v<T> || mInt < static_cast<int64_t>(std::numeric_limits<T>::min())
+                             : static_cast<uint64_t>(mInt) > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+                    throw Poco::RangeException("json value is out of range");
+                }
+            }
+
+            return static_cast<T>(mInt);
+
+        case Type::eUInt:
+            if constexpr (std::is_integral_v<T>) {
+                if (mUInt > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+                    throw Poco::RangeException("json value is out of range");
+                }
+            }
+
+            return static_cast<T>(mUInt);
+
+        case Type::eDouble:
+            if constexpr (std::is_integral_v<T>) {
+                // Upper bound is max + 1 which is exactly representable as power of two, max itself rounds up to it.
+                if (!(mDouble >= static_cast<double>(std::numeric_limits<T>::min())
+                        && mDouble < static_cast<double>(std::numeric_limits<T>::max() / 2 + 1) * 2)) {
+                    throw Poco::RangeException("json value is out of range");
+                }
+            }
+
+            return static_cast<T>(mDouble);
+
+        default:
+            throw Poco::BadCastException("json value is not number");
+        }
+    }
+
+    Type     mType {Type::eNull};
+    uint32_t mSize {};
+    union {
+        bool              mBool;
+        int64_t           mInt {};
+        uint64_t          mUInt;
+        double            mDouble;
+        const char*       mString;
+        const JsonValue*  mItems;
+        const JsonMember* mMembers;
+    };
+};
+
+/**
+ * Json DOM object member.
+ */
+struct JsonMember {
+    std::string_view mKey;
+    JsonValue        mValue;
+};
+
+/**
+ * Json document which nodes and decoded strings are allocated in a single arena released at once. Strings without
+ * escape sequences are views into the parsed input.
+ */
+class JsonDocument {
+public:
+    /**
+     * Constructor.
+     */
+    JsonDocument();
+
+    /**
+     * Destructor.
+     */
+    ~JsonDocument();
+
+    JsonDocument(const JsonDocument&)            = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+    JsonDocument(JsonDocument&&)                 = default;
+    JsonDocument& operator=(JsonDocument&&)      = default;
+
+    /**
+     * Parses json string. The string should outlive the document as string values reference it.
+     *
+     * @param json json string.
+     * @return Error.
+     */
+    Error Parse(std::string_view json);
+
+    /**
+     * Parses json file. The file content is read into a buffer owned by the document.
+     *
+     * @param path path to the file.
+     * @return Error.
+     */
+    Error ParseFile(const std::string& path);
+
+    /**
+     * Returns root value.
+     *
+     * @return const JsonValue&.
+     */
+    const JsonValue& GetRoot() const { return mRoot; }
+
+    /**
+     * Releases all document nodes.
+     */
+    void Clear();
+
+    /**
+     * Returns number of bytes allocated by the arena.
+     *
+     * @return size_t.
+     */
+    size_t GetArenaSize() const;
+
+private:
+    class Builder;
+
+    void*       Allocate(size_t size, size_t alignment);
+    const char* CopyString(std::string_view str);
+    Error       ParseImpl(std::string_view json);
+
+    std::vector<std::pair<std::unique_ptr<uint8_t[]>, size_t>> mChunks;
+    uint8_t*                                                     mCurrent {};
+    size_t                                                       mLeft {};
+    std::unique_ptr<std::string>                                 mData;
+    JsonValue                                                    mRoot;
+};
+
+/**
+ * Read-only accessor for JsonValue object with case-insensitive keys. Mirrors CaseInsensitiveObjectWrapper.
+ */
+class JsonObjectView {
+public:
+    /**
+     * Constructor. Throws Poco::BadCastException if value is not object.
+     *
+     * @param value json value.
+     */
+    explicit JsonObjectView(const JsonValue& value);
+
+    /**
+     * Checks if key exists.
+     *
+     * @param key key.
+     * @return bool.
+     */
+    bool Has(std::string_view key) const { return Find(key) != nullptr; }
+
+    /**
+     * Gets value by key. Throws Poco::NotFoundException if key doesn't exist.
+     *
+     * @param key key.
+     * @return const JsonValue&.
+     */
+    const JsonValue& Get(std::string_view key) const;
+
+    /**
+     * Gets value by key.
+     *
+     * @param key key.
+     * @param defaultValue default value.
+     * @return T.
+     */
+    template <typename T>
+    T GetValue(std::string_view key, const T& defaultValue = T {}) const
+    {
+        if (const auto* value = Find(key); value != nullptr) {
+            return value->As<T>();
+        }
+
+        return defaultValue;
+    }
+
+    /**
+     * Gets optional value by key.
+     *
+     * @param key key.
+     * @return std::optional<T>.
+     */
+    template <typename T>
+    std::optional<T> GetOptionalValue(std::string_view key) const
+    {
+        if (const auto* value = Find(key); value != nullptr) {
+            return value->As<T>();
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * Gets array by key.
+     *
+     * @param key key.
+     * @return JsonRange<JsonValue>.
+     */
+    JsonRange<JsonValue> GetArray(std::string_view key) const { return Get(key).GetItems(); }
+
+    /**
+     * Gets object by key.
+     *
+     * @param key key.
+     * @return JsonObjectView.
+     */
+    JsonObjectView GetObject(std::string_view key) const { return JsonObjectView(Get(key)); }
+
+private:
+    const JsonValue* Find(std::string_view key) const;
+
+    const JsonValue* mObject;
+};
+
+/**
+ * Gets value array by key.
+ *
+ * @param object json object.
+ * @param key key.
+ * @return std::vector<T>.
+ */
+template <typename T>
+std::vector<T> GetArrayValue(const JsonObjectView& object, std::string_view key)
+{
+    std::vector<T> result;
+
+    if (!object.Has(key)) {
+        return result;
+    }
+
+    const auto items = object.GetArray(key);
+
+    result.reserve(items.Size());
+
+    for (const auto& item : items) {
+        result.push_back(item.As<T>());
+    }
+
+    return result;
+}
+
+} // namespace aos::common::utils
+
+#endif
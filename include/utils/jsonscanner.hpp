@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_JSONSCANNER_HPP_
+#define UTILS_JSONSCANNER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <aos/common/tools/error.hpp>
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Types
+ **********************************************************************************************************************/
+
+/**
+ * Instruction set used by json scanner.
+ */
+enum class SIMDLevel {
+    eScalar,
+    eSSE2,
+    eAVX2,
+    eNEON,
+};
+
+/**
+ * Json number.
+ */
+struct JsonNumber {
+    /**
+     * Number type.
+     */
+    enum class Type {
+        eInt,
+        eUInt,
+        eDouble,
+    };
+
+    Type     mType {Type::eInt};
+    int64_t  mInt {};
+    uint64_t mUInt {};
+    double   mDouble {};
+};
+
+/***********************************************************************************************************************
+ * Functions
+ **********************************************************************************************************************/
+
+/**
+ * Returns the best instruction set supported by the current CPU.
+ *
+ * @return SIMDLevel.
+ */
+SIMDLevel GetSIMDLevel();
+
+/**
+ * Builds structural index of json document: positions of structural characters ({, }, [, ], :, ,) outside of
+ * strings, positions of all unescaped quotes and positions of the first characters of literals and numbers. Input is
+ * processed in 64-byte blocks and validated to be UTF-8.
+ *
+ * @param json json document.
+ * @param[out] index structural index.
+ * @param level instruction set to use, it is limited by the one supported by the current CPU.
+ * @return Error.
+ */
+Error ScanJson(std::string_view json, std::vector<uint32_t>& index, SIMDLevel level = GetSIMDLevel());
+
+/**
+ * Parses json number token. Integers are parsed as int64_t if they fit and as uint64_t otherwise, numbers with
+ * fraction or exponent are parsed as double.
+ *
+ * @param token number token.
+ * @param[out] number parsed number.
+ * @return Error: eInvalidArgument if token is not a json number, eOutOfRange if integer doesn't fit 64 bits.
+ */
+Error ParseJsonNumber(std::string_view token, JsonNumber& number);
+
+/**
+ * Decodes json string content between quotes: checks for control characters and unescapes escape sequences.
+ *
+ * @param raw string content.
+ * @param[out] result decoded string.
+ * @return Error.
+ */
+Error DecodeJsonString(std::string_view raw, std::string& result);
+
+} // namespace aos::common::utils
+
+#endif
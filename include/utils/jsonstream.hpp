@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_JSONSTREAM_HPP_
+#define UTILS_JSONSTREAM_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Poco/Dynamic/Var.h>
+
+#include <aos/common/tools/error.hpp>
+
+namespace aos::common::utils {
+
+/**
+ * Reader of json documents stream: newline delimited json (json lines) or concatenated json documents separated by
+ * optional whitespaces. Records are split without parsing and parsed in place with ParseJsonFast. The read buffer and
+ * the structural index are reused between records.
+ */
+class JsonStreamReader {
+public:
+    /**
+     * Record handler: receives record index in the stream and parse result.
+     */
+    using RecordHandler = std::function<void(size_t index, const RetWithError<Poco::Dynamic::Var>& record)>;
+
+    /**
+     * Stream format.
+     */
+    enum class Format {
+        // Documents separated by optional whitespaces, a document may span several lines.
+        eConcatenated,
+        // Json lines: a record also ends at a new line, so a truncated record doesn't swallow the following lines.
+        eLines,
+    };
+
+    /**
+     * Default read buffer size.
+     */
+    static constexpr size_t cDefaultBufferSize = 64 * 1024;
+
+    /**
+     * Default max record size.
+     */
+    static constexpr size_t cDefaultMaxRecordSize = 64 * 1024 * 1024;
+
+    /**
+     * Creates reader from input stream.
+     *
+     * @param in input stream.
+     * @param maxRecordSize max record size.
+     * @param format stream format.
+     */
+    explicit JsonStreamReader(
+        std::istream& in, size_t maxRecordSize = cDefaultMaxRecordSize, Format format = Format::eConcatenated);
+
+    /**
+     * Creates reader from file descriptor. The descriptor is not closed by the reader.
+     *
+     * @param fd file descriptor.
+     * @param maxRecordSize max record size.
+     * @param format stream format.
+     */
+    explicit JsonStreamReader(
+        int fd, size_t maxRecordSize = cDefaultMaxRecordSize, Format format = Format::eConcatenated);
+
+    /**
+     * Reads next record. Invalid record is skipped: parse error is returned and the next call continues with the
+     * following record.
+     *
+     * @param[out] document parsed record.
+     * @return Error: eNotFound at the end of stream, eOutOfRange if record exceeds max record size.
+     */
+    Error Next(Poco::Dynamic::Var& document);
+
+    /**
+     * Reads all records and passes them to the handler. If threads is not zero, records are parsed and passed to the
+     * handler on a worker pool: handler is called concurrently and records may come out of order.
+     *
+     * @param handler record handler.
+     * @param threads number of worker threads.
+     * @return Error: stream read error.
+     */
+    Error ForEach(const RecordHandler& handler, size_t threads = 0);
+
+    /**
+     * Returns number of records read.
+     *
+     * @return size_t.
+     */
+    size_t GetRecordCount() const { return mRecordCount; }
+
+private:
+    using ReadFunc = std::function<RetWithError<size_t>(char* data, size_t size)>;
+
+    JsonStreamReader(ReadFunc read, size_t maxRecordSize, Format format);
+
+    Error NextRecord(std::string_view& record);
+    bool  FindRecordEnd();
+    Error Fill();
+
+    ReadFunc              mRead;
+    size_t                mMaxRecordSize;
+    Format                mFormat;
+    std::string           mBuffer;
+    size_t                mStart {};
+    size_t                mEnd {};
+    size_t                mScanPos {};
+    size_t                mDepth {};
+    bool                  mInString {};
+    bool                  mEscape {};
+    bool                  mEOF {};
+    Error                 mError;
+    size_t                mRecordCount {};
+    std::vector<uint32_t> mIndex;
+};
+
+} // namespace aos::common::utils
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_JSONWRITER_HPP_
+#define UTILS_JSONWRITER_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <Poco/Dynamic/Var.h>
+
+#include <aos/common/tools/error.hpp>
+
+namespace aos::common::utils {
+
+/**
+ * Streaming json writer. Output is accumulated in a reusable buffer which is either kept as a string or passed to the
+ * flush function when it is full. Errors are sticky: after the first error all calls are ignored and the error is
+ * returned by Flush and GetError.
+ */
+class JsonWriter {
+public:
+    /**
+     * Flush function: receives buffered output.
+     */
+    using FlushFunc = std::function<Error(std::string_view data)>;
+
+    /**
+     * Default buffer size.
+     */
+    static constexpr size_t cDefaultBufferSize = 64 * 1024;
+
+    /**
+     * Creates writer which accumulates the whole output in the buffer.
+     *
+     * @param reserve initial buffer capacity.
+     */
+    explicit JsonWriter(size_t reserve = cDefaultBufferSize);
+
+    /**
+     * Creates writer which passes output to the flush function each time buffer exceeds the buffer size.
+     *
+     * @param flush flush function.
+     * @param bufferSize buffer size.
+     */
+    explicit JsonWriter(FlushFunc flush, size_t bufferSize = cDefaultBufferSize);
+
+    /**
+     * Begins object.
+     *
+     * @return JsonWriter&.
+     */
+    JsonWriter& BeginObject();
+
+    /**
+     * Ends object.
+     *
+     * @return JsonWriter&.
+     */
+    JsonWriter& EndObject();
+
+    /**
+     * Begins array.
+     *
+     * @return JsonWriter&.
+     */
+    JsonWriter& BeginArray();
+
+    /**
+     * Ends array.
+     *
+     * @return JsonWriter&.
+     */
+    JsonWriter& EndArray();
+
+    /**
+     * Writes object key.
+     *
+     * @param key key.
+     * @return JsonWriter&.
+     */
+    JsonWriter& Key(std::string_view key);
+
+    /**
+     * Writes string value.
+     *
+     * @param value value.
+     * @return JsonWriter&.
+     */
+    JsonWriter& Value(std::string_view value);
+
+    /**
+     * Writes string value.
+     *
+     * @param value value.
+     * @return JsonWriter&.
+     */
+    JsonWriter& Value(const char* value) { return Value(std::string_view(value)); }
+
+    /**
+     * Writes string value.
+     *
+     * @param value value.
+     * @return JsonWriter&.
+     */
+    JsonWriter& Value(const std::string& value) { return Value(std::string_view(value)); }
+
+    /**
+     * Writes bool value.
+     *
+     * @param value value.
+     * @return JsonWriter&.
+     */
+    JsonWriter& Value(bool value);
+
+    /**
+     * Writes numeric value. Non finite floating point values are written as null.
+     *
+     * @param value value.
+     * @return JsonWriter&.
+     */
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>>
+    JsonWriter& Value(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            return WriteDouble(static_cast<double>(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            return WriteInt(static_cast<int64_t>(value));
+        } else {
+            return WriteUInt(static_cast<uint64_t>(value));
+        }
+    }
+
+    /**
+     * Writes Poco dynamic variable the same way as Poco::JSON::Stringifier: json objects and arrays are written
+     * recursively keeping object key order, other values according to their type.
+     *
+     * @param value value.
+     * @return JsonWriter&.
+     */
+    JsonWriter& Value(const Poco::Dynamic::Var& value);
+
+    /**
+     * Writes null value.
+     *
+     * @return JsonWriter&.
+     */
+    JsonWriter& Null();
+
+    /**
+     * Passes buffered output to the flush function. Does nothing for writer without flush function.
+     *
+     * @return Error.
+     */
+    Error Flush();
+
+    /**
+     * Returns the first error occurred.
+     *
+     * @return Error.
+     */
+    Error GetError() const { return mError; }
+
+    /**
+     * Returns buffered output.
+     *
+     * @return const std::string&.
+     */
+    const std::string& GetString() const { return mBuffer; }
+
+    /**
+     * Moves buffered output out of the writer.
+     *
+     * @return std::string.
+     */
+    std::string TakeString();
+
+    /**
+     * Resets writer state keeping the buffer capacity.
+     */
+    void Reset();
+
+private:
+    struct Scope {
+        bool mObject;
+        bool mEmpty;
+    };
+
+    bool        BeginValue();
+    JsonWriter& WriteInt(int64_t value);
+    JsonWriter& WriteUInt(uint64_t value);
+    JsonWriter& WriteDouble(double value);
+    JsonWriter& WriteRaw(std::string_view raw);
+    void        WriteString(std::string_view str);
+    void        FlushIfFull();
+    void        SetError(const Error& err);
+
+    FlushFunc          mFlush;
+    size_t             mBufferSize;
+    std::string        mBuffer;
+    std::vector<Scope> mScopes;
+    bool               mKeyWritten {};
+    Error              mError;
+};
+
+} // namespace aos::common::utils
+
+#endif
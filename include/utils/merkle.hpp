@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_MERKLE_HPP_
+#define UTILS_MERKLE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <aos/common/tools/error.hpp>
+
+#include "utils/image.hpp"
+
+namespace aos::common::utils {
+
+/**
+ * Size of the file chunk hashed separately in the Merkle tree.
+ */
+constexpr size_t cMerkleChunkSize = 1024 * 1024;
+
+/**
+ * Regular file of the Merkle tree.
+ */
+struct MerkleFile {
+    /**
+     * Path relative to the tree directory.
+     */
+    std::string mPath;
+
+    /**
+     * File size.
+     */
+    uint64_t mSize {};
+
+    /**
+     * Hex encoded sha256 of the file content, the same as used by HashDir.
+     */
+    std::string mHash;
+
+    /**
+     * Hex encoded sha256 of each cMerkleChunkSize chunk of the file content. The file of one chunk has its content
+     * hash as the chunk hash, the empty file has no chunks.
+     */
+    std::vector<std::string> mChunks;
+};
+
+/**
+ * Hashes file content and its chunks in one read. Only files bigger than one chunk are hashed twice.
+ *
+ * @param path file path.
+ * @return RetWithError<MerkleFile>: file without path, eNotFound if file doesn't exist.
+ */
+RetWithError<MerkleFile> HashMerkleFile(const std::string& path);
+
+/**
+ * Merkle tree of a directory. Leaves are regular files with their chunk hashes, inner nodes are directories, children
+ * of each node are combined by a binary hash tree. Hashes of the binary trees are kept in memory, so one file, chunk
+ * or subtree is verified against the root by hashing its data and O(log n) nodes. The tree is saved to a sidecar file
+ * which keeps directory, file and chunk hashes, inner nodes are recomputed on load and checked against the stored
+ * directory hashes. Files are ordered the same way as by WalkFiles, so the flat HashDir digest is derived from the
+ * file hashes.
+ */
+class MerkleTree {
+public:
+    /**
+     * Builds tree from files.
+     *
+     * @param files files in any order.
+     * @return Error: eInvalidArgument if paths are not unique or not normalized, a file is used as a directory or
+     * chunk count doesn't match file size.
+     */
+    Error Build(std::vector<MerkleFile> files);
+
+    /**
+     * Builds tree by hashing files of the directory on the calling thread. HashDir with mMerklePath option hashes
+     * files on the worker pool and reuses the hash cache.
+     *
+     * @param dir directory path.
+     * @return Error.
+     */
+    Error Scan(const std::string& dir);
+
+    /**
+     * Loads tree from the sidecar file.
+     *
+     * @param path sidecar path.
+     * @return Error: eInvalidArgument if the file is malformed, eInvalidChecksum if stored directory hashes don't match
+     * the files.
+     */
+    Error Load(const std::string& path);
+
+    /**
+     * Saves tree to the sidecar file atomically.
+     *
+     * @param path sidecar path.
+     * @return Error.
+     */
+    Error Save(const std::string& path) const;
+
+    /**
+     * Returns Merkle root digest.
+     *
+     * @return Digest.
+     */
+    Digest GetDigest() const;
+
+    /**
+     * Returns flat digest which HashDir returns for the same directory.
+     *
+     * @return Digest.
+     */
+    Digest GetFlatDigest() const;
+
+    /**
+     * Returns files in WalkFiles order.
+     *
+     * @return const std::vector<MerkleFile>&.
+     */
+    const std::vector<MerkleFile>& GetFiles() const { return mFiles; }
+
+    /**
+     * Finds file by path.
+     *
+     * @param path file path relative to the tree directory.
+     * @return RetWithError<MerkleFile>: eNotFound if there is no such file.
+     */
+    RetWithError<MerkleFile> FindFile(std::string_view path) const;
+
+    /**
+     * Verifies one file of the directory: the file is hashed and the hash is combined with the stored hashes of its
+     * siblings up to the root.
+     *
+     * @param dir tree directory path.
+     * @param path file path relative to the tree directory.
+     * @return Error: eInvalidChecksum if the file doesn't match the root, eNotFound if the file is not in the tree.
+     */
+    Error VerifyFile(const std::string& dir, std::string_view path) const;
+
+    /**
+     * Verifies one chunk of a file: only the chunk is read and hashed.
+     *
+     * @param dir tree directory path.
+     * @param path file path relative to the tree directory.
+     * @param index chunk index.
+     * @return Error: eInvalidChecksum if the chunk doesn't match the root, eOutOfRange if there is no such chunk.
+     */
+    Error VerifyChunk(const std::string& dir, std::string_view path, size_t index) const;
+
+    /**
+     * Verifies the subdirectory: files of the subdirectory are hashed, added and removed files are detected.
+     *
+     * @param dir tree directory path.
+     * @param path subdirectory path relative to the tree directory, empty for the whole tree.
+     * @return Error: eInvalidChecksum if the subdirectory doesn't match the root, eNotFound if the subdirectory is not
+     * in the tree.
+     */
+    Error VerifyDir(const std::string& dir, std::string_view path = "") const;
+
+    /**
+     * Returns paths of files which differ in the trees: added, removed or changed. Subtrees with equal hashes are
+     * skipped.
+     *
+     * @param other other tree.
+     * @return std::vector<std::string>: paths in WalkFiles order of the both trees.
+     */
+    std::vector<std::string> Diff(const MerkleTree& other) const;
+
+private:
+    using Levels = std::vector<std::vector<std::string>>;
+
+    struct Node {
+        std::string         mName;
+        size_t              mParent {};
+        size_t              mIndex {};
+        int64_t             mFile {-1};
+        std::vector<size_t> mChildren;
+        Levels              mLevels;
+        std::string         mHash;
+    };
+
+    void                 Clear();
+    size_t               AddNode(size_t parent, std::string name, std::string path);
+    RetWithError<size_t> FindNode(std::string_view path) const;
+    Error                VerifyNode(size_t node, std::string hash) const;
+    void                 CollectFiles(size_t node, std::vector<std::string>& paths) const;
+    void DiffNodes(const MerkleTree& other, size_t node, size_t otherNode, std::vector<std::string>& paths) const;
+
+    std::vector<MerkleFile>                 mFiles;
+    std::vector<Node>                       mNodes;
+    std::unordered_map<std::string, size_t> mPaths;
+};
+
+} // namespace aos::common::utils
+
+#endif
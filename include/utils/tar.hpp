@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_TAR_HPP_
+#define UTILS_TAR_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/types.h>
+#include <time.h>
+
+#include <aos/common/tools/error.hpp>
+
+namespace aos::common::utils {
+
+/**
+ * Tar archive entry.
+ */
+struct TarEntry {
+    /**
+     * Entry type.
+     */
+    enum class Type { eFile, eHardLink, eSymLink, eCharDevice, eBlockDevice, eDirectory, eFifo };
+
+    std::string mPath;
+    std::string mLinkPath;
+    Type        mType {Type::eFile};
+    mode_t      mMode {};
+    uid_t       mUID {};
+    gid_t       mGID {};
+    uint64_t    mSize {};
+    timespec    mMTime {};
+    uint32_t    mDevMajor {};
+    uint32_t    mDevMinor {};
+    uint64_t    mOffset {};
+};
+
+/**
+ * Streaming tar archive reader. Supports ustar, pax (local and global extended headers) and GNU (long names, base-256
+ * numbers) formats. Entry data is passed to the caller directly from the read buffer.
+ */
+class TarReader {
+public:
+    /**
+     * Read function: reads up to size bytes to data, returns 0 at the end of data.
+     */
+    using ReadFunc = std::function<RetWithError<size_t>(char* data, size_t size)>;
+
+    /**
+     * Data handler: receives the next chunk of entry data.
+     */
+    using DataHandler = std::function<Error(std::string_view data)>;
+
+    /**
+     * Tar block size.
+     */
+    static constexpr size_t cBlockSize = 512;
+
+    /**
+     * Default read buffer size.
+     */
+    static constexpr size_t cDefaultBufferSize = 1024 * 1024;
+
+    /**
+     * Max size of pax extended header or GNU long name.
+     */
+    static constexpr size_t cMaxExtendedHeaderSize = 1024 * 1024;
+
+    /**
+     * Creates reader from file descriptor. The descriptor is not closed by the reader. If the descriptor refers to a
+     * regular file, big unread entries are skipped by seeking instead of reading.
+     *
+     * @param fd file descriptor.
+     * @param bufferSize read buffer size.
+     */
+    explicit TarReader(int fd, size_t bufferSize = cDefaultBufferSize);
+
+    /**
+     * Creates reader from input stream.
+     *
+     * @param in input stream.
+     * @param bufferSize read buffer size.
+     */
+    explicit TarReader(std::istream& in, size_t bufferSize = cDefaultBufferSize);
+
+    /**
+     * Creates reader from read function.
+     *
+     * @param read read function.
+     * @param bufferSize read buffer size.
+     */
+    TarReader(ReadFunc read, size_t bufferSize = cDefaultBufferSize);
+
+    /**
+     * Reads next entry header. Unread data of the previous entry is skipped.
+     *
+     * @param[out] entry entry.
+     * @return Error: eNotFound at the end of archive, eInvalidChecksum on header checksum mismatch, eFailed on
+     * malformed or truncated archive.
+     */
+    Error Next(TarEntry& entry);
+
+    /**
+     * Passes unread data of the current entry to the handler.
+     *
+     * @param handler data handler.
+     * @return Error.
+     */
+    Error ReadData(const DataHandler& handler);
+
+    /**
+     * Returns number of archive bytes consumed.
+     *
+     * @return uint64_t.
+     */
+    uint64_t GetOffset() const { return mOffset; }
+
+private:
+    using PaxHeaders = std::map<std::string, std::string>;
+    using SeekFunc   = std::function<Error(uint64_t size)>;
+
+    Error ReadBlock(const char*& block);
+    Error ReadExtended(uint64_t size, std::string& data);
+    Error Skip(uint64_t size);
+    Error Fill(size_t size);
+    void  Consume(size_t size);
+    Error ParseHeader(const char* block, TarEntry& entry, char& typeflag);
+    Error ParsePax(std::string_view data, PaxHeaders& headers);
+    Error ApplyPax(const PaxHeaders& headers, TarEntry& entry);
+
+    ReadFunc          mRead;
+    SeekFunc          mSeek;
+    std::vector<char> mBuffer;
+    size_t            mStart {};
+    size_t            mEnd {};
+    bool              mEOF {};
+    bool              mEnded {};
+    uint64_t          mOffset {};
+    uint64_t          mRemaining {};
+    uint64_t          mPadding {};
+    PaxHeaders        mGlobalHeaders;
+};
+
+/**
+ * Extracts tar entries to the destination directory. Entry paths are resolved relative to the destination without
+ * following symlinks: absolute paths are made relative, paths with ".." components are rejected. Directory
+ * permissions and modification times are applied on close, so read-only directories may be extracted. Owners and
+ * special mode bits are restored only if the process runs as root, otherwise permissions are subject to umask.
+ */
+class TarExtractor {
+public:
+    /**
+     * Constructor.
+     */
+    TarExtractor() = default;
+
+    /**
+     * Destructor.
+     */
+    ~TarExtractor();
+
+    TarExtractor(const TarExtractor&)            = delete;
+    TarExtractor& operator=(const TarExtractor&) = delete;
+
+    /**
+     * Opens destination directory.
+     *
+     * @param destination destination directory.
+     * @param sync flushes extracted data to the storage on close.
+     * @return Error.
+     */
+    Error Open(const std::string& destination, bool sync = false);
+
+    /**
+     * Extracts entry. Entry data is read from the reader.
+     *
+     * @param reader tar reader.
+     * @param entry entry returned by the reader.
+     * @param observer optional handler which receives regular file data before it is written.
+     * @return Error.
+     */
+    Error Extract(TarReader& reader, const TarEntry& entry, const TarReader::DataHandler& observer = nullptr);
+
+    /**
+     * Applies directory attributes and closes destination.
+     *
+     * @return Error.
+     */
+    Error Close();
+
+private:
+    struct Directory {
+        std::string mPath;
+        mode_t      mMode;
+        uid_t       mUID;
+        gid_t       mGID;
+        timespec    mMTime;
+    };
+
+    RetWithError<int> OpenDir(std::string_view path, bool create);
+    RetWithError<int> OpenParent(std::string_view path);
+    Error             ExtractFile(TarReader& reader, const TarEntry& entry, const TarReader::DataHandler& observer,
+                                  int parentFD, const char* name);
+    Error             ExtractDirectory(const TarEntry& entry, const std::string& path, int parentFD, const char* name);
+    Error             ExtractHardLink(const TarEntry& entry, int parentFD, const char* name);
+    Error             SetAttributes(const TarEntry& entry, int parentFD, const char* name);
+    void              CloseParent();
+
+    int                    mRootFD {-1};
+    bool                   mSync {};
+    bool                   mRoot {};
+    std::string            mParentPath;
+    int                    mParentFD {-1};
+    std::vector<Directory> mDirectories;
+};
+
+/**
+ * Normalizes tar entry path the same way as TarExtractor does: leading slashes and "." components are removed.
+ *
+ * @param path entry path.
+ * @return RetWithError<std::string>: relative path, empty for the destination directory itself, eInvalidArgument if
+ * path contains ".." components.
+ */
+RetWithError<std::string> NormalizeTarPath(std::string_view path);
+
+/**
+ * Extracts tar archive.
+ *
+ * @param reader tar reader.
+ * @param destination destination directory.
+ * @param sync flushes extracted data to the storage before return.
+ * @return Error.
+ */
+Error ExtractTar(TarReader& reader, const std::string& destination, bool sync = false);
+
+} // namespace aos::common::utils
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UTILS_TARINDEX_HPP_
+#define UTILS_TARINDEX_HPP_
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <aos/common/tools/error.hpp>
+
+#include "utils/tar.hpp"
+
+namespace aos::common::utils {
+
+/**
+ * Suffix of the index file stored next to the archive.
+ */
+constexpr auto cTarIndexSuffix = ".tarindex";
+
+/**
+ * Random-access index of an uncompressed tar archive. Entry headers, data offsets and sizes are collected in one scan
+ * of the archive and persisted to the index file, so later lookups don't read the archive. Entry data is read with
+ * pread, so a single file is read without extracting the archive. Read methods may be called concurrently.
+ */
+class TarIndex {
+public:
+    /**
+     * Constructor.
+     */
+    TarIndex() = default;
+
+    /**
+     * Destructor.
+     */
+    ~TarIndex();
+
+    TarIndex(const TarIndex&)            = delete;
+    TarIndex& operator=(const TarIndex&) = delete;
+
+    /**
+     * Opens archive. The index is loaded from the index file if it was built for the same archive file, otherwise the
+     * archive is scanned and the index file is rewritten.
+     *
+     * @param archivePath path to the archive.
+     * @param indexPath path to the index file, empty for the archive path with cTarIndexSuffix.
+     * @return Error: eNotSupported for compressed archive.
+     */
+    Error Open(const std::string& archivePath, const std::string& indexPath = "");
+
+    /**
+     * Closes archive.
+     */
+    void Close();
+
+    /**
+     * Returns archive entries in archive order.
+     *
+     * @return const std::vector<TarEntry>&.
+     */
+    const std::vector<TarEntry>& GetEntries() const { return mEntries; }
+
+    /**
+     * Finds entry by path. If the archive has several entries with the same path, the last one is returned as it
+     * replaces the previous ones on extraction.
+     *
+     * @param path entry path, normalized the same way as entry paths.
+     * @return RetWithError<TarEntry>: eNotFound if there is no such entry.
+     */
+    RetWithError<TarEntry> Find(std::string_view path) const;
+
+    /**
+     * Reads regular file entry data.
+     *
+     * @param entry regular file entry.
+     * @param offset offset in the entry data.
+     * @param data buffer.
+     * @param size buffer size.
+     * @return RetWithError<size_t>: number of bytes read, 0 at the end of entry data.
+     */
+    RetWithError<size_t> Read(const TarEntry& entry, uint64_t offset, char* data, size_t size) const;
+
+    /**
+     * Reads whole regular file by path. Hard links are resolved to their target files.
+     *
+     * @param path entry path.
+     * @return RetWithError<std::string>: file content, eNotFound if there is no such entry, eInvalidArgument if entry
+     * is not a regular file.
+     */
+    RetWithError<std::string> ReadFile(std::string_view path) const;
+
+private:
+    struct FileID {
+        uint64_t mInode {};
+        uint64_t mSize {};
+        int64_t  mMTime {};
+    };
+
+    Error Build();
+    Error Load(const std::string& indexPath, const FileID& id);
+    Error Save(const std::string& indexPath, const FileID& id) const;
+    void  AddPath(size_t index);
+
+    int                                     mFD {-1};
+    uint64_t                                mArchiveSize {};
+    std::vector<TarEntry>                   mEntries;
+    std::unordered_map<std::string, size_t> mPaths;
+};
+
+} // namespace aos::common::utils
+
+#endif
@@ -30,10 +30,10 @@ using Duration = std::chrono::duration<int64_t, std::nano>;
  **********************************************************************************************************************/
 
 /**
- * Parses duration from string.
+ * Parses duration from string: sequence of decimal numbers with ns, us, µs, ms, s, m, h, d, w or y units.
  *
  * @param duration duration string.
- * @return parsed duration.
+ * @return parsed duration, eInvalidArgument for malformed string, eOutOfRange if duration overflows.
  */
 aos::RetWithError<Duration> ParseDuration(const std::string& duration);
 
@@ -0,0 +1,555 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/blobstore.hpp"
+#include "utils/digest.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/tarindex.hpp"
+
+namespace fs = std::filesystem;
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr std::string_view cIndexHeader   = "aosblobs 1\n";
+constexpr auto             cIndexFile     = "index";
+constexpr auto             cBlobsDir      = "blobs";
+constexpr size_t           cCopyChunkSize = 1024 * 1024;
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+// Copies file to the blob file hashing the data.
+Error CopyHashed(int fd, AtomicFile& blob, Hasher& hasher, uint64_t& size)
+{
+    std::vector<char> buffer(cCopyChunkSize);
+
+    while (true) {
+        const auto count = read(fd, buffer.data(), buffer.size());
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (count < 0) {
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+
+        if (count == 0) {
+            return ErrorEnum::eNone;
+        }
+
+        const std::string_view data(buffer.data(), static_cast<size_t>(count));
+
+        hasher.Update(data);
+
+        if (auto err = blob.Write(data); !err.IsNone()) {
+            return err;
+        }
+
+        size += static_cast<uint64_t>(count);
+    }
+}
+
+// Checks if the file is the tar index of a blob.
+bool IsTarIndex(std::string_view name)
+{
+    constexpr std::string_view cSuffix = cTarIndexSuffix;
+
+    return name.size() > cSuffix.size() && name.substr(name.size() - cSuffix.size()) == cSuffix
+        && ValidateDigest(std::string(name.substr(0, name.size() - cSuffix.size()))).IsNone();
+}
+
+// Algorithm of a digest is case-insensitive, it is lower-cased so a blob has one index key and one path.
+Digest NormalizeDigest(const Digest& digest)
+{
+    auto result = digest;
+
+    std::transform(result.begin(), result.begin() + std::min(result.find(':'), result.size()), result.begin(),
+        [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+    return result;
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+Error BlobStore::Init(const std::string& dir, uint64_t maxSize)
+{
+    std::lock_guard lock {mMutex};
+
+    mDir     = dir;
+    mMaxSize = maxSize;
+    mSize    = 0;
+
+    mEntries.clear();
+    mIndex.clear();
+
+    std::error_code ec;
+
+    if (fs::create_directories(fs::path(mDir) / cBlobsDir, ec); ec) {
+        return Error(ErrorEnum::eFailed, "Can't create blob store directory");
+    }
+
+    // Missing or corrupted index is rebuilt from the stored blobs.
+    auto changed = !LoadIndex().IsNone();
+
+    if (changed) {
+        mEntries.clear();
+        mIndex.clear();
+        mSize = 0;
+    }
+
+    if (auto err = SyncIndex(changed); !err.IsNone()) {
+        return err;
+    }
+
+    // Size limit may be decreased since the last run.
+    if (mSize > mMaxSize) {
+        if (auto err = Evict(); !err.IsNone()) {
+            return err;
+        }
+
+        changed = true;
+    }
+
+    return changed ? SaveIndex() : ErrorEnum::eNone;
+}
+
+Error BlobStore::Add(const Digest& digest, const std::string& path)
+{
+    const auto blobDigest = NormalizeDigest(digest);
+
+    if (auto err = ValidateDigest(blobDigest); !err.IsNone()) {
+        return err;
+    }
+
+    auto [algorithm, err] = ParseHashAlgorithm(ParseDigest(blobDigest).first);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    std::string blobPath;
+    uint64_t    maxSize = 0;
+
+    {
+        std::lock_guard lock {mMutex};
+
+        // Usage order is saved by Flush as for Pin.
+        if (auto it = mIndex.find(blobDigest); it != mIndex.end()) {
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+
+            return ErrorEnum::eNone;
+        }
+
+        blobPath = GetBlobPath(blobDigest);
+        maxSize  = mMaxSize;
+    }
+
+    if (std::error_code ec; fs::create_directories(fs::path(blobPath).parent_path(), ec), ec) {
+        return Error(ErrorEnum::eFailed, "Can't create blob directory");
+    }
+
+    const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Error(errno == ENOENT ? ErrorEnum::eNotFound : ErrorEnum::eFailed, strerror(errno));
+    }
+
+    struct stat st {};
+
+    if (fstat(fd, &st) != 0) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        close(fd);
+
+        return err;
+    }
+
+    if (static_cast<uint64_t>(st.st_size) > maxSize) {
+        close(fd);
+
+        return Error(ErrorEnum::eNoMemory, "Blob exceeds store size limit");
+    }
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    // Copy and hash without lock: concurrent adding of the same blob is harmless, both copies are verified.
+    AtomicFile blob;
+    Hasher     hasher(algorithm);
+    uint64_t   size = 0;
+
+    err = blob.Open(blobPath, 0444);
+
+    if (err.IsNone()) {
+        err = CopyHashed(fd, blob, hasher, size);
+    }
+
+    close(fd);
+
+    if (err.IsNone() && ParseDigest(blobDigest).second != hasher.Finish()) {
+        err = Error(ErrorEnum::eInvalidChecksum, "Digest mismatch");
+    }
+
+    if (err.IsNone()) {
+        err = blob.Commit(true);
+    }
+
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    std::lock_guard lock {mMutex};
+
+    Insert(blobDigest, size);
+
+    if (err = Evict(); !err.IsNone()) {
+        return err;
+    }
+
+    return SaveIndex();
+}
+
+RetWithError<std::string> BlobStore::Pin(const Digest& digest)
+{
+    const auto blobDigest = NormalizeDigest(digest);
+
+    std::lock_guard lock {mMutex};
+
+    auto it = mIndex.find(blobDigest);
+    if (it == mIndex.end()) {
+        return {"", Error(ErrorEnum::eNotFound, "Blob is not stored")};
+    }
+
+    it->second->mPins++;
+    mEntries.splice(mEntries.begin(), mEntries, it->second);
+
+    return GetBlobPath(blobDigest);
+}
+
+Error BlobStore::Unpin(const Digest& digest)
+{
+    const auto blobDigest = NormalizeDigest(digest);
+
+    std::lock_guard lock {mMutex};
+
+    auto it = mIndex.find(blobDigest);
+    if (it == mIndex.end() || it->second->mPins == 0) {
+        return Error(ErrorEnum::eWrongState, "Blob is not pinned");
+    }
+
+    if (--it->second->mPins > 0 || mSize <= mMaxSize) {
+        return ErrorEnum::eNone;
+    }
+
+    if (auto err = Evict(); !err.IsNone()) {
+        return err;
+    }
+
+    return SaveIndex();
+}
+
+Error BlobStore::Remove(const Digest& digest)
+{
+    const auto blobDigest = NormalizeDigest(digest);
+
+    std::lock_guard lock {mMutex};
+
+    auto it = mIndex.find(blobDigest);
+    if (it == mIndex.end()) {
+        return Error(ErrorEnum::eNotFound, "Blob is not stored");
+    }
+
+    if (it->second->mPins > 0) {
+        return Error(ErrorEnum::eWrongState, "Blob is pinned");
+    }
+
+    if (auto err = RemoveBlob(blobDigest); !err.IsNone()) {
+        return err;
+    }
+
+    mSize -= it->second->mSize;
+    mEntries.erase(it->second);
+    mIndex.erase(it);
+
+    return SaveIndex();
+}
+
+bool BlobStore::Contains(const Digest& digest) const
+{
+    const auto blobDigest = NormalizeDigest(digest);
+
+    std::lock_guard lock {mMutex};
+
+    return mIndex.count(blobDigest) != 0;
+}
+
+Error BlobStore::Flush()
+{
+    std::lock_guard lock {mMutex};
+
+    return SaveIndex();
+}
+
+uint64_t BlobStore::GetSize() const
+{
+    std::lock_guard lock {mMutex};
+
+    return mSize;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+std::string BlobStore::GetBlobPath(const Digest& digest) const
+{
+    const auto [algorithm, hex] = ParseDigest(digest);
+
+    return (fs::path(mDir) / cBlobsDir / algorithm / hex).string();
+}
+
+// Index lists blobs from the most to the least recently used, one "<size> <digest>" line per blob.
+Error BlobStore::LoadIndex()
+{
+    MappedFile file;
+
+    if (auto err = file.Open((fs::path(mDir) / cIndexFile).string(), true); !err.IsNone()) {
+        return err;
+    }
+
+    if (file.View().substr(0, cIndexHeader.size()) != cIndexHeader) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid blob store index");
+    }
+
+    auto data = file.View().substr(cIndexHeader.size());
+
+    while (!data.empty()) {
+        const auto end = data.find('\n');
+        if (end == std::string_view::npos) {
+            return Error(ErrorEnum::eInvalidArgument, "Invalid blob store index");
+        }
+
+        const auto line = data.substr(0, end);
+        uint64_t   size = 0;
+
+        auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), size);
+        if (ec != std::errc() || ptr == line.data() + line.size() || *ptr != ' ') {
+            return Error(ErrorEnum::eInvalidArgument, "Invalid blob store index");
+        }
+
+        const Digest digest(ptr + 1, line.data() + line.size());
+
+        if (!ValidateDigest(digest).IsNone() || mIndex.count(digest) != 0) {
+            return Error(ErrorEnum::eInvalidArgument, "Invalid blob store index");
+        }
+
+        mEntries.push_back({digest, size, 0});
+        mIndex.emplace(digest, std::prev(mEntries.end()));
+        mSize += size;
+
+        data.remove_prefix(end + 1);
+    }
+
+    return ErrorEnum::eNone;
+}
+
+// Blobs may be removed or added without saving the index if the store is interrupted, so the index is synced with
+// stored blobs: entries of missing blobs are dropped and blobs missing in the index are added as the least recently
+// used, ordered by modification time as their usage order is unknown.
+Error BlobStore::SyncIndex(bool& changed)
+{
+    struct Blob {
+        Digest   mDigest;
+        uint64_t mSize {};
+        int64_t  mMTime {};
+    };
+
+    std::vector<Blob> blobs;
+    std::error_code   ec;
+
+    // Range-for can't report increment errors, so the iterators are advanced with error codes.
+    for (fs::directory_iterator algorithmDir(fs::path(mDir) / cBlobsDir, ec), end; !ec && algorithmDir != end;
+         algorithmDir.increment(ec)) {
+        if (!algorithmDir->is_directory(ec) || ec) {
+            ec.clear();
+
+            continue;
+        }
+
+        for (fs::directory_iterator file(algorithmDir->path(), ec); !ec && file != end; file.increment(ec)) {
+            const auto digest = algorithmDir->path().filename().string() + ":" + file->path().filename().string();
+
+            struct stat st {};
+
+            if (IsTarIndex(digest)) {
+                continue;
+            }
+
+            // Temporary files of interrupted adds are removed.
+            if (!ValidateDigest(digest).IsNone()) {
+                unlink(file->path().c_str());
+
+                continue;
+            }
+
+            if (lstat(file->path().c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+                continue;
+            }
+
+            blobs.push_back({digest, static_cast<uint64_t>(st.st_size),
+                static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec});
+        }
+
+        if (ec) {
+            break;
+        }
+    }
+
+    if (ec) {
+        return Error(ErrorEnum::eFailed, "Can't read blob store directory");
+    }
+
+    std::unordered_map<Digest, uint64_t> sizes;
+
+    for (const auto& blob : blobs) {
+        sizes.emplace(blob.mDigest, blob.mSize);
+    }
+
+    for (auto it = mEntries.begin(); it != mEntries.end();) {
+        const auto size = sizes.find(it->mDigest);
+
+        if (size == sizes.end()) {
+            changed = true;
+            mSize -= it->mSize;
+            mIndex.erase(it->mDigest);
+            it = mEntries.erase(it);
+
+            continue;
+        }
+
+        if (size->second != it->mSize) {
+            changed   = true;
+            mSize     = mSize - it->mSize + size->second;
+            it->mSize = size->second;
+        }
+
+        ++it;
+    }
+
+    std::sort(blobs.begin(), blobs.end(), [](const Blob& lhs, const Blob& rhs) { return lhs.mMTime > rhs.mMTime; });
+
+    for (const auto& blob : blobs) {
+        if (mIndex.count(blob.mDigest) != 0) {
+            continue;
+        }
+
+        changed = true;
+
+        mEntries.push_back({blob.mDigest, blob.mSize, 0});
+        mIndex.emplace(blob.mDigest, std::prev(mEntries.end()));
+        mSize += blob.mSize;
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error BlobStore::SaveIndex()
+{
+    std::string data(cIndexHeader);
+
+    for (const auto& entry : mEntries) {
+        data.append(std::to_string(entry.mSize)).append(" ").append(entry.mDigest).append("\n");
+    }
+
+    AtomicFile file;
+
+    if (auto err = file.Open((fs::path(mDir) / cIndexFile).string()); !err.IsNone()) {
+        return err;
+    }
+
+    if (auto err = file.Write(data); !err.IsNone()) {
+        return err;
+    }
+
+    return file.Commit();
+}
+
+void BlobStore::Insert(const Digest& digest, uint64_t size)
+{
+    // Blob may be added concurrently: the stored file is replaced by the same content.
+    if (auto it = mIndex.find(digest); it != mIndex.end()) {
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+
+        return;
+    }
+
+    mEntries.push_front({digest, size, 0});
+    mIndex.emplace(digest, mEntries.begin());
+    mSize += size;
+}
+
+// Tar index stored next to the blob is removed with it.
+Error BlobStore::RemoveBlob(const Digest& digest) const
+{
+    const auto path = GetBlobPath(digest);
+
+    if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    if (unlink((path + cTarIndexSuffix).c_str()) != 0 && errno != ENOENT) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error BlobStore::Evict()
+{
+    // The most recently used blob is kept, so the just added blob is not evicted.
+    for (auto it = mEntries.end(); mSize > mMaxSize && it != mEntries.begin() && std::prev(it) != mEntries.begin();) {
+        --it;
+
+        if (it->mPins > 0) {
+            continue;
+        }
+
+        if (auto err = RemoveBlob(it->mDigest); !err.IsNone()) {
+            return err;
+        }
+
+        mSize -= it->mSize;
+        mIndex.erase(it->mDigest);
+        it = mEntries.erase(it);
+    }
+
+    return ErrorEnum::eNone;
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,877 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <Poco/JSON/Array.h>
+
+#include "utils/cbor.hpp"
+#include "utils/filesystem.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr uint8_t cMajorUInt   = 0;
+constexpr uint8_t cMajorNegInt = 1;
+constexpr uint8_t cMajorBytes  = 2;
+constexpr uint8_t cMajorText   = 3;
+constexpr uint8_t cMajorArray  = 4;
+constexpr uint8_t cMajorMap    = 5;
+constexpr uint8_t cMajorTag    = 6;
+constexpr uint8_t cMajorSimple = 7;
+
+constexpr uint8_t cInfoFalse      = 20;
+constexpr uint8_t cInfoTrue       = 21;
+constexpr uint8_t cInfoNull       = 22;
+constexpr uint8_t cInfoUndefined  = 23;
+constexpr uint8_t cInfoUInt8      = 24;
+constexpr uint8_t cInfoUInt16     = 25;
+constexpr uint8_t cInfoUInt32     = 26;
+constexpr uint8_t cInfoUInt64     = 27;
+constexpr uint8_t cInfoIndefinite = 31;
+constexpr uint8_t cBreak          = 0xff;
+
+constexpr size_t cReadChunkSize = 64 * 1024;
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+double DecodeHalf(uint16_t half)
+{
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+    double    value {};
+
+    if (exponent == 0) {
+        value = std::ldexp(mantissa, -24);
+    } else if (exponent != 31) {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    } else {
+        value = mantissa == 0 ? INFINITY : NAN;
+    }
+
+    return (half & 0x8000) ? -value : value;
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * CborEncoder
+ **********************************************************************************************************************/
+
+CborEncoder::CborEncoder(size_t reserve)
+    : mBufferSize(0)
+{
+    mBuffer.reserve(reserve);
+}
+
+CborEncoder::CborEncoder(FlushFunc flush, size_t bufferSize)
+    : mFlush(std::move(flush))
+    , mBufferSize(bufferSize)
+{
+    mBuffer.reserve(bufferSize + sizeof(uint64_t) + 1);
+}
+
+CborEncoder& CborEncoder::BeginObject(size_t size)
+{
+    return BeginContainer(true, size);
+}
+
+CborEncoder& CborEncoder::EndObject()
+{
+    return EndContainer(true);
+}
+
+CborEncoder& CborEncoder::BeginArray(size_t size)
+{
+    return BeginContainer(false, size);
+}
+
+CborEncoder& CborEncoder::EndArray()
+{
+    return EndContainer(false);
+}
+
+CborEncoder& CborEncoder::Key(std::string_view key)
+{
+    if (!mError.IsNone()) {
+        return *this;
+    }
+
+    if (mScopes.empty() || !mScopes.back().mObject || mKeyWritten
+        || (mScopes.back().mSize != cIndefinite && mScopes.back().mCount == mScopes.back().mSize)) {
+        SetError(Error(ErrorEnum::eWrongState, "unexpected key"));
+
+        return *this;
+    }
+
+    mScopes.back().mCount++;
+    mKeyWritten = true;
+
+    WriteHead(cMajorText, key.size());
+    mBuffer.append(key);
+
+    FlushIfFull();
+
+    return *this;
+}
+
+CborEncoder& CborEncoder::Value(std::string_view value)
+{
+    if (BeginValue()) {
+        WriteHead(cMajorText, value.size());
+        mBuffer.append(value);
+
+        FlushIfFull();
+    }
+
+    return *this;
+}
+
+CborEncoder& CborEncoder::Value(bool value)
+{
+    if (BeginValue()) {
+        WriteHead(cMajorSimple, value ? cInfoTrue : cInfoFalse);
+
+        FlushIfFull();
+    }
+
+    return *this;
+}
+
+CborEncoder& CborEncoder::Value(const Poco::Dynamic::Var& value)
+{
+    const auto& type = value.type();
+
+    if (type == typeid(Poco::JSON::Object::Ptr) || type == typeid(Poco::JSON::Object)) {
+        const auto& object = type == typeid(Poco::JSON::Object::Ptr) ? *value.extract<Poco::JSON::Object::Ptr>()
+                                                                     : value.extract<Poco::JSON::Object>();
+
+        BeginObject(object.size());
+
+        // Names are returned in insertion order if the object preserves it, as JsonWriter writes them.
+        for (const auto& key : object.getNames()) {
+            Key(key).Value(object.get(key));
+        }
+
+        return EndObject();
+    }
+
+    if (type == typeid(Poco::JSON::Array::Ptr) || type == typeid(Poco::JSON::Array)) {
+        const auto& array = type == typeid(Poco::JSON::Array::Ptr) ? *value.extract<Poco::JSON::Array::Ptr>()
+                                                                   : value.extract<Poco::JSON::Array>();
+
+        BeginArray(array.size());
+
+        for (const auto& item : array) {
+            Value(item);
+        }
+
+        return EndArray();
+    }
+
+    if (value.isEmpty()) {
+        return Null();
+    }
+
+    if (value.isString()) {
+        return Value(value.extract<std::string>());
+    }
+
+    if (value.isBoolean()) {
+        return Value(value.convert<bool>());
+    }
+
+    if (value.isInteger()) {
+        return value.isSigned() ? WriteInt(value.convert<Poco::Int64>()) : WriteUInt(value.convert<Poco::UInt64>());
+    }
+
+    if (value.isNumeric()) {
+        return WriteDouble(value.convert<double>());
+    }
+
+    return Value(value.convert<std::string>());
+}
+
+CborEncoder& CborEncoder::Null()
+{
+    if (BeginValue()) {
+        WriteHead(cMajorSimple, cInfoNull);
+
+        FlushIfFull();
+    }
+
+    return *this;
+}
+
+Error CborEncoder::Flush()
+{
+    if (!mError.IsNone() || !mFlush || mBuffer.empty()) {
+        return mError;
+    }
+
+    SetError(mFlush(mBuffer));
+
+    mBuffer.clear();
+
+    return mError;
+}
+
+std::string CborEncoder::TakeString()
+{
+    auto result = std::move(mBuffer);
+
+    Reset();
+
+    return result;
+}
+
+void CborEncoder::Reset()
+{
+    mBuffer.clear();
+    mScopes.clear();
+    mKeyWritten = false;
+    mError      = ErrorEnum::eNone;
+}
+
+bool CborEncoder::BeginValue()
+{
+    if (!mError.IsNone()) {
+        return false;
+    }
+
+    if (mScopes.empty()) {
+        return true;
+    }
+
+    auto& scope = mScopes.back();
+
+    if (scope.mObject) {
+        if (!mKeyWritten) {
+            SetError(Error(ErrorEnum::eWrongState, "map key expected"));
+
+            return false;
+        }
+
+        mKeyWritten = false;
+
+        return true;
+    }
+
+    if (scope.mSize != cIndefinite && scope.mCount == scope.mSize) {
+        SetError(Error(ErrorEnum::eWrongState, "array size exceeded"));
+
+        return false;
+    }
+
+    scope.mCount++;
+
+    return true;
+}
+
+CborEncoder& CborEncoder::BeginContainer(bool object, size_t size)
+{
+    if (!BeginValue()) {
+        return *this;
+    }
+
+    const auto major = object ? cMajorMap : cMajorArray;
+
+    if (size == cIndefinite) {
+        mBuffer += static_cast<char>(major << 5 | cInfoIndefinite);
+    } else {
+        WriteHead(major, size);
+    }
+
+    mScopes.push_back({object, size, 0});
+
+    FlushIfFull();
+
+    return *this;
+}
+
+CborEncoder& CborEncoder::EndContainer(bool object)
+{
+    if (!mError.IsNone()) {
+        return *this;
+    }
+
+    if (mScopes.empty() || mScopes.back().mObject != object || mKeyWritten) {
+        SetError(Error(ErrorEnum::eWrongState, "unexpected end of container"));
+
+        return *this;
+    }
+
+    const auto scope = mScopes.back();
+
+    mScopes.pop_back();
+
+    if (scope.mSize == cIndefinite) {
+        mBuffer += static_cast<char>(cBreak);
+    } else if (scope.mCount != scope.mSize) {
+        SetError(Error(ErrorEnum::eWrongState, "container size mismatch"));
+
+        return *this;
+    }
+
+    FlushIfFull();
+
+    return *this;
+}
+
+CborEncoder& CborEncoder::WriteInt(int64_t value)
+{
+    if (value >= 0) {
+        return WriteUInt(static_cast<uint64_t>(value));
+    }
+
+    if (BeginValue()) {
+        WriteHead(cMajorNegInt, static_cast<uint64_t>(-(value + 1)));
+
+        FlushIfFull();
+    }
+
+    return *this;
+}
+
+CborEncoder& CborEncoder::WriteUInt(uint64_t value)
+{
+    if (BeginValue()) {
+        WriteHead(cMajorUInt, value);
+
+        FlushIfFull();
+    }
+
+    return *this;
+}
+
+CborEncoder& CborEncoder::WriteDouble(double value)
+{
+    if (!BeginValue()) {
+        return *this;
+    }
+
+    // Narrowing finite value out of float range is undefined, such values are written as double.
+    const bool inRange = !std::isfinite(value) || std::fabs(value) <= std::numeric_limits<float>::max();
+    const auto single  = inRange ? static_cast<float>(value) : 0.0f;
+
+    if (inRange && (static_cast<double>(single) == value || std::isnan(value))) {
+        uint32_t bits {};
+
+        std::memcpy(&bits, &single, sizeof(bits));
+
+        mBuffer += static_cast<char>(cMajorSimple << 5 | cInfoUInt32);
+
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            mBuffer += static_cast<char>(bits >> shift);
+        }
+    } else {
+        uint64_t bits {};
+
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        mBuffer += static_cast<char>(cMajorSimple << 5 | cInfoUInt64);
+
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            mBuffer += static_cast<char>(bits >> shift);
+        }
+    }
+
+    FlushIfFull();
+
+    return *this;
+}
+
+void CborEncoder::WriteHead(uint8_t major, uint64_t arg)
+{
+    const auto type = static_cast<uint8_t>(major << 5);
+    int        size = 0;
+
+    if (arg < cInfoUInt8) {
+        mBuffer += static_cast<char>(type | arg);
+
+        return;
+    }
+
+    if (arg <= 0xff) {
+        mBuffer += static_cast<char>(type | cInfoUInt8);
+        size = 1;
+    } else if (arg <= 0xffff) {
+        mBuffer += static_cast<char>(type | cInfoUInt16);
+        size = 2;
+    } else if (arg <= 0xffffffff) {
+        mBuffer += static_cast<char>(type | cInfoUInt32);
+        size = 4;
+    } else {
+        mBuffer += static_cast<char>(type | cInfoUInt64);
+        size = 8;
+    }
+
+    for (int shift = (size - 1) * 8; shift >= 0; shift -= 8) {
+        mBuffer += static_cast<char>(arg >> shift);
+    }
+}
+
+void CborEncoder::FlushIfFull()
+{
+    if (mFlush && mBuffer.size() >= mBufferSize) {
+        Flush();
+    }
+}
+
+void CborEncoder::SetError(const Error& err)
+{
+    if (mError.IsNone()) {
+        mError = err;
+    }
+}
+
+/***********************************************************************************************************************
+ * CborDecoder
+ **********************************************************************************************************************/
+
+CborDecoder::CborDecoder(std::string_view data)
+    : mData(data)
+{
+}
+
+CborDecoder::CborDecoder(std::istream& in, size_t bufferSize)
+    : mIn(&in)
+    , mBuffer(bufferSize, '\0')
+{
+}
+
+Error CborDecoder::Next(Poco::Dynamic::Var& value)
+{
+    uint8_t byte {};
+
+    if (auto err = Peek(byte); !err.IsNone()) {
+        return err;
+    }
+
+    return Decode(value, 0);
+}
+
+Error CborDecoder::Decode(Poco::Dynamic::Var& value, size_t depth)
+{
+    if (depth > cMaxDepth) {
+        return Error(ErrorEnum::eInvalidArgument, "max depth exceeded");
+    }
+
+    uint8_t  major {}, info {};
+    uint64_t arg {};
+
+    if (auto err = DecodeHead(major, info, arg); !err.IsNone()) {
+        return err;
+    }
+
+    switch (major) {
+    case cMajorUInt:
+        if (arg <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            value = static_cast<Poco::Int64>(arg);
+        } else {
+            value = static_cast<Poco::UInt64>(arg);
+        }
+
+        return ErrorEnum::eNone;
+
+    case cMajorNegInt:
+        if (arg > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            return Error(ErrorEnum::eOutOfRange, "negative integer is out of range");
+        }
+
+        value = static_cast<Poco::Int64>(-1 - static_cast<int64_t>(arg));
+
+        return ErrorEnum::eNone;
+
+    case cMajorBytes:
+    case cMajorText: {
+        std::string str;
+
+        if (auto err = DecodeString(major, info, arg, str); !err.IsNone()) {
+            return err;
+        }
+
+        value = std::move(str);
+
+        return ErrorEnum::eNone;
+    }
+
+    case cMajorArray:
+        return DecodeArray(info, arg, value, depth);
+
+    case cMajorMap:
+        return DecodeObject(info, arg, value, depth);
+
+    case cMajorTag:
+        if (info == cInfoIndefinite) {
+            return Error(ErrorEnum::eInvalidArgument, "invalid tag");
+        }
+
+        return Decode(value, depth + 1);
+
+    default:
+        return DecodeSimple(info, arg, value);
+    }
+}
+
+Error CborDecoder::DecodeHead(uint8_t& major, uint8_t& info, uint64_t& arg)
+{
+    uint8_t byte {};
+
+    if (auto err = Read(&byte, 1); !err.IsNone()) {
+        return err;
+    }
+
+    major = byte >> 5;
+    info  = byte & 0x1f;
+    arg   = info;
+
+    if (info < cInfoUInt8) {
+        return ErrorEnum::eNone;
+    }
+
+    if (info == cInfoIndefinite) {
+        if (major == cMajorUInt || major == cMajorNegInt || major == cMajorTag) {
+            return Error(ErrorEnum::eInvalidArgument, "invalid indefinite length");
+        }
+
+        arg = 0;
+
+        return ErrorEnum::eNone;
+    }
+
+    if (info > cInfoUInt64) {
+        return Error(ErrorEnum::eInvalidArgument, "invalid additional info");
+    }
+
+    const size_t size = size_t(1) << (info - cInfoUInt8);
+    uint8_t      bytes[sizeof(uint64_t)] {};
+
+    if (auto err = Read(bytes, size); !err.IsNone()) {
+        return err;
+    }
+
+    arg = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        arg = arg << 8 | bytes[i];
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error CborDecoder::DecodeString(uint8_t major, uint8_t info, uint64_t length, std::string& str)
+{
+    auto append = [this, &str](uint64_t size) -> Error {
+        while (size > 0) {
+            const auto chunk  = static_cast<size_t>(std::min<uint64_t>(size, cReadChunkSize));
+            const auto offset = str.size();
+
+            str.resize(offset + chunk);
+
+            if (auto err = Read(str.data() + offset, chunk); !err.IsNone()) {
+                return err;
+            }
+
+            size -= chunk;
+        }
+
+        return ErrorEnum::eNone;
+    };
+
+    if (info != cInfoIndefinite) {
+        return append(length);
+    }
+
+    for (;;) {
+        uint8_t byte {};
+
+        if (!Peek(byte).IsNone()) {
+            return Error(ErrorEnum::eInvalidArgument, "unexpected end of data");
+        }
+
+        if (byte == cBreak) {
+            return Read(&byte, 1);
+        }
+
+        uint8_t  chunkMajor {}, chunkInfo {};
+        uint64_t chunkLength {};
+
+        if (auto err = DecodeHead(chunkMajor, chunkInfo, chunkLength); !err.IsNone()) {
+            return err;
+        }
+
+        if (chunkMajor != major || chunkInfo == cInfoIndefinite) {
+            return Error(ErrorEnum::eInvalidArgument, "invalid string chunk");
+        }
+
+        if (auto err = append(chunkLength); !err.IsNone()) {
+            return err;
+        }
+    }
+}
+
+Error CborDecoder::DecodeObject(uint8_t info, uint64_t size, Poco::Dynamic::Var& value, size_t depth)
+{
+    Poco::JSON::Object::Ptr object = new Poco::JSON::Object();
+
+    for (uint64_t i = 0; info == cInfoIndefinite || i < size; i++) {
+        uint8_t byte {};
+
+        if (!Peek(byte).IsNone()) {
+            return Error(ErrorEnum::eInvalidArgument, "unexpected end of data");
+        }
+
+        if (info == cInfoIndefinite && byte == cBreak) {
+            Read(&byte, 1);
+
+            break;
+        }
+
+        uint8_t     keyMajor {}, keyInfo {};
+        uint64_t    keyLength {};
+        std::string key;
+
+        if (auto err = DecodeHead(keyMajor, keyInfo, keyLength); !err.IsNone()) {
+            return err;
+        }
+
+        if (keyMajor != cMajorText && keyMajor != cMajorBytes) {
+            return Error(ErrorEnum::eInvalidArgument, "map key is not string");
+        }
+
+        if (auto err = DecodeString(keyMajor, keyInfo, keyLength, key); !err.IsNone()) {
+            return err;
+        }
+
+        Poco::Dynamic::Var member;
+
+        if (auto err = Decode(member, depth + 1); !err.IsNone()) {
+            return err;
+        }
+
+        object->set(key, member);
+    }
+
+    value = object;
+
+    return ErrorEnum::eNone;
+}
+
+Error CborDecoder::DecodeArray(uint8_t info, uint64_t size, Poco::Dynamic::Var& value, size_t depth)
+{
+    Poco::JSON::Array::Ptr array = new Poco::JSON::Array();
+
+    for (uint64_t i = 0; info == cInfoIndefinite || i < size; i++) {
+        uint8_t byte {};
+
+        if (!Peek(byte).IsNone()) {
+            return Error(ErrorEnum::eInvalidArgument, "unexpected end of data");
+        }
+
+        if (info == cInfoIndefinite && byte == cBreak) {
+            Read(&byte, 1);
+
+            break;
+        }
+
+        Poco::Dynamic::Var item;
+
+        if (auto err = Decode(item, depth + 1); !err.IsNone()) {
+            return err;
+        }
+
+        array->add(item);
+    }
+
+    value = array;
+
+    return ErrorEnum::eNone;
+}
+
+Error CborDecoder::DecodeSimple(uint8_t info, uint64_t arg, Poco::Dynamic::Var& value)
+{
+    switch (info) {
+    case cInfoFalse:
+        value = false;
+        break;
+
+    case cInfoTrue:
+        value = true;
+        break;
+
+    case cInfoNull:
+    case cInfoUndefined:
+        value.clear();
+        break;
+
+    case cInfoUInt16:
+        value = DecodeHalf(static_cast<uint16_t>(arg));
+        break;
+
+    case cInfoUInt32: {
+        const auto bits = static_cast<uint32_t>(arg);
+        float      single {};
+
+        std::memcpy(&single, &bits, sizeof(single));
+
+        value = static_cast<double>(single);
+        break;
+    }
+
+    case cInfoUInt64: {
+        double result {};
+
+        std::memcpy(&result, &arg, sizeof(result));
+
+        value = result;
+        break;
+    }
+
+    case cInfoIndefinite:
+        return Error(ErrorEnum::eInvalidArgument, "unexpected break");
+
+    default:
+        return Error(ErrorEnum::eInvalidArgument, "unsupported simple value");
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error CborDecoder::Read(void* data, size_t size)
+{
+    auto* dst = static_cast<uint8_t*>(data);
+
+    while (size > 0) {
+        if (mPos == mData.size() && !Fill()) {
+            return Error(ErrorEnum::eInvalidArgument, "unexpected end of data");
+        }
+
+        const auto chunk = std::min(size, mData.size() - mPos);
+
+        std::memcpy(dst, mData.data() + mPos, chunk);
+
+        dst += chunk;
+        mPos += chunk;
+        size -= chunk;
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error CborDecoder::Peek(uint8_t& byte)
+{
+    if (mPos == mData.size() && !Fill()) {
+        return ErrorEnum::eNotFound;
+    }
+
+    byte = static_cast<uint8_t>(mData[mPos]);
+
+    return ErrorEnum::eNone;
+}
+
+bool CborDecoder::Fill()
+{
+    if (mIn == nullptr || mBuffer.empty()) {
+        return false;
+    }
+
+    mIn->read(mBuffer.data(), mBuffer.size());
+
+    const auto size = static_cast<size_t>(mIn->gcount());
+
+    if (size == 0) {
+        return false;
+    }
+
+    mData = std::string_view(mBuffer.data(), size);
+    mPos  = 0;
+
+    return true;
+}
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+RetWithError<std::string> EncodeCbor(const Poco::Dynamic::Var& value)
+{
+    CborEncoder encoder;
+
+    try {
+        encoder.Value(value);
+    } catch (const std::exception& e) {
+        return {{}, Error(ErrorEnum::eFailed, e.what())};
+    }
+
+    if (!encoder.GetError().IsNone()) {
+        return {{}, encoder.GetError()};
+    }
+
+    return encoder.TakeString();
+}
+
+RetWithError<Poco::Dynamic::Var> DecodeCbor(std::string_view data)
+{
+    CborDecoder        decoder(data);
+    Poco::Dynamic::Var value;
+
+    if (auto err = decoder.Next(value); !err.IsNone()) {
+        return {{}, err.Is(ErrorEnum::eNotFound) ? Error(ErrorEnum::eInvalidArgument, "empty data") : err};
+    }
+
+    if (Poco::Dynamic::Var excess; !decoder.Next(excess).Is(ErrorEnum::eNotFound)) {
+        return {{}, Error(ErrorEnum::eInvalidArgument, "excess data found after data item")};
+    }
+
+    return value;
+}
+
+Error WriteCborToFile(const Poco::JSON::Object::Ptr& object, const std::string& path, bool sync)
+{
+    AtomicFile file;
+
+    if (auto err = file.Open(path); !err.IsNone()) {
+        return err;
+    }
+
+    CborEncoder encoder([&file](std::string_view data) { return file.Write(data); });
+
+    try {
+        encoder.Value(Poco::Dynamic::Var(object));
+    } catch (const std::exception& e) {
+        return Error(ErrorEnum::eFailed, e.what());
+    }
+
+    if (auto err = encoder.Flush(); !err.IsNone()) {
+        return err;
+    }
+
+    return file.Commit(sync);
+}
+
+RetWithError<Poco::Dynamic::Var> ParseCborFile(const std::string& path)
+{
+    auto [data, err] = ReadFileData(path);
+    if (!err.IsNone()) {
+        return {{}, err};
+    }
+
+    return DecodeCbor(data);
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <zlib.h>
+#include <zstd.h>
+#include <zstd_errors.h>
+
+#include "utils/decompressor.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr size_t cInputSize = 1024 * 1024;
+
+// Decompressed chunks buffered ahead of the consumer for gzip.
+constexpr size_t cGzipQueueSize = 8;
+
+// Max window and gzip header detection.
+constexpr int cGzipWindowBits = 15 + 16;
+
+// Max zstd frame header size (ZSTD_FRAMEHEADERSIZE_MAX).
+constexpr size_t cZstdFrameHeaderSize = 18;
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+template <typename T>
+std::shared_future<T> MakeReady(T value)
+{
+    std::promise<T> promise;
+
+    promise.set_value(std::move(value));
+
+    return promise.get_future().share();
+}
+
+// Compressed data buffer: unconsumed data is in [mStart, mEnd).
+struct InputBuffer {
+    std::vector<char> mData = std::vector<char>(cInputSize);
+    size_t            mStart {};
+    size_t            mEnd {};
+    bool              mEOF {};
+
+    const char* Data() const { return mData.data() + mStart; }
+    size_t      Size() const { return mEnd - mStart; }
+
+    // Reads more source data keeping unconsumed data.
+    Error Fill(const Decompressor::ReadFunc& source)
+    {
+        if (mStart > 0) {
+            memmove(mData.data(), mData.data() + mStart, Size());
+
+            mEnd -= mStart;
+            mStart = 0;
+        }
+
+        if (mEnd == mData.size()) {
+            mData.resize(mData.size() * 2);
+        }
+
+        auto [count, err] = source(mData.data() + mEnd, mData.size() - mEnd);
+        if (!err.IsNone()) {
+            return err;
+        }
+
+        mEnd += count;
+        mEOF = count == 0;
+
+        return ErrorEnum::eNone;
+    }
+};
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+CompressionType DetectCompression(std::string_view header)
+{
+    const auto hasPrefix = [header](std::string_view magic) { return header.substr(0, magic.size()) == magic; };
+
+    if (hasPrefix(std::string_view("\x1f\x8b", 2))) {
+        return CompressionType::eGzip;
+    }
+
+    if (hasPrefix("BZh")) {
+        return CompressionType::eBzip2;
+    }
+
+    if (hasPrefix(std::string_view("\xfd" "7zXZ\0", 6))) {
+        return CompressionType::eXz;
+    }
+
+    if (hasPrefix("\x28\xb5\x2f\xfd")) {
+        return CompressionType::eZstd;
+    }
+
+    return CompressionType::eNone;
+}
+
+/***********************************************************************************************************************
+ * Decompressor
+ **********************************************************************************************************************/
+
+Decompressor::~Decompressor()
+{
+    Close();
+}
+
+Error Decompressor::Open(CompressionType type, ReadFunc source, size_t threads)
+{
+    if (mThread.joinable()) {
+        return Error(ErrorEnum::eWrongState, "Decompressor is already opened");
+    }
+
+    if (type != CompressionType::eGzip && type != CompressionType::eZstd) {
+        return Error(ErrorEnum::eNotSupported, "Unsupported compression");
+    }
+
+    mSource  = std::move(source);
+    mThreads = threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+    mCurrent = {};
+    mOffset  = 0;
+    mEnded   = false;
+
+    if (type == CompressionType::eGzip) {
+        mChunks = std::make_unique<Channel<ChunkFuture>>(cGzipQueueSize);
+        mThread = std::thread(&Decompressor::DecompressGzip, this);
+    } else {
+        // Channel capacity limits the number of frames decompressed in parallel.
+        mChunks = std::make_unique<Channel<ChunkFuture>>(mThreads);
+        mThread = std::thread(&Decompressor::DecompressZstd, this);
+    }
+
+    return ErrorEnum::eNone;
+}
+
+RetWithError<size_t> Decompressor::Read(char* data, size_t size)
+{
+    while (mOffset == mCurrent.mData.size()) {
+        if (!mCurrent.mError.IsNone()) {
+            return {0, mCurrent.mError};
+        }
+
+        if (mEnded || !mChunks) {
+            return 0;
+        }
+
+        auto [chunk, err] = mChunks->Receive();
+        if (!err.IsNone()) {
+            return {0, err};
+        }
+
+        mCurrent = chunk.get();
+        mOffset  = 0;
+
+        // Empty chunk marks the end of data.
+        mEnded = mCurrent.mData.empty();
+    }
+
+    const auto count = std::min(size, mCurrent.mData.size() - mOffset);
+
+    memcpy(data, mCurrent.mData.data() + mOffset, count);
+    mOffset += count;
+
+    return count;
+}
+
+void Decompressor::Close()
+{
+    if (mChunks) {
+        mChunks->Close();
+    }
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+
+    // Pending frame futures wait for their tasks on destruction.
+    mChunks.reset();
+
+    mCurrent = {};
+    mOffset  = 0;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+bool Decompressor::Send(Chunk chunk)
+{
+    return mChunks->Send(MakeReady(std::move(chunk))).IsNone();
+}
+
+bool Decompressor::SendEnd(const Error& err)
+{
+    return Send({"", err});
+}
+
+void Decompressor::DecompressGzip()
+{
+    z_stream stream {};
+
+    if (inflateInit2(&stream, cGzipWindowBits) != Z_OK) {
+        SendEnd(Error(ErrorEnum::eFailed, "Can't initialize gzip decompression"));
+
+        return;
+    }
+
+    std::vector<unsigned char> input(cInputSize);
+    std::string                output(cChunkSize, '\0');
+    bool                       memberEnded = false;
+    Error                      err;
+
+    stream.next_out  = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    while (true) {
+        if (stream.avail_in == 0) {
+            size_t count = 0;
+
+            if (Tie(count, err) = mSource(reinterpret_cast<char*>(input.data()), input.size()); !err.IsNone()) {
+                break;
+            }
+
+            if (count == 0) {
+                if (!memberEnded) {
+                    err = Error(ErrorEnum::eFailed, "Unexpected end of gzip data");
+                }
+
+                break;
+            }
+
+            stream.next_in  = input.data();
+            stream.avail_in = static_cast<uInt>(count);
+        }
+
+        // Concatenated gzip members are decompressed as one stream, other trailing data is ignored.
+        if (memberEnded) {
+            if (stream.next_in[0] != 0x1f) {
+                break;
+            }
+
+            inflateReset(&stream);
+            memberEnded = false;
+        }
+
+        const auto ret = inflate(&stream, Z_NO_FLUSH);
+
+        if (ret == Z_STREAM_END) {
+            memberEnded = true;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            err = Error(ErrorEnum::eFailed, stream.msg != nullptr ? stream.msg : "Gzip decompression failed");
+
+            break;
+        }
+
+        if (stream.avail_out == 0) {
+            if (!Send({std::move(output), ErrorEnum::eNone})) {
+                inflateEnd(&stream);
+
+                return;
+            }
+
+            output.assign(cChunkSize, '\0');
+
+            stream.next_out  = reinterpret_cast<Bytef*>(output.data());
+            stream.avail_out = static_cast<uInt>(output.size());
+        }
+    }
+
+    output.resize(output.size() - stream.avail_out);
+
+    inflateEnd(&stream);
+
+    if (!output.empty() && !Send({std::move(output), ErrorEnum::eNone})) {
+        return;
+    }
+
+    SendEnd(err);
+}
+
+void Decompressor::DecompressZstd()
+{
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+    InputBuffer                                          input;
+    Error                                                err;
+
+    if (!context) {
+        SendEnd(Error(ErrorEnum::eNoMemory, "Can't create zstd context"));
+
+        return;
+    }
+
+    while (err.IsNone()) {
+        // Frame header is needed to choose between parallel and stream decompression.
+        while (input.Size() < cZstdFrameHeaderSize && !input.mEOF && err.IsNone()) {
+            err = input.Fill(mSource);
+        }
+
+        if (!err.IsNone() || input.Size() == 0) {
+            break;
+        }
+
+        const auto contentSize = ZSTD_getFrameContentSize(input.Data(), input.Size());
+
+        if (contentSize == ZSTD_CONTENTSIZE_ERROR) {
+            err = Error(ErrorEnum::eFailed, "Invalid zstd frame");
+
+            break;
+        }
+
+        // Small frame: read it completely and decompress on a separate thread.
+        if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize <= cMaxParallelFrameSize) {
+            size_t frameSize = 0;
+
+            while (true) {
+                frameSize = ZSTD_findFrameCompressedSize(input.Data(), input.Size());
+
+                if (!ZSTD_isError(frameSize) || ZSTD_getErrorCode(frameSize) != ZSTD_error_srcSize_wrong
+                    || input.mEOF) {
+                    break;
+                }
+
+                if (err = input.Fill(mSource); !err.IsNone()) {
+                    break;
+                }
+            }
+
+            if (!err.IsNone()) {
+                break;
+            }
+
+            if (ZSTD_isError(frameSize)) {
+                err = Error(ErrorEnum::eFailed, ZSTD_getErrorName(frameSize));
+
+                break;
+            }
+
+            auto frame = std::make_shared<std::string>(input.Data(), frameSize);
+
+            input.mStart += frameSize;
+
+            // Skippable frames have no content.
+            if (contentSize == 0) {
+                continue;
+            }
+
+            auto future = std::async(std::launch::async, [frame, contentSize]() {
+                Chunk chunk {std::string(contentSize, '\0'), ErrorEnum::eNone};
+
+                const auto size = ZSTD_decompress(chunk.mData.data(), chunk.mData.size(), frame->data(), frame->size());
+                if (ZSTD_isError(size)) {
+                    chunk.mError = Error(ErrorEnum::eFailed, ZSTD_getErrorName(size));
+                } else if (size != contentSize) {
+                    chunk.mError = Error(ErrorEnum::eFailed, "Zstd frame content size mismatch");
+                }
+
+                return chunk;
+            });
+
+            if (!mChunks->Send(future.share()).IsNone()) {
+                return;
+            }
+
+            continue;
+        }
+
+        // Big frame or frame without content size: decompress as a stream.
+        ZSTD_DCtx_reset(context.get(), ZSTD_reset_session_only);
+
+        std::string output(cChunkSize, '\0');
+        size_t      outputSize = 0;
+
+        while (true) {
+            ZSTD_inBuffer  in {input.Data(), input.Size(), 0};
+            ZSTD_outBuffer out {output.data(), output.size(), outputSize};
+
+            const auto ret = ZSTD_decompressStream(context.get(), &out, &in);
+            if (ZSTD_isError(ret)) {
+                err = Error(ErrorEnum::eFailed, ZSTD_getErrorName(ret));
+
+                break;
+            }
+
+            input.mStart += in.pos;
+            outputSize = out.pos;
+
+            if (outputSize == output.size() || (ret == 0 && outputSize > 0)) {
+                output.resize(outputSize);
+
+                if (!Send({std::move(output), ErrorEnum::eNone})) {
+                    return;
+                }
+
+                output.assign(cChunkSize, '\0');
+                outputSize = 0;
+            }
+
+            // Frame is decoded and flushed.
+            if (ret == 0) {
+                break;
+            }
+
+            if (in.pos == in.size) {
+                if (input.mEOF) {
+                    err = Error(ErrorEnum::eFailed, "Unexpected end of zstd data");
+
+                    break;
+                }
+
+                err = input.Fill(mSource);
+                if (!err.IsNone()) {
+                    break;
+                }
+            }
+        }
+    }
+
+    SendEnd(err);
+}
+
+} // namespace aos::common::utils
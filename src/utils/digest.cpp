@@ -0,0 +1,556 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <endian.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define AOS_SHA_NI 1
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+
+#define AOS_ARMV8_CE 1
+#endif
+
+#include "utils/digest.hpp"
+
+#if defined(AOS_SHA_NI)
+#define AOS_TARGET_SHA_NI __attribute__((target("sha,sse4.1,ssse3")))
+#elif defined(AOS_ARMV8_CE) && defined(__clang__)
+#define AOS_TARGET_ARMV8_CE __attribute__((target("crypto")))
+#elif defined(AOS_ARMV8_CE)
+#define AOS_TARGET_ARMV8_CE __attribute__((target("+crypto")))
+#endif
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+alignas(16) constexpr uint32_t cK256[64] = {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
+    0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85,
+    0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c,
+    0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr uint64_t cK512[80] = {0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+    0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+    0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2, 0x72be5d74f27b896f, 0x80deb1fe3b1696b1,
+    0x9bdc06a725c71235, 0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5,
+    0x240ca1cc77ac9c65, 0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2,
+    0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc, 0x2e1b21385c26c926,
+    0x4d2c6dfc5ac42aed, 0x53380d139d95b3df, 0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+    0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+    0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8, 0x19a4c116b8d2d0c8,
+    0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+    0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72,
+    0x8cc702081a6439ec, 0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+    0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+    0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b, 0x28db77f523047d84, 0x32caab7b40c72493,
+    0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec,
+    0x6c44198c4a475817};
+
+constexpr uint32_t cInit256[8]
+    = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+constexpr uint64_t cInit384[8] = {0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+    0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4};
+
+constexpr uint64_t cInit512[8] = {0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+    0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+constexpr char cHexDigits[] = "0123456789abcdef";
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+uint32_t RotateRight(uint32_t value, int count)
+{
+    return (value >> count) | (value << (32 - count));
+}
+
+uint64_t RotateRight(uint64_t value, int count)
+{
+    return (value >> count) | (value << (64 - count));
+}
+
+uint32_t LoadBigEndian32(const uint8_t* data)
+{
+    uint32_t value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return be32toh(value);
+}
+
+uint64_t LoadBigEndian64(const uint8_t* data)
+{
+    uint64_t value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return be64toh(value);
+}
+
+template <typename T>
+void StoreBigEndian(T value, uint8_t* data)
+{
+    for (size_t i = 0; i < sizeof(T); i++) {
+        data[i] = static_cast<uint8_t>(value >> (8 * (sizeof(T) - 1 - i)));
+    }
+}
+
+void CompressPortable256(void* state, const uint8_t* blocks, size_t count)
+{
+    auto h = static_cast<uint32_t*>(state);
+
+    for (; count > 0; count--, blocks += 64) {
+        uint32_t w[64];
+
+        for (size_t i = 0; i < 16; i++) {
+            w[i] = LoadBigEndian32(blocks + i * 4);
+        }
+
+        for (size_t i = 16; i < 64; i++) {
+            const auto s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const auto s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+
+        for (size_t i = 0; i < 64; i++) {
+            const auto t1 = k + (RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25)) + ((e & f) ^ (~e & g))
+                + cK256[i] + w[i];
+            const auto t2
+                = (RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+
+            k = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+        h[5] += f;
+        h[6] += g;
+        h[7] += k;
+    }
+}
+
+void CompressPortable512(void* state, const uint8_t* blocks, size_t count)
+{
+    auto h = static_cast<uint64_t*>(state);
+
+    for (; count > 0; count--, blocks += 128) {
+        uint64_t w[80];
+
+        for (size_t i = 0; i < 16; i++) {
+            w[i] = LoadBigEndian64(blocks + i * 8);
+        }
+
+        for (size_t i = 16; i < 80; i++) {
+            const auto s0 = RotateRight(w[i - 15], 1) ^ RotateRight(w[i - 15], 8) ^ (w[i - 15] >> 7);
+            const auto s1 = RotateRight(w[i - 2], 19) ^ RotateRight(w[i - 2], 61) ^ (w[i - 2] >> 6);
+
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint64_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+
+        for (size_t i = 0; i < 80; i++) {
+            const auto t1 = k + (RotateRight(e, 14) ^ RotateRight(e, 18) ^ RotateRight(e, 41)) + ((e & f) ^ (~e & g))
+                + cK512[i] + w[i];
+            const auto t2
+                = (RotateRight(a, 28) ^ RotateRight(a, 34) ^ RotateRight(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+
+            k = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+        h[5] += f;
+        h[6] += g;
+        h[7] += k;
+    }
+}
+
+#if defined(AOS_SHA_NI)
+
+// Four rounds: the low half of msg is used by the first two rounds, the high half by the next two ones.
+AOS_TARGET_SHA_NI inline void RoundsSHANI(__m128i& abef, __m128i& cdgh, __m128i msg, size_t group)
+{
+    msg  = _mm_add_epi32(msg, _mm_load_si128(reinterpret_cast<const __m128i*>(&cK256[group * 4])));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0e));
+}
+
+// Next four message words from the previous sixteen ones: w0 is the oldest group, w3 is the latest one.
+AOS_TARGET_SHA_NI inline __m128i ScheduleSHANI(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    return _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4)), w3);
+}
+
+AOS_TARGET_SHA_NI void CompressSHANI256(void* state, const uint8_t* blocks, size_t count)
+{
+    const auto h        = static_cast<uint32_t*>(state);
+    const auto swapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // SHA instructions keep the state as ABEF and CDGH word pairs.
+    auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&h[0])), 0xb1);
+    auto hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&h[4])), 0x1b);
+    auto abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    auto cdgh = _mm_blend_epi16(hgfe, dcba, 0xf0);
+
+    for (; count > 0; count--, blocks += 64) {
+        const auto savedABEF = abef;
+        const auto savedCDGH = cdgh;
+
+        auto w0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks)), swapMask);
+        auto w1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16)), swapMask);
+        auto w2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 32)), swapMask);
+        auto w3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 48)), swapMask);
+
+        RoundsSHANI(abef, cdgh, w0, 0);
+        RoundsSHANI(abef, cdgh, w1, 1);
+        RoundsSHANI(abef, cdgh, w2, 2);
+        RoundsSHANI(abef, cdgh, w3, 3);
+
+        for (size_t group = 4; group < 16; group += 4) {
+            w0 = ScheduleSHANI(w0, w1, w2, w3);
+            RoundsSHANI(abef, cdgh, w0, group);
+            w1 = ScheduleSHANI(w1, w2, w3, w0);
+            RoundsSHANI(abef, cdgh, w1, group + 1);
+            w2 = ScheduleSHANI(w2, w3, w0, w1);
+            RoundsSHANI(abef, cdgh, w2, group + 2);
+            w3 = ScheduleSHANI(w3, w0, w1, w2);
+            RoundsSHANI(abef, cdgh, w3, group + 3);
+        }
+
+        abef = _mm_add_epi32(abef, savedABEF);
+        cdgh = _mm_add_epi32(cdgh, savedCDGH);
+    }
+
+    const auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    const auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&h[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&h[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+bool HasSHANI()
+{
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1)) {
+        return false;
+    }
+
+    return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
+}
+
+#endif
+
+#if defined(AOS_ARMV8_CE)
+
+AOS_TARGET_ARMV8_CE inline void RoundsARMv8(uint32x4_t& abcd, uint32x4_t& efgh, uint32x4_t msg, size_t group)
+{
+    const auto saved = abcd;
+
+    msg  = vaddq_u32(msg, vld1q_u32(&cK256[group * 4]));
+    abcd = vsha256hq_u32(abcd, efgh, msg);
+    efgh = vsha256h2q_u32(efgh, saved, msg);
+}
+
+AOS_TARGET_ARMV8_CE inline uint32x4_t ScheduleARMv8(uint32x4_t w0, uint32x4_t w1, uint32x4_t w2, uint32x4_t w3)
+{
+    return vsha256su1q_u32(vsha256su0q_u32(w0, w1), w2, w3);
+}
+
+AOS_TARGET_ARMV8_CE void CompressARMv8256(void* state, const uint8_t* blocks, size_t count)
+{
+    const auto h = static_cast<uint32_t*>(state);
+
+    auto abcd = vld1q_u32(&h[0]);
+    auto efgh = vld1q_u32(&h[4]);
+
+    for (; count > 0; count--, blocks += 64) {
+        const auto savedABCD = abcd;
+        const auto savedEFGH = efgh;
+
+        auto w0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks)));
+        auto w1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 16)));
+        auto w2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 32)));
+        auto w3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 48)));
+
+        RoundsARMv8(abcd, efgh, w0, 0);
+        RoundsARMv8(abcd, efgh, w1, 1);
+        RoundsARMv8(abcd, efgh, w2, 2);
+        RoundsARMv8(abcd, efgh, w3, 3);
+
+        for (size_t group = 4; group < 16; group += 4) {
+            w0 = ScheduleARMv8(w0, w1, w2, w3);
+            RoundsARMv8(abcd, efgh, w0, group);
+            w1 = ScheduleARMv8(w1, w2, w3, w0);
+            RoundsARMv8(abcd, efgh, w1, group + 1);
+            w2 = ScheduleARMv8(w2, w3, w0, w1);
+            RoundsARMv8(abcd, efgh, w2, group + 2);
+            w3 = ScheduleARMv8(w3, w0, w1, w2);
+            RoundsARMv8(abcd, efgh, w3, group + 3);
+        }
+
+        abcd = vaddq_u32(abcd, savedABCD);
+        efgh = vaddq_u32(efgh, savedEFGH);
+    }
+
+    vst1q_u32(&h[0], abcd);
+    vst1q_u32(&h[4], efgh);
+}
+
+bool HasARMv8CE()
+{
+    return getauxval(AT_HWCAP) & HWCAP_SHA2;
+}
+
+#endif
+
+struct Kernel {
+    void (*mCompress)(void* state, const uint8_t* blocks, size_t count);
+    const char* mName;
+};
+
+// SHA extensions on x86 and ARMv8.0 cryptography extensions accelerate SHA-256 only.
+Kernel SelectKernel256()
+{
+#if defined(AOS_SHA_NI)
+    if (HasSHANI()) {
+        return {CompressSHANI256, "sha-ni"};
+    }
+#elif defined(AOS_ARMV8_CE)
+    if (HasARMv8CE()) {
+        return {CompressARMv8256, "armv8-ce"};
+    }
+#endif
+
+    return {CompressPortable256, "portable"};
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+RetWithError<HashAlgorithm> ParseHashAlgorithm(std::string_view name)
+{
+    if (name == "sha256") {
+        return HashAlgorithm::eSHA256;
+    }
+
+    if (name == "sha384") {
+        return HashAlgorithm::eSHA384;
+    }
+
+    if (name == "sha512") {
+        return HashAlgorithm::eSHA512;
+    }
+
+    return {HashAlgorithm::eSHA256, Error(ErrorEnum::eNotSupported, "Unsupported algorithm")};
+}
+
+const char* GetHashAlgorithmName(HashAlgorithm algorithm)
+{
+    switch (algorithm) {
+    case HashAlgorithm::eSHA384:
+        return "sha384";
+
+    case HashAlgorithm::eSHA512:
+        return "sha512";
+
+    default:
+        return "sha256";
+    }
+}
+
+/***********************************************************************************************************************
+ * Hasher
+ **********************************************************************************************************************/
+
+Hasher::Hasher(HashAlgorithm algorithm, bool portable)
+    : mAlgorithm(algorithm)
+{
+    // CPU features are detected once.
+    static const auto sKernel256 = SelectKernel256();
+
+    if (mAlgorithm != HashAlgorithm::eSHA256) {
+        mCompress   = CompressPortable512;
+        mKernelName = "portable";
+        mBlockSize  = 128;
+    } else if (portable) {
+        mCompress   = CompressPortable256;
+        mKernelName = "portable";
+        mBlockSize  = 64;
+    } else {
+        mCompress   = sKernel256.mCompress;
+        mKernelName = sKernel256.mName;
+        mBlockSize  = 64;
+    }
+
+    Reset();
+}
+
+void Hasher::Update(const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+
+    mLength += size;
+
+    if (mBuffered > 0) {
+        const auto count = std::min(size, mBlockSize - mBuffered);
+
+        memcpy(mBuffer + mBuffered, bytes, count);
+
+        mBuffered += count;
+        bytes += count;
+        size -= count;
+
+        if (mBuffered < mBlockSize) {
+            return;
+        }
+
+        mCompress(&mState, mBuffer, 1);
+        mBuffered = 0;
+    }
+
+    // Whole blocks are hashed directly from the caller data.
+    if (const auto blocks = size / mBlockSize; blocks > 0) {
+        mCompress(&mState, bytes, blocks);
+
+        bytes += blocks * mBlockSize;
+        size -= blocks * mBlockSize;
+    }
+
+    memcpy(mBuffer, bytes, size);
+    mBuffered = size;
+}
+
+std::string Hasher::Finish()
+{
+    // Padding: 0x80, zeros and message length in bits, 64-bit for SHA-256 and 128-bit for SHA-384/512.
+    const auto lengthSize = mBlockSize / 8;
+
+    mBuffer[mBuffered++] = 0x80;
+
+    if (mBuffered > mBlockSize - lengthSize) {
+        memset(mBuffer + mBuffered, 0, mBlockSize - mBuffered);
+        mCompress(&mState, mBuffer, 1);
+        mBuffered = 0;
+    }
+
+    memset(mBuffer + mBuffered, 0, mBlockSize - mBuffered);
+
+    if (lengthSize == 16) {
+        StoreBigEndian<uint64_t>(mLength >> 61, mBuffer + mBlockSize - 16);
+    }
+
+    StoreBigEndian<uint64_t>(mLength << 3, mBuffer + mBlockSize - 8);
+    mCompress(&mState, mBuffer, 1);
+
+    uint8_t digest[cMaxDigestSize];
+    size_t  digestSize = 0;
+
+    switch (mAlgorithm) {
+    case HashAlgorithm::eSHA256:
+        digestSize = 32;
+
+        for (size_t i = 0; i < 8; i++) {
+            StoreBigEndian(mState.m256[i], digest + i * 4);
+        }
+
+        break;
+
+    default:
+        digestSize = mAlgorithm == HashAlgorithm::eSHA384 ? 48 : 64;
+
+        for (size_t i = 0; i < 8; i++) {
+            StoreBigEndian(mState.m512[i], digest + i * 8);
+        }
+
+        break;
+    }
+
+    std::string hex(digestSize * 2, '\0');
+
+    for (size_t i = 0; i < digestSize; i++) {
+        hex[i * 2]     = cHexDigits[digest[i] >> 4];
+        hex[i * 2 + 1] = cHexDigits[digest[i] & 0x0f];
+    }
+
+    Reset();
+
+    return hex;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+void Hasher::Reset()
+{
+    mLength   = 0;
+    mBuffered = 0;
+
+    switch (mAlgorithm) {
+    case HashAlgorithm::eSHA256:
+        memcpy(mState.m256, cInit256, sizeof(cInit256));
+        break;
+
+    case HashAlgorithm::eSHA384:
+        memcpy(mState.m512, cInit384, sizeof(cInit384));
+        break;
+
+    case HashAlgorithm::eSHA512:
+        memcpy(mState.m512, cInit512, sizeof(cInit512));
+        break;
+    }
+}
+
+} // namespace aos::common::utils
@@ -5,12 +5,25 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <Poco/UUID.h>
 #include <Poco/UUIDGenerator.h>
 
@@ -20,6 +33,245 @@ namespace fs = std::filesystem;
 
 namespace aos::common::utils {
 
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr auto cMaxLinkAttempts = 16;
+
+constexpr size_t cCopyBufferSize = 1024 * 1024;
+constexpr size_t cCopyRangeSize  = 64 * 1024 * 1024;
+
+constexpr size_t cDirentBufferSize = 64 * 1024;
+constexpr size_t cReadChunkSize    = 4096;
+
+// Directory entry name and d_type.
+using DirEntries = std::vector<std::pair<std::string, unsigned char>>;
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+std::string GetParentDir(const std::string& path)
+{
+    auto dir = fs::path(path).parent_path().string();
+
+    return dir.empty() ? "." : dir;
+}
+
+// Temporary file name next to the target, unique within the process.
+std::string MakeTmpPath(const std::string& path)
+{
+    static std::atomic_uint sCounter {};
+
+    return path + "." + std::to_string(getpid()) + "." + std::to_string(sCounter++) + ".tmp";
+}
+
+Error SyncDir(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    Error err;
+
+    if (fsync(fd) != 0) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    close(fd);
+
+    return err;
+}
+
+// Errors returned when the filesystem or kernel doesn't support the copy method for these files.
+bool IsCopyNotSupported(int err)
+{
+    return err == EOPNOTSUPP || err == ENOTTY || err == ENOSYS || err == EXDEV || err == EINVAL || err == EBADF
+        || err == EPERM;
+}
+
+// Returns false if copy_file_range is not supported and nothing was copied.
+RetWithError<bool> CopyRange(int inFD, int outFD)
+{
+    loff_t inOffset  = 0;
+    loff_t outOffset = 0;
+
+    while (true) {
+        const auto count = copy_file_range(inFD, &inOffset, outFD, &outOffset, cCopyRangeSize, 0);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (count < 0 && inOffset == 0 && IsCopyNotSupported(errno)) {
+            return false;
+        }
+
+        if (count < 0) {
+            return {false, Error(ErrorEnum::eFailed, strerror(errno))};
+        }
+
+        if (count == 0) {
+            return true;
+        }
+    }
+}
+
+Error CopyReadWrite(int inFD, int outFD)
+{
+    std::vector<char> buffer(cCopyBufferSize);
+    off_t             offset = 0;
+
+    while (true) {
+        const auto count = pread(inFD, buffer.data(), buffer.size(), offset);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (count < 0) {
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+
+        if (count == 0) {
+            return ErrorEnum::eNone;
+        }
+
+        for (ssize_t written = 0; written < count;) {
+            const auto ret = pwrite(outFD, buffer.data() + written, count - written, offset + written);
+
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (ret < 0) {
+                return Error(ErrorEnum::eFailed, strerror(errno));
+            }
+
+            written += ret;
+        }
+
+        offset += count;
+    }
+}
+
+// Reads all entries of the directory sorted by name, "." and ".." are skipped.
+Error ReadDirEntries(int fd, std::vector<char>& buffer, DirEntries& entries)
+{
+    while (true) {
+        // Kernel fills the buffer with linux_dirent64 records which have the same layout as glibc dirent64.
+        const auto size = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+
+        if (size < 0) {
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+
+        if (size == 0) {
+            break;
+        }
+
+        for (long offset = 0; offset < size;) {
+            const auto entry = reinterpret_cast<const dirent64*>(buffer.data() + offset);
+
+            offset += entry->d_reclen;
+
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+                continue;
+            }
+
+            entries.emplace_back(entry->d_name, entry->d_type);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    return ErrorEnum::eNone;
+}
+
+// Returns DT_REG for regular files and symlinks to regular files, DT_DIR for directories and DT_UNKNOWN for entries
+// which are not walked.
+RetWithError<unsigned char> GetWalkType(int dirFD, const std::string& name, unsigned char type)
+{
+    struct stat st {};
+
+    if (type == DT_UNKNOWN) {
+        if (fstatat(dirFD, name.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            return {DT_UNKNOWN, errno == ENOENT ? ErrorEnum::eNone : Error(ErrorEnum::eFailed, strerror(errno))};
+        }
+
+        if (!S_ISLNK(st.st_mode)) {
+            return S_ISREG(st.st_mode) ? DT_REG : (S_ISDIR(st.st_mode) ? DT_DIR : DT_UNKNOWN);
+        }
+
+        type = DT_LNK;
+    }
+
+    if (type == DT_REG || type == DT_DIR) {
+        return type;
+    }
+
+    if (type != DT_LNK) {
+        return DT_UNKNOWN;
+    }
+
+    // Dangling symlinks are skipped.
+    if (fstatat(dirFD, name.c_str(), &st, 0) != 0) {
+        return {DT_UNKNOWN, errno == ENOENT ? ErrorEnum::eNone : Error(ErrorEnum::eFailed, strerror(errno))};
+    }
+
+    return S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+}
+
+// Entries of the directory are read before its subdirectories are opened, so the buffer is shared by all levels and
+// only one descriptor per level is open.
+Error WalkDir(int fd, std::string& path, std::vector<char>& buffer, const WalkHandler& handler)
+{
+    DirEntries entries;
+
+    if (auto err = ReadDirEntries(fd, buffer, entries); !err.IsNone()) {
+        return err;
+    }
+
+    const auto prefixSize = path.size();
+
+    for (const auto& [name, dirType] : entries) {
+        auto [type, err] = GetWalkType(fd, name, dirType);
+        if (!err.IsNone()) {
+            return err;
+        }
+
+        path.resize(prefixSize);
+        path.append(prefixSize == 0 ? "" : "/").append(name);
+
+        if (type == DT_REG) {
+            err = handler(WalkEntry {path, fd, name.c_str()});
+        } else if (type == DT_DIR) {
+            const auto dirFD = openat(fd, name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (dirFD < 0) {
+                return Error(ErrorEnum::eFailed, strerror(errno));
+            }
+
+            err = WalkDir(dirFD, path, buffer, handler);
+
+            close(dirFD);
+        }
+
+        if (!err.IsNone()) {
+            return err;
+        }
+    }
+
+    path.resize(prefixSize);
+
+    return ErrorEnum::eNone;
+}
+
+} // namespace
+
 /***********************************************************************************************************************
  * Public
  **********************************************************************************************************************/
@@ -47,4 +299,336 @@ RetWithError<std::string> MkTmpDir(const std::string& dir, const std::string& pa
     return {std::string(result), ErrorEnum::eNone};
 }
 
+RetWithError<CopyMethod> CopyFileData(int inFD, int outFD)
+{
+    if (ioctl(outFD, FICLONE, inFD) == 0) {
+        return CopyMethod::eClone;
+    }
+
+    if (!IsCopyNotSupported(errno)) {
+        return {CopyMethod::eClone, Error(ErrorEnum::eFailed, strerror(errno))};
+    }
+
+    auto [copied, err] = CopyRange(inFD, outFD);
+    if (!err.IsNone()) {
+        return {CopyMethod::eCopyRange, err};
+    }
+
+    if (copied) {
+        return CopyMethod::eCopyRange;
+    }
+
+    return {CopyMethod::eReadWrite, CopyReadWrite(inFD, outFD)};
+}
+
+Error WalkFiles(const std::string& dir, const WalkHandler& handler)
+{
+    const auto fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return Error(errno == ENOENT ? ErrorEnum::eNotFound : ErrorEnum::eFailed, strerror(errno));
+    }
+
+    std::string       path;
+    std::vector<char> buffer(cDirentBufferSize);
+
+    auto err = WalkDir(fd, path, buffer, handler);
+
+    close(fd);
+
+    return err;
+}
+
+RetWithError<std::string> ReadFileData(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {"", Error(errno == ENOENT ? ErrorEnum::eNotFound : ErrorEnum::eFailed, strerror(errno))};
+    }
+
+    struct stat st {};
+    std::string data;
+    size_t      size = 0;
+    Error       err;
+
+    if (fstat(fd, &st) != 0) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    // One extra byte lets the end of file be seen without growing the buffer.
+    data.resize(st.st_size > 0 ? static_cast<size_t>(st.st_size) + 1 : cReadChunkSize);
+
+    while (err.IsNone()) {
+        if (size == data.size()) {
+            data.resize(data.size() * 2);
+        }
+
+        const auto result = read(fd, data.data() + size, data.size() - size);
+
+        if (result < 0) {
+            if (errno != EINTR) {
+                err = Error(ErrorEnum::eFailed, strerror(errno));
+            }
+
+            continue;
+        }
+
+        if (result == 0) {
+            break;
+        }
+
+        size += static_cast<size_t>(result);
+    }
+
+    close(fd);
+
+    data.resize(size);
+
+    return {std::move(data), err};
+}
+
+/***********************************************************************************************************************
+ * MappedFile
+ **********************************************************************************************************************/
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+Error MappedFile::Open(const std::string& path, bool sequential)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Error(errno == ENOENT ? ErrorEnum::eNotFound : ErrorEnum::eFailed, strerror(errno));
+    }
+
+    struct stat st {};
+
+    if (fstat(fd, &st) != 0) {
+        auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        close(fd);
+
+        return err;
+    }
+
+    if (st.st_size == 0) {
+        close(fd);
+
+        return ErrorEnum::eNone;
+    }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    if (sequential) {
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+    }
+
+    mData = static_cast<const char*>(data);
+    mSize = st.st_size;
+
+    return ErrorEnum::eNone;
+}
+
+void MappedFile::Close()
+{
+    if (mData != nullptr) {
+        munmap(const_cast<char*>(mData), mSize);
+    }
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+/***********************************************************************************************************************
+ * AtomicFile
+ **********************************************************************************************************************/
+
+AtomicFile::~AtomicFile()
+{
+    Abort();
+}
+
+Error AtomicFile::Open(const std::string& path, mode_t mode)
+{
+    Abort();
+
+    struct stat st {};
+    std::string target = path;
+
+    // Symlink is replaced by the file it points to, so the link itself is kept.
+    if (char* resolved = realpath(path.c_str(), nullptr); resolved != nullptr) {
+        target = resolved;
+        free(resolved);
+    }
+
+    const auto exists = stat(target.c_str(), &st) == 0;
+
+#ifdef O_TMPFILE
+    // Unnamed file is linked into the directory through /proc on commit.
+    if (access("/proc/self/fd", X_OK) == 0) {
+        mFD = open(GetParentDir(target).c_str(), O_TMPFILE | O_WRONLY | O_CLOEXEC, mode);
+    }
+#endif
+
+    // New file gets the mode with umask applied as created by open.
+    for (auto i = 0; mFD < 0 && i < cMaxLinkAttempts; i++) {
+        mTmpPath = MakeTmpPath(target);
+        mFD      = open(mTmpPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+
+        if (mFD < 0 && errno != EEXIST) {
+            break;
+        }
+    }
+
+    if (mFD < 0) {
+        auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        mTmpPath.clear();
+
+        return err;
+    }
+
+    mPath = target;
+
+    if (!exists) {
+        return ErrorEnum::eNone;
+    }
+
+    // Owner can be kept only by a privileged process or if the file belongs to the caller already.
+    if (fchown(mFD, st.st_uid, st.st_gid) != 0 && errno != EPERM) {
+        auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        Abort();
+
+        return err;
+    }
+
+    if (fchmod(mFD, st.st_mode & 07777) != 0) {
+        auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        Abort();
+
+        return err;
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error AtomicFile::Write(std::string_view data)
+{
+    if (mFD < 0) {
+        return Error(ErrorEnum::eWrongState, "file is not opened");
+    }
+
+    while (!data.empty()) {
+        const auto written = write(mFD, data.data(), data.size());
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error AtomicFile::Commit(bool sync)
+{
+    if (mFD < 0) {
+        return Error(ErrorEnum::eWrongState, "file is not opened");
+    }
+
+    Error err;
+
+    if (sync && fdatasync(mFD) != 0) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    if (err.IsNone() && mTmpPath.empty()) {
+        err = Link();
+    }
+
+    // Delayed write errors are reported by close on some filesystems.
+    if (const auto fd = std::exchange(mFD, -1); close(fd) != 0 && err.IsNone()) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    if (err.IsNone() && rename(mTmpPath.c_str(), mPath.c_str()) != 0) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    if (!err.IsNone()) {
+        Abort();
+
+        return err;
+    }
+
+    const auto dir = GetParentDir(mPath);
+
+    mTmpPath.clear();
+    mPath.clear();
+
+    Abort();
+
+    if (sync) {
+        return SyncDir(dir);
+    }
+
+    return ErrorEnum::eNone;
+}
+
+void AtomicFile::Abort()
+{
+    if (mFD >= 0) {
+        close(mFD);
+    }
+
+    if (!mTmpPath.empty()) {
+        unlink(mTmpPath.c_str());
+    }
+
+    mFD = -1;
+    mTmpPath.clear();
+    mPath.clear();
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+Error AtomicFile::Link()
+{
+    const auto procPath = "/proc/self/fd/" + std::to_string(mFD);
+
+    for (auto i = 0; i < cMaxLinkAttempts; i++) {
+        auto tmpPath = MakeTmpPath(mPath);
+
+        if (linkat(AT_FDCWD, procPath.c_str(), AT_FDCWD, tmpPath.c_str(), AT_SYMLINK_FOLLOW) == 0) {
+            mTmpPath = std::move(tmpPath);
+
+            return ErrorEnum::eNone;
+        }
+
+        if (errno != EEXIST) {
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+    }
+
+    return Error(ErrorEnum::eFailed, "can't link temporary file");
+}
+
 } // namespace aos::common::utils
@@ -6,27 +6,66 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <filesystem>
-#include <fstream>
-#include <regex>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 
-#include <Poco/DigestEngine.h>
-#include <Poco/DigestStream.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <Poco/Pipe.h>
 #include <Poco/PipeStream.h>
 #include <Poco/Process.h>
-#include <Poco/SHA2Engine.h>
 #include <Poco/StreamCopier.h>
 
+#include "utils/channel.hpp"
+#include "utils/decompressor.hpp"
+#include "utils/digest.hpp"
+#include "utils/filesystem.hpp"
 #include "utils/image.hpp"
+#include "utils/merkle.hpp"
+#include "utils/tar.hpp"
 
 namespace fs = std::filesystem;
 
 namespace {
-const std::unordered_map<std::string, std::regex> cAnchoredEncodedRegexps
-    = {{"sha256", std::regex(R"(^[a-f0-9]{64}$)")}, {"sha384", std::regex(R"(^[a-f0-9]{96}$)")},
-        {"sha512", std::regex(R"(^[a-f0-9]{128}$)")}};
+constexpr size_t cHashBufferSize      = 1024 * 1024;
+constexpr size_t cHashBufferAlignment = 4096;
+
+constexpr std::string_view cHashCacheHeader = "aoshashcache 1\n";
+constexpr size_t           cHashLength      = 64;
+
+// File changed within this interval before hashing may change again without timestamp change because of coarse
+// timestamp granularity.
+constexpr int64_t cRacyInterval = 1000000000;
+
+struct HashCacheEntry {
+    uint64_t    mInode {};
+    uint64_t    mSize {};
+    int64_t     mMTime {};
+    int64_t     mCTime {};
+    std::string mHash;
+};
+
+using HashCache = std::unordered_map<std::string, HashCacheEntry>;
+
+// Maps path relative to the layer root to the hash of the extracted regular file.
+using FileHashes = std::unordered_map<std::string, std::string>;
+
+// Length of the hex encoded digest for the supported algorithms.
+const std::unordered_map<std::string_view, size_t> cEncodedLengths = {{"sha256", 64}, {"sha384", 96}, {"sha512", 128}};
 } // namespace
 
 namespace aos::common::utils {
@@ -35,35 +74,841 @@ namespace aos::common::utils {
  * Static
  **********************************************************************************************************************/
 
-static void ValidateEncoded(const std::string& algorithm, const std::string& encoded)
+static Error ValidateEncoded(const std::string& encoded, size_t length)
+{
+    if (encoded.length() != length) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid encoded length");
+    }
+
+    // Lowercase hex only, same as [a-f0-9].
+    const auto isHex = [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); };
+
+    if (!std::all_of(encoded.begin(), encoded.end(), isHex)) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid encoded");
+    }
+
+    return ErrorEnum::eNone;
+}
+
+static Error UnpackCompressedTarImage(const std::string& archivePath, const std::string& destination)
+{
+    Poco::Process::Args args;
+    args.push_back("xf");
+    args.push_back(archivePath);
+    args.push_back("-C");
+    args.push_back(destination);
+
+    Poco::Pipe          outPipe;
+    Poco::ProcessHandle ph = Poco::Process::launch("tar", args, nullptr, &outPipe, &outPipe);
+    int                 rc = ph.wait();
+
+    if (rc != 0) {
+        std::string           output;
+        Poco::PipeInputStream istr(outPipe);
+        Poco::StreamCopier::copyToString(istr, output);
+
+        return Error(ErrorEnum::eFailed, output.c_str());
+    }
+
+    return ErrorEnum::eNone;
+}
+
+static CompressionType GetCompressionType(int fd)
+{
+    char       header[8] {};
+    const auto size = pread(fd, header, sizeof(header), 0);
+
+    if (size <= 0) {
+        return CompressionType::eNone;
+    }
+
+    return DetectCompression(std::string_view(header, static_cast<size_t>(size)));
+}
+
+static RetWithError<std::string> HashFile(const std::string& file, HashAlgorithm algorithm = HashAlgorithm::eSHA256)
+{
+    // Page aligned buffer reused for all files hashed by the thread.
+    thread_local std::unique_ptr<char, decltype(&std::free)> buffer(
+        static_cast<char*>(std::aligned_alloc(cHashBufferAlignment, cHashBufferSize)), &std::free);
+
+    if (!buffer) {
+        return {"", Error(ErrorEnum::eNoMemory, "Failed to allocate buffer")};
+    }
+
+    const auto fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {"", Error(ErrorEnum::eFailed, "Failed to open file")};
+    }
+
+    // Doubles kernel readahead window for the file.
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    Hasher hasher(algorithm);
+    Error  err;
+
+    while (true) {
+        const auto size = read(fd, buffer.get(), cHashBufferSize);
+
+        if (size == 0) {
+            break;
+        }
+
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            err = Error(ErrorEnum::eFailed, strerror(errno));
+
+            break;
+        }
+
+        hasher.Update(buffer.get(), static_cast<size_t>(size));
+    }
+
+    close(fd);
+
+    if (!err.IsNone()) {
+        return {"", err};
+    }
+
+    return hasher.Finish();
+}
+
+namespace {
+
+// Hashes files on the worker pool while the directory is walked. Workers are started on demand up to the threads
+// limit. Hashes are collected per worker and stored by file index on wait, so the digest doesn't depend on the order
+// in which files are hashed. Chunk hashes are computed for the Merkle tree only.
+class FileHasher {
+public:
+    FileHasher(size_t threads, bool chunked, std::vector<MerkleFile>& files)
+        : mThreads(threads)
+        , mChunked(chunked)
+        , mFiles(files)
+        , mTasks(threads * 2)
+    {
+    }
+
+    ~FileHasher() { Wait(); }
+
+    FileHasher(const FileHasher&)            = delete;
+    FileHasher& operator=(const FileHasher&) = delete;
+
+    // Hashes the file on the calling thread if there are no workers, otherwise queues it.
+    Error Add(size_t index, std::string path)
+    {
+        if (mThreads == 0) {
+            auto [file, err] = Hash(path);
+            if (!err.IsNone()) {
+                return err;
+            }
+
+            Store(index, std::move(file));
+
+            return ErrorEnum::eNone;
+        }
+
+        if (mFailed) {
+            return Error(ErrorEnum::eFailed, "Failed to hash file");
+        }
+
+        if (mWorkers.size() < mThreads) {
+            auto& worker = mWorkers.emplace_back();
+
+            worker.mThread = std::thread(&FileHasher::Run, this, std::ref(worker));
+        }
+
+        return mTasks.Send(Task {index, std::move(path)});
+    }
+
+    // Waits for queued files and stores their hashes, returns the first worker error.
+    Error Wait()
+    {
+        Error err;
+
+        for (size_t i = 0; i < mWorkers.size(); i++) {
+            mTasks.Send(std::nullopt);
+        }
+
+        for (auto& worker : mWorkers) {
+            worker.mThread.join();
+
+            if (err.IsNone()) {
+                err = worker.mError;
+            }
+
+            for (auto& [index, file] : worker.mFiles) {
+                Store(index, std::move(file));
+            }
+        }
+
+        mWorkers.clear();
+
+        return err;
+    }
+
+private:
+    struct Task {
+        size_t      mIndex;
+        std::string mPath;
+    };
+
+    struct Worker {
+        std::thread                                mThread;
+        std::vector<std::pair<size_t, MerkleFile>> mFiles;
+        Error                                      mError;
+    };
+
+    RetWithError<MerkleFile> Hash(const std::string& path) const
+    {
+        if (mChunked) {
+            return HashMerkleFile(path);
+        }
+
+        MerkleFile file;
+        Error      err;
+
+        Tie(file.mHash, err) = HashFile(path);
+
+        return {std::move(file), err};
+    }
+
+    // File path is set by the caller.
+    void Store(size_t index, MerkleFile file)
+    {
+        mFiles[index].mSize   = file.mSize;
+        mFiles[index].mHash   = std::move(file.mHash);
+        mFiles[index].mChunks = std::move(file.mChunks);
+    }
+
+    // After a failure the queue is still drained, so the walk is not blocked on a full channel.
+    void Run(Worker& worker)
+    {
+        while (true) {
+            auto task = mTasks.Receive();
+            if (!task.mError.IsNone() || !task.mValue.has_value()) {
+                break;
+            }
+
+            if (mFailed) {
+                continue;
+            }
+
+            auto [file, err] = Hash(task.mValue->mPath);
+            if (!err.IsNone()) {
+                worker.mError = err;
+                mFailed       = true;
+
+                continue;
+            }
+
+            worker.mFiles.emplace_back(task.mValue->mIndex, std::move(file));
+        }
+    }
+
+    size_t                       mThreads;
+    bool                         mChunked;
+    std::vector<MerkleFile>&     mFiles;
+    Channel<std::optional<Task>> mTasks;
+    std::deque<Worker>           mWorkers;
+    std::atomic_bool             mFailed {false};
+};
+
+} // namespace
+
+static const std::string& GetFileHash(const std::string& hash)
+{
+    return hash;
+}
+
+static const std::string& GetFileHash(const MerkleFile& file)
+{
+    return file.mHash;
+}
+
+template <typename T>
+static std::string CombineHashes(const std::vector<T>& files)
+{
+    Hasher hasher;
+
+    for (const auto& file : files) {
+        hasher.Update(GetFileHash(file));
+        hasher.Update("\n");
+    }
+
+    return "sha256:" + hasher.Finish();
+}
+
+static int64_t ToNanoseconds(const timespec& time)
+{
+    return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+static HashCacheEntry MakeHashCacheEntry(const struct stat& st)
+{
+    return {st.st_ino, static_cast<uint64_t>(st.st_size), ToNanoseconds(st.st_mtim), ToNanoseconds(st.st_ctim), {}};
+}
+
+static bool IsSameFile(const HashCacheEntry& lhs, const HashCacheEntry& rhs)
+{
+    return lhs.mInode == rhs.mInode && lhs.mSize == rhs.mSize && lhs.mMTime == rhs.mMTime
+        && lhs.mCTime == rhs.mCTime;
+}
+
+template <typename T>
+static bool ParseField(std::string_view& line, T& value)
+{
+    const auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), value);
+
+    if (ec != std::errc() || ptr == line.data() + line.size() || *ptr != ' ') {
+        return false;
+    }
+
+    line.remove_prefix(ptr - line.data() + 1);
+
+    return true;
+}
+
+// Cache line: "<inode> <size> <mtime ns> <ctime ns> <sha256> <relative path>". Malformed cache is discarded.
+static HashCache LoadHashCache(const std::string& path)
+{
+    MappedFile file;
+    HashCache  cache;
+
+    if (!file.Open(path, true).IsNone() || file.View().substr(0, cHashCacheHeader.size()) != cHashCacheHeader) {
+        return cache;
+    }
+
+    auto data = file.View().substr(cHashCacheHeader.size());
+
+    while (!data.empty()) {
+        const auto end = data.find('\n');
+        if (end == std::string_view::npos) {
+            return {};
+        }
+
+        auto           line = data.substr(0, end);
+        HashCacheEntry entry;
+
+        if (!ParseField(line, entry.mInode) || !ParseField(line, entry.mSize) || !ParseField(line, entry.mMTime)
+            || !ParseField(line, entry.mCTime) || line.size() < cHashLength + 2 || line[cHashLength] != ' ') {
+            return {};
+        }
+
+        entry.mHash = line.substr(0, cHashLength);
+        cache.emplace(line.substr(cHashLength + 1), std::move(entry));
+
+        data.remove_prefix(end + 1);
+    }
+
+    return cache;
+}
+
+static Error SaveHashCache(const std::string& path, const std::vector<MerkleFile>& files,
+    const std::vector<HashCacheEntry>& entries, int64_t startTime)
+{
+    std::string data(cHashCacheHeader);
+
+    for (size_t i = 0; i < files.size(); i++) {
+        const auto& entry = entries[i];
+
+        // Racily clean files are not cached: they may change later without timestamp change.
+        if (entry.mCTime >= startTime - cRacyInterval || entry.mMTime >= startTime - cRacyInterval) {
+            continue;
+        }
+
+        data.append(std::to_string(entry.mInode)).append(" ");
+        data.append(std::to_string(entry.mSize)).append(" ");
+        data.append(std::to_string(entry.mMTime)).append(" ");
+        data.append(std::to_string(entry.mCTime)).append(" ");
+        data.append(files[i].mHash).append(" ");
+        data.append(files[i].mPath).append("\n");
+    }
+
+    AtomicFile file;
+
+    if (auto err = file.Open(path, 0600); !err.IsNone()) {
+        return err;
+    }
+
+    if (auto err = file.Write(data); !err.IsNone()) {
+        return err;
+    }
+
+    return file.Commit();
+}
+
+static std::string GetDigestAlgorithm(const Digest& digest)
+{
+    auto algorithm = ParseDigest(digest).first;
+
+    std::transform(algorithm.begin(), algorithm.end(), algorithm.begin(), ::tolower);
+
+    return algorithm;
+}
+
+static Error CheckDigest(const Digest& expected, const std::string& hex)
+{
+    if (expected.empty()) {
+        return ErrorEnum::eNone;
+    }
+
+    if (ParseDigest(expected).second != hex) {
+        return Error(ErrorEnum::eInvalidChecksum, "Digest mismatch");
+    }
+
+    return ErrorEnum::eNone;
+}
+
+static void RemoveStaging(const std::string& path)
 {
-    auto it = cAnchoredEncodedRegexps.find(algorithm);
-    if (it == cAnchoredEncodedRegexps.end()) {
-        throw std::runtime_error("Unsupported algorithm");
+    std::error_code ec;
+
+    // Read-only directories of the layer should be writable to remove their entries.
+    for (auto it = fs::recursive_directory_iterator(path, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (it->is_directory(ec) && !it->is_symlink(ec)) {
+            fs::permissions(it->path(), fs::perms::owner_all, fs::perm_options::add, ec);
+        }
     }
 
-    const std::regex& r = it->second;
-    if (encoded.length() != 2 * (algorithm == "sha256" ? 32 : algorithm == "sha384" ? 48 : 64)) {
-        throw std::runtime_error("Invalid encoded length");
+    fs::remove_all(path, ec);
+}
+
+static fs::path GetDestinationPath(const std::string& destination)
+{
+    auto path = fs::absolute(destination).lexically_normal();
+
+    // Trailing separator.
+    if (!path.has_filename()) {
+        path = path.parent_path();
+    }
+
+    return path;
+}
+
+// Staging directory is created next to the destination, so it is promoted by rename.
+static RetWithError<std::string> CreateStaging(const std::string& destination)
+{
+    const auto destinationPath = GetDestinationPath(destination);
+
+    auto [staging, err]
+        = MkTmpDir(destinationPath.parent_path().string(), "." + destinationPath.filename().string() + ".staging");
+    if (!err.IsNone()) {
+        return {"", err};
     }
 
-    if (!std::regex_match(encoded, r)) {
-        throw std::runtime_error("Invalid encoded");
+    // mkdtemp creates private directory, the layer root gets the default directory permissions.
+    fs::permissions(staging, fs::perms::owner_all | fs::perms::group_read | fs::perms::group_exec
+            | fs::perms::others_read | fs::perms::others_exec);
+
+    return staging;
+}
+
+static Error PromoteStaging(const std::string& staging, const std::string& destination)
+{
+    if (rename(staging.c_str(), GetDestinationPath(destination).c_str()) != 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
     }
+
+    return ErrorEnum::eNone;
 }
 
-static std::vector<std::string> CollectFiles(const std::string& dir)
+// Extracts archive entries. If hashes is set, extracted regular files are hashed on the fly.
+static Error ExtractEntries(TarReader& reader, const std::string& destination, FileHashes* hashes)
 {
-    std::vector<std::string> files;
-    std::string              cleanDir = fs::canonical(dir).string();
+    TarExtractor extractor;
+
+    if (auto err = extractor.Open(destination); !err.IsNone()) {
+        return err;
+    }
+
+    TarEntry               entry;
+    Hasher                 fileHash;
+    TarReader::DataHandler observer;
+
+    if (hashes != nullptr) {
+        observer = [&fileHash](std::string_view data) {
+            fileHash.Update(data);
+
+            return ErrorEnum::eNone;
+        };
+    }
+
+    while (true) {
+        auto err = reader.Next(entry);
+        if (err.Is(ErrorEnum::eNotFound)) {
+            break;
+        }
+
+        if (!err.IsNone()) {
+            return err;
+        }
+
+        if (err = extractor.Extract(reader, entry, observer); !err.IsNone()) {
+            return err;
+        }
+
+        if (hashes == nullptr) {
+            continue;
+        }
+
+        // Extractor validates the path, so it can't fail here.
+        const auto path = NormalizeTarPath(entry.mPath).mValue;
 
-    for (const auto& entry : fs::recursive_directory_iterator(cleanDir)) {
-        if (entry.is_regular_file()) {
-            files.push_back(entry.path().generic_string());
+        if (entry.mType == TarEntry::Type::eFile) {
+            (*hashes)[path] = fileHash.Finish();
+        } else if (auto target = hashes->find(NormalizeTarPath(entry.mLinkPath).mValue);
+                   entry.mType == TarEntry::Type::eHardLink && target != hashes->end()) {
+            (*hashes)[path] = target->second;
+        } else {
+            // Replaced file or link to a file outside of the layer: hashed after extraction.
+            hashes->erase(path);
         }
     }
 
-    return files;
+    return extractor.Close();
+}
+
+// Extracts archive decompressing gzip and zstd in process, archive data is hashed as it is read if archiveHash is set.
+static Error ExtractHashed(
+    int fd, CompressionType type, const std::string& destination, Hasher* archiveHash, FileHashes* hashes)
+{
+    const auto readArchive = [fd, archiveHash](char* data, size_t size) -> RetWithError<size_t> {
+        while (true) {
+            const auto count = read(fd, data, size);
+
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count < 0) {
+                return {0, Error(ErrorEnum::eFailed, strerror(errno))};
+            }
+
+            if (archiveHash != nullptr) {
+                archiveHash->Update(data, static_cast<size_t>(count));
+            }
+
+            return static_cast<size_t>(count);
+        }
+    };
+
+    Error err;
+
+    if (type == CompressionType::eNone) {
+        TarReader reader(readArchive);
+
+        err = ExtractEntries(reader, destination, hashes);
+    } else {
+        // Archive is read and decompressed on the decompression thread while entries are extracted on this one.
+        Decompressor decompressor;
+
+        if (err = decompressor.Open(type, readArchive); !err.IsNone()) {
+            return err;
+        }
+
+        TarReader reader([&decompressor](char* data, size_t size) { return decompressor.Read(data, size); });
+
+        err = ExtractEntries(reader, destination, hashes);
+
+        // Joins the decompression thread, so the archive is read below by this thread only.
+        decompressor.Close();
+    }
+
+    if (archiveHash == nullptr) {
+        return err;
+    }
+
+    // Archive digest covers end of archive blocks, padding and compressed data not consumed by the reader. The rest of
+    // the archive is hashed also on extraction error: for corrupted archive the digest mismatch is reported.
+    std::vector<char> buffer(TarReader::cDefaultBufferSize);
+
+    while (true) {
+        auto [count, readErr] = readArchive(buffer.data(), buffer.size());
+        if (!readErr.IsNone()) {
+            return readErr;
+        }
+
+        if (count == 0) {
+            break;
+        }
+    }
+
+    return err;
+}
+
+// Extracts archive checking its digest, empty digest is not checked.
+static Error ExtractVerified(
+    const std::string& archivePath, const std::string& destination, const Digest& digest, FileHashes* hashes)
+{
+    auto algorithm = HashAlgorithm::eSHA256;
+
+    if (!digest.empty()) {
+        Error err;
+
+        if (Tie(algorithm, err) = ParseHashAlgorithm(GetDigestAlgorithm(digest)); !err.IsNone()) {
+            return err;
+        }
+    }
+
+    const auto fd = open(archivePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    const auto type = GetCompressionType(fd);
+
+    if (type == CompressionType::eBzip2 || type == CompressionType::eXz) {
+        close(fd);
+
+        // External tar reads the archive itself, so the digest is checked before extraction.
+        if (!digest.empty()) {
+            auto [hex, err] = HashFile(archivePath, algorithm);
+            if (!err.IsNone()) {
+                return err;
+            }
+
+            if (err = CheckDigest(digest, hex); !err.IsNone()) {
+                return err;
+            }
+        }
+
+        return UnpackCompressedTarImage(archivePath, destination);
+    }
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    Hasher hasher(algorithm);
+
+    auto err = ExtractHashed(fd, type, destination, digest.empty() ? nullptr : &hasher, hashes);
+
+    close(fd);
+
+    if (!digest.empty()) {
+        if (auto checkErr = CheckDigest(digest, hasher.Finish()); !checkErr.IsNone()) {
+            return checkErr;
+        }
+    }
+
+    return err;
+}
+
+// Layer tree copy state.
+struct TreeCopy {
+    int  mRootFD {-1};
+    bool mRoot {};
+    // Hard linked source files: inode to the path of its copy relative to the destination root.
+    std::map<std::pair<dev_t, ino_t>, std::string> mLinks;
+};
+
+static Error CopyAttributes(const TreeCopy& copy, int dirFD, const char* name, const struct stat& st)
+{
+    if (copy.mRoot && fchownat(dirFD, name, st.st_uid, st.st_gid, AT_SYMLINK_NOFOLLOW) != 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    // Ownership change clears set-user-ID and set-group-ID bits, so permissions are set after it. Symlink permissions
+    // are not used on Linux.
+    if (!S_ISLNK(st.st_mode) && fchmodat(dirFD, name, st.st_mode & 07777, 0) != 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    const timespec times[2] = {{0, UTIME_OMIT}, st.st_mtim};
+
+    if (utimensat(dirFD, name, times, AT_SYMLINK_NOFOLLOW) != 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    return ErrorEnum::eNone;
+}
+
+static Error CopyRegularFile(int srcDirFD, int dstDirFD, const char* name)
+{
+    const auto srcFD = openat(srcDirFD, name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (srcFD < 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    const auto dstFD = openat(dstDirFD, name, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (dstFD < 0) {
+        auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        close(srcFD);
+
+        return err;
+    }
+
+    auto err = CopyFileData(srcFD, dstFD).mError;
+
+    if (close(dstFD) != 0 && err.IsNone()) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    close(srcFD);
+
+    return err;
+}
+
+static Error CopyEntry(TreeCopy& copy, int srcDirFD, int dstDirFD, const std::string& path, const char* name);
+
+// Copies directory entries, path is the directory path relative to the destination root.
+static Error CopyDir(TreeCopy& copy, int srcDirFD, int dstDirFD, const std::string& path)
+{
+    const auto fd = dup(srcDirFD);
+    if (fd < 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    auto dir = fdopendir(fd);
+    if (dir == nullptr) {
+        auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        close(fd);
+
+        return err;
+    }
+
+    Error err;
+
+    while (err.IsNone()) {
+        errno = 0;
+
+        const auto entry = readdir(dir);
+        if (entry == nullptr) {
+            if (errno != 0) {
+                err = Error(ErrorEnum::eFailed, strerror(errno));
+            }
+
+            break;
+        }
+
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        err = CopyEntry(copy, srcDirFD, dstDirFD, path, entry->d_name);
+    }
+
+    closedir(dir);
+
+    return err;
+}
+
+static Error CopyEntry(TreeCopy& copy, int srcDirFD, int dstDirFD, const std::string& path, const char* name)
+{
+    struct stat st {};
+
+    if (fstatat(srcDirFD, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    const auto entryPath = path.empty() ? std::string(name) : path + "/" + name;
+
+    if (S_ISDIR(st.st_mode)) {
+        if (mkdirat(dstDirFD, name, 0700) != 0) {
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+
+        const auto srcFD = openat(srcDirFD, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (srcFD < 0) {
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+
+        const auto dstFD = openat(dstDirFD, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (dstFD < 0) {
+            auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+            close(srcFD);
+
+            return err;
+        }
+
+        auto err = CopyDir(copy, srcFD, dstFD, entryPath);
+
+        close(dstFD);
+        close(srcFD);
+
+        if (!err.IsNone()) {
+            return err;
+        }
+
+        // Directory attributes are set after its entries are created, so modification time is preserved.
+        return CopyAttributes(copy, dstDirFD, name, st);
+    }
+
+    // Hard links of the layer are preserved, so the copy has the same number of files.
+    if (st.st_nlink > 1) {
+        const auto [it, inserted] = copy.mLinks.emplace(std::make_pair(st.st_dev, st.st_ino), entryPath);
+
+        if (!inserted) {
+            if (linkat(copy.mRootFD, it->second.c_str(), dstDirFD, name, 0) != 0) {
+                return Error(ErrorEnum::eFailed, strerror(errno));
+            }
+
+            return ErrorEnum::eNone;
+        }
+    }
+
+    Error err;
+
+    if (S_ISREG(st.st_mode)) {
+        err = CopyRegularFile(srcDirFD, dstDirFD, name);
+    } else if (S_ISLNK(st.st_mode)) {
+        char target[PATH_MAX] {};
+
+        if (readlinkat(srcDirFD, name, target, sizeof(target) - 1) < 0) {
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+
+        if (symlinkat(target, dstDirFD, name) != 0) {
+            err = Error(ErrorEnum::eFailed, strerror(errno));
+        }
+    } else if (mknodat(dstDirFD, name, st.st_mode & (S_IFMT | 0777), st.st_rdev) != 0) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    return CopyAttributes(copy, dstDirFD, name, st);
+}
+
+// Copies the source tree to the existing empty destination directory.
+static Error CopyTree(const std::string& source, const std::string& destination)
+{
+    TreeCopy copy;
+
+    copy.mRoot = geteuid() == 0;
+
+    const auto srcFD = open(source.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (srcFD < 0) {
+        return Error(errno == ENOENT ? ErrorEnum::eNotFound : ErrorEnum::eFailed, strerror(errno));
+    }
+
+    copy.mRootFD = open(destination.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (copy.mRootFD < 0) {
+        auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        close(srcFD);
+
+        return err;
+    }
+
+    auto err = CopyDir(copy, srcFD, copy.mRootFD, "");
+
+    if (struct stat st {}; err.IsNone() && fstat(srcFD, &st) != 0) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    } else if (err.IsNone()) {
+        err = CopyAttributes(copy, copy.mRootFD, ".", st);
+    }
+
+    close(copy.mRootFD);
+    close(srcFD);
+
+    return err;
 }
 
 /***********************************************************************************************************************
@@ -86,25 +931,55 @@ Error UnpackTarImage(const std::string& archivePath, const std::string& destinat
         return Error(ErrorEnum::eNotFound, "Archive does not exist");
     }
 
-    Poco::Process::Args args;
-    args.push_back("xf");
-    args.push_back(archivePath);
-    args.push_back("-C");
-    args.push_back(destination);
+    const auto fd = open(archivePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
 
-    Poco::Pipe          outPipe;
-    Poco::ProcessHandle ph = Poco::Process::launch("tar", args, nullptr, &outPipe, &outPipe);
-    int                 rc = ph.wait();
+    const auto type = GetCompressionType(fd);
 
-    if (rc != 0) {
-        std::string           output;
-        Poco::PipeInputStream istr(outPipe);
-        Poco::StreamCopier::copyToString(istr, output);
+    // Bzip2 and xz archives are still unpacked by external tar.
+    if (type == CompressionType::eBzip2 || type == CompressionType::eXz) {
+        close(fd);
 
-        return Error(ErrorEnum::eFailed, output.c_str());
+        return UnpackCompressedTarImage(archivePath, destination);
     }
 
-    return ErrorEnum::eNone;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    auto err = ExtractHashed(fd, type, destination, nullptr, nullptr);
+
+    close(fd);
+
+    return err;
+}
+
+Error UnpackVerifiedTarImage(const std::string& archivePath, const std::string& destination, const Digest& digest)
+{
+    if (auto err = ValidateDigest(digest); !err.IsNone()) {
+        return err;
+    }
+
+    if (!fs::exists(archivePath)) {
+        return Error(ErrorEnum::eNotFound, "Archive does not exist");
+    }
+
+    auto [staging, err] = CreateStaging(destination);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    err = ExtractVerified(archivePath, staging, digest, nullptr);
+
+    if (err.IsNone()) {
+        err = PromoteStaging(staging, destination);
+    }
+
+    if (!err.IsNone()) {
+        RemoveStaging(staging);
+    }
+
+    return err;
 }
 
 Error ValidateDigest(const Digest& digest)
@@ -113,43 +988,232 @@ Error ValidateDigest(const Digest& digest)
 
     std::transform(algorithm.begin(), algorithm.end(), algorithm.begin(), ::tolower);
 
-    if (cAnchoredEncodedRegexps.find(algorithm) == cAnchoredEncodedRegexps.end()) {
+    const auto it = cEncodedLengths.find(algorithm);
+    if (it == cEncodedLengths.end()) {
         return Error(ErrorEnum::eInvalidArgument, "Unsupported algorithm");
     }
 
-    try {
-        ValidateEncoded(algorithm, hex);
-    } catch (const std::runtime_error& e) {
-        return Error(ErrorEnum::eInvalidArgument, e.what());
+    return ValidateEncoded(hex, it->second);
+}
+
+RetWithError<std::string> InstallLayer(const std::string& archivePath, const std::string& destination,
+    const Digest& dirDigest, const Digest& archiveDigest)
+{
+    for (const auto& digest : {dirDigest, archiveDigest}) {
+        if (digest.empty()) {
+            continue;
+        }
+
+        if (auto err = ValidateDigest(digest); !err.IsNone()) {
+            return {"", err};
+        }
     }
 
-    return ErrorEnum::eNone;
+    // HashDir digest is always sha256, archive may be referenced by any OCI digest.
+    if (!dirDigest.empty() && GetDigestAlgorithm(dirDigest) != "sha256") {
+        return {"", Error(ErrorEnum::eNotSupported, "Unsupported algorithm")};
+    }
+
+    if (!fs::exists(archivePath)) {
+        return {"", Error(ErrorEnum::eNotFound, "Archive does not exist")};
+    }
+
+    auto [staging, err] = CreateStaging(destination);
+    if (!err.IsNone()) {
+        return {"", err};
+    }
+
+    // Files extracted by external tar from bzip2 and xz archives are not in the map and hashed after extraction.
+    FileHashes fileHashes;
+
+    err = ExtractVerified(archivePath, staging, archiveDigest, &fileHashes);
+
+    std::string digest;
+
+    if (err.IsNone()) {
+        const auto               root = fs::canonical(staging).string();
+        std::vector<std::string> hashes;
+
+        err = WalkFiles(root, [&](const WalkEntry& entry) -> Error {
+            if (entry.mPath.find('\n') != std::string::npos) {
+                return Error(ErrorEnum::eInvalidArgument, "File names with new lines are not supported");
+            }
+
+            // Symlinks to files and files extracted by external tar are read back.
+            if (auto it = fileHashes.find(entry.mPath); it != fileHashes.end()) {
+                hashes.push_back(it->second);
+
+                return ErrorEnum::eNone;
+            }
+
+            auto [hash, hashErr] = HashFile(root + "/" + entry.mPath);
+            if (!hashErr.IsNone()) {
+                return hashErr;
+            }
+
+            hashes.push_back(std::move(hash));
+
+            return ErrorEnum::eNone;
+        });
+
+        if (err.IsNone()) {
+            digest = CombineHashes(hashes);
+            err    = CheckDigest(dirDigest, ParseDigest(digest).second);
+        }
+    }
+
+    if (err.IsNone()) {
+        err = PromoteStaging(staging, destination);
+    }
+
+    if (!err.IsNone()) {
+        RemoveStaging(staging);
+
+        return {"", err};
+    }
+
+    return digest;
 }
 
-RetWithError<std::string> HashDir(const std::string& dir)
+RetWithError<std::string> HashDir(const std::string& dir, size_t threads)
 {
-    std::vector<std::string> files = CollectFiles(dir);
+    HashDirOptions options;
 
-    Poco::SHA2Engine h;
-    for (const auto& file : files) {
-        if (file.find('\n') != std::string::npos) {
-            return {"", Error(ErrorEnum::eInvalidArgument, "File names with new lines are not supported")};
+    options.mThreads = threads;
+
+    return HashDir(dir, options);
+}
+
+RetWithError<std::string> HashDir(const std::string& dir, const HashDirOptions& options)
+{
+    timespec now {};
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    const auto                  startTime = ToNanoseconds(now);
+    const auto                  root      = fs::canonical(dir).string();
+    const auto                  useCache  = !options.mCachePath.empty();
+    const auto                  useMerkle = !options.mMerklePath.empty();
+    HashCache                   cache;
+    MerkleTree                  tree;
+    std::vector<MerkleFile>     files;
+    std::vector<HashCacheEntry> entries;
+    FileHasher                  hasher(options.mThreads, useMerkle, files);
+
+    if (useCache && !options.mStrict) {
+        cache = LoadHashCache(options.mCachePath);
+
+        // Chunk hashes of cached files are taken from the previous tree, files which are not there are rehashed.
+        if (useMerkle) {
+            tree.Load(options.mMerklePath);
+        }
+    }
+
+    // Files are hashed while the directory is walked, paths are kept only for the cache and the Merkle tree.
+    auto err = WalkFiles(root, [&](const WalkEntry& entry) -> Error {
+        if (entry.mPath.find('\n') != std::string::npos) {
+            return Error(ErrorEnum::eInvalidArgument, "File names with new lines are not supported");
         }
 
-        std::ifstream fileStream(file, std::ios::binary);
-        if (!fileStream.is_open()) {
-            return {"", Error(ErrorEnum::eFailed, "Failed to open file")};
+        auto& file = files.emplace_back();
+
+        if (useCache || useMerkle) {
+            file.mPath = entry.mPath;
+        }
+
+        if (useCache) {
+            struct stat st {};
+
+            // Stat is done before reading, so a file changed while it is hashed gets new ctime and is rehashed next
+            // time.
+            if (fstatat(entry.mDirFD, entry.mName, &st, 0) != 0) {
+                return Error(ErrorEnum::eFailed, strerror(errno));
+            }
+
+            entries.push_back(MakeHashCacheEntry(st));
+
+            if (auto it = cache.find(entry.mPath); it != cache.end() && IsSameFile(it->second, entries.back())) {
+                if (!useMerkle) {
+                    file.mHash = it->second.mHash;
+
+                    return ErrorEnum::eNone;
+                }
+
+                if (auto [cached, findErr] = tree.FindFile(entry.mPath);
+                    findErr.IsNone() && cached.mHash == it->second.mHash) {
+                    file = std::move(cached);
+
+                    return ErrorEnum::eNone;
+                }
+            }
         }
 
-        Poco::SHA2Engine         hf;
-        Poco::DigestOutputStream dos(hf);
-        Poco::StreamCopier::copyStream(fileStream, dos);
+        return hasher.Add(files.size() - 1, root + "/" + entry.mPath);
+    });
+
+    // Worker error is more specific than the one returned to the walk.
+    if (auto waitErr = hasher.Wait(); !waitErr.IsNone()) {
+        err = waitErr;
+    }
+
+    if (!err.IsNone()) {
+        return {"", err};
+    }
+
+    const auto digest = CombineHashes(files);
+
+    if (useCache) {
+        if (err = SaveHashCache(options.mCachePath, files, entries, startTime); !err.IsNone()) {
+            return {digest, err};
+        }
+    }
+
+    if (useMerkle) {
+        if (err = tree.Build(std::move(files)); err.IsNone()) {
+            err = tree.Save(options.mMerklePath);
+        }
+
+        if (!err.IsNone()) {
+            return {digest, err};
+        }
+    }
+
+    return digest;
+}
+
+std::string GetLayerPath(const std::string& store, const Digest& dirDigest)
+{
+    return (fs::path(store) / GetDigestAlgorithm(dirDigest) / ParseDigest(dirDigest).second).string();
+}
+
+Error MaterializeLayer(const std::string& store, const Digest& dirDigest, const std::string& destination)
+{
+    if (auto err = ValidateDigest(dirDigest); !err.IsNone()) {
+        return err;
+    }
+
+    const auto source = GetLayerPath(store, dirDigest);
+
+    if (!fs::is_directory(source)) {
+        return Error(ErrorEnum::eNotFound, "Layer is not in the store");
+    }
+
+    auto [staging, err] = CreateStaging(destination);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    err = CopyTree(source, staging);
+
+    if (err.IsNone()) {
+        err = PromoteStaging(staging, destination);
+    }
 
-        std::string hash = Poco::DigestEngine::digestToHex(hf.digest());
-        h.update(hash + "\n");
+    if (!err.IsNone()) {
+        RemoveStaging(staging);
     }
 
-    return "sha256:" + Poco::DigestEngine::digestToHex(h.digest());
+    return err;
 }
 
 } // namespace aos::common::utils
@@ -5,12 +5,588 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#include <fstream>
+#include <cerrno>
+#include <cstring>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "utils/filesystem.hpp"
 #include "utils/json.hpp"
+#include "utils/jsonscanner.hpp"
+#include "utils/jsonwriter.hpp"
 
 namespace aos::common::utils {
 
+namespace {
+
+constexpr auto cMaxIndexDigits = 9;
+
+/**
+ * Builds Poco json object model from the structural index created by ScanJson.
+ */
+class StructuralParser {
+public:
+    StructuralParser(std::string_view json, const std::vector<uint32_t>& index)
+        : mJson(json)
+        , mIndex(index)
+    {
+    }
+
+    Poco::Dynamic::Var Parse()
+    {
+        std::vector<Frame> stack;
+        Poco::Dynamic::Var root;
+
+        auto emit = [&stack, &root](Poco::Dynamic::Var value) {
+            if (stack.empty()) {
+                root = std::move(value);
+            } else if (stack.back().mObject) {
+                stack.back().mObject->set(stack.back().mKey, value);
+            } else {
+                stack.back().mArray->add(value);
+            }
+        };
+
+        do {
+            const auto c = Next();
+
+            if (c == '{') {
+                if (Peek() == '}') {
+                    Next();
+                    emit(Poco::JSON::Object::Ptr(new Poco::JSON::Object()));
+                } else {
+                    stack.push_back({new Poco::JSON::Object(), nullptr, ParseKey()});
+
+                    continue;
+                }
+            } else if (c == '[') {
+                if (Peek() == ']') {
+                    Next();
+                    emit(Poco::JSON::Array::Ptr(new Poco::JSON::Array()));
+                } else {
+                    stack.push_back({nullptr, new Poco::JSON::Array(), ""});
+
+                    continue;
+                }
+            } else {
+                emit(ParseScalar(c));
+            }
+
+            while (!stack.empty()) {
+                const auto next = Next();
+
+                if (next == ',') {
+                    if (stack.back().mObject) {
+                        stack.back().mKey = ParseKey();
+                    }
+
+                    break;
+                }
+
+                auto frame = std::move(stack.back());
+
+                if (next != (frame.mObject ? '}' : ']')) {
+                    throw Poco::JSON::JSONException("unexpected character");
+                }
+
+                stack.pop_back();
+
+                if (frame.mObject) {
+                    emit(frame.mObject);
+                } else {
+                    emit(frame.mArray);
+                }
+            }
+        } while (!stack.empty());
+
+        if (mPos != mIndex.size()) {
+            throw Poco::JSON::JSONException("excess characters found after json end");
+        }
+
+        return root;
+    }
+
+private:
+    struct Frame {
+        Poco::JSON::Object::Ptr mObject;
+        Poco::JSON::Array::Ptr  mArray;
+        std::string             mKey;
+    };
+
+    char Peek() const
+    {
+        if (mPos >= mIndex.size()) {
+            throw Poco::JSON::JSONException("unexpected end of json");
+        }
+
+        return mJson[mIndex[mPos]];
+    }
+
+    char Next()
+    {
+        auto c = Peek();
+
+        mPos++;
+
+        return c;
+    }
+
+    std::string ParseKey()
+    {
+        if (Next() != '"') {
+            throw Poco::JSON::JSONException("object key expected");
+        }
+
+        auto key = ParseString();
+
+        if (Next() != ':') {
+            throw Poco::JSON::JSONException("colon expected");
+        }
+
+        return key;
+    }
+
+    Poco::Dynamic::Var ParseScalar(char c)
+    {
+        if (c == '"') {
+            return ParseString();
+        }
+
+        auto token = GetToken();
+
+        if (token == "true") {
+            return true;
+        }
+
+        if (token == "false") {
+            return false;
+        }
+
+        if (token == "null") {
+            return {};
+        }
+
+        return ParseNumber(token);
+    }
+
+    // Returns scalar token which starts at the previous index position and ends before the next one.
+    std::string_view GetToken() const
+    {
+        const size_t start = mIndex[mPos - 1];
+        size_t       end   = mPos < mIndex.size() ? mIndex[mPos] : mJson.size();
+
+        while (end > start && IsWhitespace(mJson[end - 1])) {
+            end--;
+        }
+
+        return mJson.substr(start, end - start);
+    }
+
+    static bool IsWhitespace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    static Poco::Dynamic::Var ParseNumber(std::string_view token)
+    {
+        JsonNumber number;
+
+        if (auto err = ParseJsonNumber(token, number); !err.IsNone()) {
+            // Poco reports integer overflow as syntax error of its number parser, not as json error.
+            if (err.Is(ErrorEnum::eOutOfRange)) {
+                throw Poco::SyntaxException("number is out of range");
+            }
+
+            throw Poco::JSON::JSONException("invalid number");
+        }
+
+        switch (number.mType) {
+        case JsonNumber::Type::eInt:
+            return static_cast<Poco::Int64>(number.mInt);
+
+        case JsonNumber::Type::eUInt:
+            return static_cast<Poco::UInt64>(number.mUInt);
+
+        default:
+            return number.mDouble;
+        }
+    }
+
+    // Parses string which opening quote is at the previous index position. Closing quote is always the next index
+    // position as nothing else is indexed inside strings.
+    std::string ParseString()
+    {
+        const size_t start = mIndex[mPos - 1] + 1;
+
+        Next();
+
+        const size_t end = mIndex[mPos - 1];
+        std::string  result;
+
+        if (!DecodeJsonString(mJson.substr(start, end - start), result).IsNone()) {
+            throw Poco::JSON::JSONException("invalid string");
+        }
+
+        return result;
+    }
+
+    std::string_view             mJson;
+    const std::vector<uint32_t>& mIndex;
+    size_t                       mPos {};
+};
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+static const Poco::JSON::Object* AsObject(const Poco::Dynamic::Var& value)
+{
+    const auto& type = value.type();
+
+    if (type == typeid(Poco::JSON::Object::Ptr)) {
+        return value.extract<Poco::JSON::Object::Ptr>().get();
+    }
+
+    if (type == typeid(Poco::JSON::Object)) {
+        return &value.extract<Poco::JSON::Object>();
+    }
+
+    return nullptr;
+}
+
+static const Poco::JSON::Array* AsArray(const Poco::Dynamic::Var& value)
+{
+    const auto& type = value.type();
+
+    if (type == typeid(Poco::JSON::Array::Ptr)) {
+        return value.extract<Poco::JSON::Array::Ptr>().get();
+    }
+
+    if (type == typeid(Poco::JSON::Array)) {
+        return &value.extract<Poco::JSON::Array>();
+    }
+
+    return nullptr;
+}
+
+static Error WriteAll(int fd, std::string_view data)
+{
+    while (!data.empty()) {
+        const auto written = write(fd, data.data(), data.size());
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return Error(ErrorEnum::eFailed, strerror(errno));
+        }
+
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+
+    return ErrorEnum::eNone;
+}
+
+static Error WriteJson(JsonWriter& writer, const Poco::JSON::Object::Ptr& json)
+{
+    try {
+        writer.Value(Poco::Dynamic::Var(json));
+    } catch (const std::exception& e) {
+        return Error(ErrorEnum::eFailed, e.what());
+    }
+
+    return writer.Flush();
+}
+
+static void FindAll(const Poco::Dynamic::Var& value, std::vector<JsonPath::Segment>::const_iterator segment,
+    std::vector<JsonPath::Segment>::const_iterator end, Poco::JSON::Array& result)
+{
+    if (segment == end) {
+        result.add(value);
+
+        return;
+    }
+
+    const auto next = std::next(segment);
+
+    if (const auto* object = AsObject(value); object != nullptr) {
+        if (segment->mType == JsonPath::Segment::Type::eWildcard) {
+            for (const auto& [key, item] : *object) {
+                FindAll(item, next, end, result);
+            }
+        } else if (segment->mType == JsonPath::Segment::Type::eKey && object->has(segment->mKey)) {
+            FindAll(object->get(segment->mKey), next, end, result);
+        }
+
+        return;
+    }
+
+    if (const auto* array = AsArray(value); array != nullptr) {
+        if (segment->mType == JsonPath::Segment::Type::eWildcard) {
+            for (const auto& item : *array) {
+                FindAll(item, next, end, result);
+            }
+        } else if (segment->mType == JsonPath::Segment::Type::eIndex && segment->mIndex < array->size()) {
+            FindAll(*(array->begin() + segment->mIndex), next, end, result);
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * JsonPath
+ **********************************************************************************************************************/
+
+JsonPath::JsonPath(const std::vector<std::string>& keys)
+{
+    mSegments.reserve(keys.size());
+
+    for (const auto& key : keys) {
+        mSegments.push_back({Segment::Type::eKey, key, 0});
+    }
+}
+
+RetWithError<JsonPath> JsonPath::Compile(const std::string& path)
+{
+    JsonPath result;
+    size_t   pos = 0;
+
+    while (pos < path.size()) {
+        if (path[pos] == '[') {
+            auto close = path.find(']', pos);
+            if (close == std::string::npos) {
+                return {{}, Error(ErrorEnum::eInvalidArgument, "unterminated bracket")};
+            }
+
+            if (path[pos + 1] == '"') {
+                std::string key;
+
+                for (pos += 2; pos < path.size() && path[pos] != '"'; ++pos) {
+                    if (path[pos] == '\\' && pos + 1 < path.size()) {
+                        ++pos;
+                    }
+
+                    key += path[pos];
+                }
+
+                if (pos + 1 >= path.size() || path[pos + 1] != ']') {
+                    return {{}, Error(ErrorEnum::eInvalidArgument, "invalid quoted key")};
+                }
+
+                result.AddSegment({Segment::Type::eKey, std::move(key), 0});
+                pos += 2;
+            } else {
+                auto content = path.substr(pos + 1, close - pos - 1);
+
+                if (content == "*") {
+                    result.AddSegment({Segment::Type::eWildcard, "", 0});
+                } else if (!content.empty() && content.size() <= cMaxIndexDigits
+                    && std::all_of(content.begin(), content.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                    result.AddSegment({Segment::Type::eIndex, "", std::stoul(content)});
+                } else {
+                    return {{}, Error(ErrorEnum::eInvalidArgument, "invalid index")};
+                }
+
+                pos = close + 1;
+            }
+        } else {
+            if (path[pos] == '.') {
+                if (pos == 0 || ++pos == path.size()) {
+                    return {{}, Error(ErrorEnum::eInvalidArgument, "empty path segment")};
+                }
+            } else if (pos != 0) {
+                return {{}, Error(ErrorEnum::eInvalidArgument, "missing path separator")};
+            }
+
+            auto end = path.find_first_of(".[", pos);
+            if (end == std::string::npos) {
+                end = path.size();
+            }
+
+            if (end == pos) {
+                return {{}, Error(ErrorEnum::eInvalidArgument, "empty path segment")};
+            }
+
+            auto key = path.substr(pos, end - pos);
+
+            if (key == "*") {
+                result.AddSegment({Segment::Type::eWildcard, "", 0});
+            } else {
+                result.AddSegment({Segment::Type::eKey, std::move(key), 0});
+            }
+
+            pos = end;
+        }
+    }
+
+    return result;
+}
+
+Poco::Dynamic::Var JsonPath::Find(const Poco::Dynamic::Var& object) const
+{
+    if (mHasWildcard) {
+        Poco::JSON::Array::Ptr result = new Poco::JSON::Array();
+
+        FindAll(object, mSegments.begin(), mSegments.end(), *result);
+
+        return result;
+    }
+
+    Poco::Dynamic::Var result = object;
+
+    for (const auto& segment : mSegments) {
+        const auto* current = AsObject(result);
+
+        if (current != nullptr && segment.mType == Segment::Type::eKey && current->has(segment.mKey)) {
+            result = current->get(segment.mKey);
+
+            continue;
+        }
+
+        const auto* array = AsArray(result);
+
+        if (array != nullptr && segment.mType == Segment::Type::eIndex && segment.mIndex < array->size()) {
+            result = Poco::Dynamic::Var(*(array->begin() + segment.mIndex));
+
+            continue;
+        }
+
+        return {};
+    }
+
+    return result;
+}
+
+void JsonPath::AddSegment(Segment segment)
+{
+    mHasWildcard = mHasWildcard || segment.mType == Segment::Type::eWildcard;
+
+    mSegments.push_back(std::move(segment));
+}
+
+/***********************************************************************************************************************
+ * JsonPathExtractor
+ **********************************************************************************************************************/
+
+size_t JsonPathExtractor::Add(const JsonPath& path)
+{
+    size_t node = 0;
+
+    for (const auto& segment : path.GetSegments()) {
+        node = AddChild(node, segment);
+    }
+
+    mNodes[node].mPaths.push_back(mWildcardPaths.size());
+    mWildcardPaths.push_back(path.HasWildcard());
+
+    return mWildcardPaths.size() - 1;
+}
+
+std::vector<Poco::Dynamic::Var> JsonPathExtractor::Extract(const Poco::Dynamic::Var& object) const
+{
+    std::vector<Poco::Dynamic::Var> result(mWildcardPaths.size());
+
+    for (size_t i = 0; i < mWildcardPaths.size(); ++i) {
+        if (mWildcardPaths[i]) {
+            result[i] = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+        }
+    }
+
+    Visit(0, object, result);
+
+    return result;
+}
+
+size_t JsonPathExtractor::AddChild(size_t parent, const JsonPath::Segment& segment)
+{
+    size_t child = mNodes.size();
+
+    switch (segment.mType) {
+    case JsonPath::Segment::Type::eKey: {
+        auto [it, inserted] = mNodes[parent].mKeys.emplace(segment.mKey, child);
+        if (!inserted) {
+            return it->second;
+        }
+
+        break;
+    }
+
+    case JsonPath::Segment::Type::eIndex: {
+        auto& indices = mNodes[parent].mIndices;
+        auto  it      = std::find_if(
+            indices.begin(), indices.end(), [&segment](const auto& entry) { return entry.first == segment.mIndex; });
+        if (it != indices.end()) {
+            return it->second;
+        }
+
+        indices.emplace_back(segment.mIndex, child);
+
+        break;
+    }
+
+    case JsonPath::Segment::Type::eWildcard:
+        if (mNodes[parent].mWildcard != cNoNode) {
+            return mNodes[parent].mWildcard;
+        }
+
+        mNodes[parent].mWildcard = child;
+
+        break;
+    }
+
+    mNodes.emplace_back();
+
+    return child;
+}
+
+void JsonPathExtractor::Visit(
+    size_t nodeIndex, const Poco::Dynamic::Var& value, std::vector<Poco::Dynamic::Var>& result) const
+{
+    const auto& node = mNodes[nodeIndex];
+
+    for (auto path : node.mPaths) {
+        if (mWildcardPaths[path]) {
+            result[path].extract<Poco::JSON::Array::Ptr>()->add(value);
+        } else {
+            result[path] = value;
+        }
+    }
+
+    if (const auto* object = AsObject(value); object != nullptr) {
+        for (const auto& [key, child] : node.mKeys) {
+            if (object->has(key)) {
+                Visit(child, object->get(key), result);
+            }
+        }
+
+        if (node.mWildcard != cNoNode) {
+            for (const auto& [key, item] : *object) {
+                Visit(node.mWildcard, item, result);
+            }
+        }
+
+        return;
+    }
+
+    if (const auto* array = AsArray(value); array != nullptr) {
+        for (const auto& [index, child] : node.mIndices) {
+            if (index < array->size()) {
+                Visit(child, *(array->begin() + index), result);
+            }
+        }
+
+        if (node.mWildcard != cNoNode) {
+            for (const auto& item : *array) {
+                Visit(node.mWildcard, item, result);
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * CaseInsensitiveObjectWrapper
+ **********************************************************************************************************************/
+
 CaseInsensitiveObjectWrapper::CaseInsensitiveObjectWrapper(const Poco::JSON::Object::Ptr& object)
     : mObject(object)
 {
@@ -69,6 +645,10 @@ std::string CaseInsensitiveObjectWrapper::ToLowercase(const std::string& str) co
     return lowerStr;
 }
 
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
 aos::RetWithError<Poco::Dynamic::Var> ParseJson(const std::string& json) noexcept
 {
     try {
@@ -95,20 +675,74 @@ aos::RetWithError<Poco::Dynamic::Var> ParseJson(std::istream& in) noexcept
     }
 }
 
-Error WriteJsonToFile(const Poco::JSON::Object::Ptr& json, const std::string& path)
+aos::RetWithError<Poco::Dynamic::Var> ParseJsonFile(const std::string& path) noexcept
 {
-    std::ofstream file(path);
-    if (!file.is_open()) {
-        return Error(ErrorEnum::eFailed, "Failed to open file");
+    auto [data, err] = ReadFileData(path);
+    if (!err.IsNone()) {
+        return {{}, err};
     }
 
+    return ParseJsonFast(data);
+}
+
+aos::RetWithError<Poco::Dynamic::Var> ParseJsonFast(std::string_view json) noexcept
+{
+    std::vector<uint32_t> index;
+
+    return ParseJsonFast(json, index);
+}
+
+aos::RetWithError<Poco::Dynamic::Var> ParseJsonFast(std::string_view json, std::vector<uint32_t>& index) noexcept
+{
     try {
-        Poco::JSON::Stringifier::stringify(json, file);
-    } catch (const std::exception& e) {
-        return Error(ErrorEnum::eFailed, e.what());
+        if (auto err = ScanJson(json, index); !err.IsNone()) {
+            return {{}, err};
+        }
+
+        return StructuralParser(json, index).Parse();
+    } catch (const Poco::JSON::JSONException& e) {
+        return {{}, aos::ErrorEnum::eInvalidArgument};
+    } catch (...) {
+        return {{}, aos::ErrorEnum::eFailed};
     }
+}
 
-    return ErrorEnum::eNone;
+Error WriteJsonToFile(const Poco::JSON::Object::Ptr& json, const std::string& path, const WriteJsonOptions& options)
+{
+    if (options.mAtomic) {
+        AtomicFile file;
+
+        if (auto err = file.Open(path); !err.IsNone()) {
+            return err;
+        }
+
+        JsonWriter writer([&file](std::string_view data) { return file.Write(data); }, options.mBufferSize);
+
+        if (auto err = WriteJson(writer, json); !err.IsNone()) {
+            return err;
+        }
+
+        return file.Commit(options.mSync);
+    }
+
+    const auto fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        return Error(ErrorEnum::eFailed, "Failed to open file");
+    }
+
+    JsonWriter writer([fd](std::string_view data) { return WriteAll(fd, data); }, options.mBufferSize);
+
+    auto err = WriteJson(writer, json);
+
+    if (err.IsNone() && options.mSync && fdatasync(fd) != 0) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    if (close(fd) != 0 && err.IsNone()) {
+        err = Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    return err;
 }
 
 Poco::Dynamic::Var FindByPath(const Poco::Dynamic::Var object, const std::vector<std::string>& keys)
@@ -120,16 +754,15 @@ Poco::Dynamic::Var FindByPath(const Poco::Dynamic::Var object, const std::vector
     Poco::Dynamic::Var result = object;
 
     for (const auto& key : keys) {
+        const auto* current = AsObject(result);
 
-        if (result.type() == typeid(Poco::JSON::Object)) {
-            result = result.extract<Poco::JSON::Object>().get(key);
-        } else if (result.type() == typeid(Poco::JSON::Object::Ptr)) {
-            result = result.extract<Poco::JSON::Object::Ptr>()->get(key);
-        } else {
+        if (current == nullptr) {
             result.clear();
 
             break;
         }
+
+        result = current->get(key);
     }
 
     return result;
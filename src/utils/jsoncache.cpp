@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <sys/stat.h>
+
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+
+#include "utils/json.hpp"
+#include "utils/jsoncache.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+// Files modified within this interval before parsing are not cached, as in the HashDir cache.
+constexpr int64_t cRacyInterval = 1000000000;
+
+// Estimated overhead of an object member: map node, key string and value holder.
+constexpr size_t cMemberOverhead = 96;
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+int64_t GetTime()
+{
+    timespec now {};
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+size_t GetDocumentSize(const Poco::Dynamic::Var& value)
+{
+    size_t size = sizeof(Poco::Dynamic::Var);
+
+    if (value.type() == typeid(Poco::JSON::Object::Ptr)) {
+        const auto& object = value.extract<Poco::JSON::Object::Ptr>();
+
+        size += sizeof(Poco::JSON::Object);
+
+        for (const auto& [key, member] : *object) {
+            size += cMemberOverhead + key.size() + GetDocumentSize(member);
+        }
+    } else if (value.type() == typeid(Poco::JSON::Array::Ptr)) {
+        const auto& array = value.extract<Poco::JSON::Array::Ptr>();
+
+        size += sizeof(Poco::JSON::Array);
+
+        for (const auto& item : *array) {
+            size += GetDocumentSize(item);
+        }
+    } else if (value.isString()) {
+        size += value.extract<std::string>().size();
+    }
+
+    return size;
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+JsonFileCache& JsonFileCache::Get()
+{
+    static JsonFileCache sCache;
+
+    return sCache;
+}
+
+JsonFileCache::JsonFileCache(size_t maxSize)
+    : mMaxSize(maxSize)
+{
+}
+
+RetWithError<Poco::Dynamic::Var> JsonFileCache::ParseFile(const std::string& path)
+{
+    FileID id;
+
+    if (auto err = GetFileID(path, id); !err.IsNone()) {
+        Invalidate(path);
+
+        return {{}, err};
+    }
+
+    Poco::Dynamic::Var cached;
+
+    {
+        std::lock_guard lock {mMutex};
+
+        if (auto it = mIndex.find(path); it != mIndex.end()) {
+            if (it->second->mID == id) {
+                mEntries.splice(mEntries.begin(), mEntries, it->second);
+
+                cached = it->second->mDocument;
+            } else {
+                Remove(it->second);
+            }
+        }
+    }
+
+    if (!cached.isEmpty()) {
+        return {cached, ErrorEnum::eNone};
+    }
+
+    const auto parseTime = GetTime();
+
+    // Parse without lock: concurrent parsing of the same file is harmless, the last result is cached.
+    auto result = ParseJsonFile(path);
+    if (!result.mError.IsNone()) {
+        return result;
+    }
+
+    // File has been changed while parsing or may be changed within the same timestamp tick: return result without
+    // caching it.
+    if (FileID after; id.mModTime >= parseTime - cRacyInterval || !GetFileID(path, after).IsNone() || !(after == id)) {
+        return result;
+    }
+
+    const auto size = GetDocumentSize(result.mValue);
+
+    std::lock_guard lock {mMutex};
+
+    if (auto it = mIndex.find(path); it != mIndex.end()) {
+        Remove(it->second);
+    }
+
+    if (size > mMaxSize) {
+        return result;
+    }
+
+    mEntries.push_front({path, id, size, result.mValue});
+    mIndex.emplace(path, mEntries.begin());
+    mSize += size;
+
+    Evict();
+
+    return result;
+}
+
+void JsonFileCache::Invalidate(const std::string& path)
+{
+    std::lock_guard lock {mMutex};
+
+    if (auto it = mIndex.find(path); it != mIndex.end()) {
+        Remove(it->second);
+    }
+}
+
+void JsonFileCache::Clear()
+{
+    std::lock_guard lock {mMutex};
+
+    mIndex.clear();
+    mEntries.clear();
+    mSize = 0;
+}
+
+void JsonFileCache::SetMaxSize(size_t maxSize)
+{
+    std::lock_guard lock {mMutex};
+
+    mMaxSize = maxSize;
+
+    Evict();
+}
+
+size_t JsonFileCache::GetSize() const
+{
+    std::lock_guard lock {mMutex};
+
+    return mSize;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+Error JsonFileCache::GetFileID(const std::string& path, FileID& id)
+{
+    struct stat st {};
+
+    if (stat(path.c_str(), &st) != 0) {
+        return Error(errno == ENOENT ? ErrorEnum::eNotFound : ErrorEnum::eFailed, strerror(errno));
+    }
+
+    id.mDevice  = st.st_dev;
+    id.mInode   = st.st_ino;
+    id.mSize    = st.st_size;
+    id.mModTime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+
+    return ErrorEnum::eNone;
+}
+
+void JsonFileCache::Remove(std::list<Entry>::iterator it)
+{
+    mSize -= it->mSize;
+    mIndex.erase(it->mPath);
+    mEntries.erase(it);
+}
+
+void JsonFileCache::Evict()
+{
+    while (mSize > mMaxSize && !mEntries.empty()) {
+        Remove(std::prev(mEntries.end()));
+    }
+}
+
+} // namespace aos::common::utils
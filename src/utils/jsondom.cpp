@@ -0,0 +1,495 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "utils/filesystem.hpp"
+#include "utils/jsondom.hpp"
+#include "utils/jsonscanner.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr size_t cMinChunkSize = 4 * 1024;
+constexpr size_t cMaxChunkSize = 1024 * 1024;
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+        return ::tolower(static_cast<unsigned char>(a)) == ::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * JsonDocument::Builder
+ **********************************************************************************************************************/
+
+/**
+ * Builds DOM from the structural index created by ScanJson. Children of open containers are collected in scratch
+ * vectors and copied to the arena as a contiguous block when the container is closed.
+ */
+class JsonDocument::Builder {
+public:
+    Builder(JsonDocument& document, std::string_view json, const std::vector<uint32_t>& index)
+        : mDocument(document)
+        , mJson(json)
+        , mIndex(index)
+    {
+    }
+
+    Error Build(JsonValue& root)
+    {
+        std::vector<Frame> stack;
+        char               c {};
+
+        auto emit = [this, &stack, &root](const JsonValue& value) {
+            if (stack.empty()) {
+                root = value;
+            } else if (stack.back().mObject) {
+                mMembers.push_back({stack.back().mKey, value});
+            } else {
+                mValues.push_back(value);
+            }
+        };
+
+        do {
+            if (auto err = Next(c); !err.IsNone()) {
+                return err;
+            }
+
+            if (c == '{' || c == '[') {
+                const bool object = c == '{';
+
+                if (mPos < mIndex.size() && mJson[mIndex[mPos]] == (object ? '}' : ']')) {
+                    mPos++;
+
+                    emit(MakeContainer(object, object ? mMembers.size() : mValues.size()));
+                } else {
+                    stack.push_back({object, object ? mMembers.size() : mValues.size(), {}});
+
+                    if (object) {
+                        if (auto err = ParseKey(stack.back().mKey); !err.IsNone()) {
+                            return err;
+                        }
+                    }
+
+                    continue;
+                }
+            } else {
+                JsonValue value;
+
+                if (auto err = ParseScalar(c, value); !err.IsNone()) {
+                    return err;
+                }
+
+                emit(value);
+            }
+
+            while (!stack.empty()) {
+                if (auto err = Next(c); !err.IsNone()) {
+                    return err;
+                }
+
+                if (c == ',') {
+                    if (stack.back().mObject) {
+                        if (auto err = ParseKey(stack.back().mKey); !err.IsNone()) {
+                            return err;
+                        }
+                    }
+
+                    break;
+                }
+
+                const auto frame = stack.back();
+
+                if (c != (frame.mObject ? '}' : ']')) {
+                    return Error(ErrorEnum::eInvalidArgument, "unexpected character");
+                }
+
+                stack.pop_back();
+
+                emit(MakeContainer(frame.mObject, frame.mStart));
+            }
+        } while (!stack.empty());
+
+        if (mPos != mIndex.size()) {
+            return Error(ErrorEnum::eInvalidArgument, "excess characters found after json end");
+        }
+
+        return ErrorEnum::eNone;
+    }
+
+private:
+    struct Frame {
+        bool             mObject;
+        size_t           mStart;
+        std::string_view mKey;
+    };
+
+    Error Next(char& c)
+    {
+        if (mPos >= mIndex.size()) {
+            return Error(ErrorEnum::eInvalidArgument, "unexpected end of json");
+        }
+
+        c = mJson[mIndex[mPos++]];
+
+        return ErrorEnum::eNone;
+    }
+
+    JsonValue MakeContainer(bool object, size_t start)
+    {
+        JsonValue value;
+
+        if (object) {
+            const auto size    = mMembers.size() - start;
+            auto*      members
+                = static_cast<JsonMember*>(mDocument.Allocate(size * sizeof(JsonMember), alignof(JsonMember)));
+
+            std::uninitialized_copy(mMembers.begin() + start, mMembers.end(), members);
+            mMembers.resize(start);
+
+            value.mType    = JsonValue::Type::eObject;
+            value.mSize    = static_cast<uint32_t>(size);
+            value.mMembers = members;
+        } else {
+            const auto size  = mValues.size() - start;
+            auto*      items
+                = static_cast<JsonValue*>(mDocument.Allocate(size * sizeof(JsonValue), alignof(JsonValue)));
+
+            std::uninitialized_copy(mValues.begin() + start, mValues.end(), items);
+            mValues.resize(start);
+
+            value.mType  = JsonValue::Type::eArray;
+            value.mSize  = static_cast<uint32_t>(size);
+            value.mItems = items;
+        }
+
+        return value;
+    }
+
+    Error ParseKey(std::string_view& key)
+    {
+        char c {};
+
+        if (auto err = Next(c); !err.IsNone()) {
+            return err;
+        }
+
+        if (c != '"') {
+            return Error(ErrorEnum::eInvalidArgument, "object key expected");
+        }
+
+        if (auto err = ParseString(key); !err.IsNone()) {
+            return err;
+        }
+
+        if (auto err = Next(c); !err.IsNone()) {
+            return err;
+        }
+
+        if (c != ':') {
+            return Error(ErrorEnum::eInvalidArgument, "colon expected");
+        }
+
+        return ErrorEnum::eNone;
+    }
+
+    // Parses string which opening quote is at the previous index position. Strings without escapes reference input.
+    Error ParseString(std::string_view& str)
+    {
+        const size_t start = mIndex[mPos - 1] + 1;
+        char         quote {};
+
+        if (auto err = Next(quote); !err.IsNone()) {
+            return err;
+        }
+
+        const auto raw = mJson.substr(start, mIndex[mPos - 1] - start);
+
+        if (raw.find('\\') == std::string_view::npos) {
+            if (std::any_of(raw.begin(), raw.end(), [](char c) { return static_cast<unsigned char>(c) < 0x20; })) {
+                return Error(ErrorEnum::eInvalidArgument, "unescaped control character");
+            }
+
+            str = raw;
+
+            return ErrorEnum::eNone;
+        }
+
+        if (auto err = DecodeJsonString(raw, mDecoded); !err.IsNone()) {
+            return err;
+        }
+
+        str = std::string_view(mDocument.CopyString(mDecoded), mDecoded.size());
+
+        return ErrorEnum::eNone;
+    }
+
+    Error ParseScalar(char c, JsonValue& value)
+    {
+        if (c == '"') {
+            std::string_view str;
+
+            if (auto err = ParseString(str); !err.IsNone()) {
+                return err;
+            }
+
+            value.mType   = JsonValue::Type::eString;
+            value.mSize   = static_cast<uint32_t>(str.size());
+            value.mString = str.data();
+
+            return ErrorEnum::eNone;
+        }
+
+        const size_t start = mIndex[mPos - 1];
+        size_t       end   = mPos < mIndex.size() ? mIndex[mPos] : mJson.size();
+
+        while (end > start && IsWhitespace(mJson[end - 1])) {
+            end--;
+        }
+
+        const auto token = mJson.substr(start, end - start);
+
+        if (token == "true" || token == "false") {
+            value.mType = JsonValue::Type::eBool;
+            value.mBool = token == "true";
+
+            return ErrorEnum::eNone;
+        }
+
+        if (token == "null") {
+            value.mType = JsonValue::Type::eNull;
+
+            return ErrorEnum::eNone;
+        }
+
+        JsonNumber number;
+
+        if (auto err = ParseJsonNumber(token, number); !err.IsNone()) {
+            return err;
+        }
+
+        switch (number.mType) {
+        case JsonNumber::Type::eInt:
+            value.mType = JsonValue::Type::eInt;
+            value.mInt  = number.mInt;
+            break;
+
+        case JsonNumber::Type::eUInt:
+            value.mType = JsonValue::Type::eUInt;
+            value.mUInt = number.mUInt;
+            break;
+
+        default:
+            value.mType   = JsonValue::Type::eDouble;
+            value.mDouble = number.mDouble;
+            break;
+        }
+
+        return ErrorEnum::eNone;
+    }
+
+    JsonDocument&                mDocument;
+    std::string_view             mJson;
+    const std::vector<uint32_t>& mIndex;
+    size_t                       mPos {};
+    std::vector<JsonValue>       mValues;
+    std::vector<JsonMember>      mMembers;
+    std::string                  mDecoded;
+};
+
+/***********************************************************************************************************************
+ * JsonValue
+ **********************************************************************************************************************/
+
+std::string_view JsonValue::GetString() const
+{
+    if (mType != Type::eString) {
+        throw Poco::BadCastException("json value is not string");
+    }
+
+    return {mString, mSize};
+}
+
+JsonRange<JsonValue> JsonValue::GetItems() const
+{
+    if (mType != Type::eArray) {
+        throw Poco::BadCastException("json value is not array");
+    }
+
+    return {mItems, mSize};
+}
+
+JsonRange<JsonMember> JsonValue::GetMembers() const
+{
+    if (mType != Type::eObject) {
+        throw Poco::BadCastException("json value is not object");
+    }
+
+    return {mMembers, mSize};
+}
+
+/***********************************************************************************************************************
+ * JsonDocument
+ **********************************************************************************************************************/
+
+JsonDocument::JsonDocument() = default;
+
+JsonDocument::~JsonDocument() = default;
+
+Error JsonDocument::Parse(std::string_view json)
+{
+    Clear();
+
+    return ParseImpl(json);
+}
+
+Error JsonDocument::ParseFile(const std::string& path)
+{
+    Clear();
+
+    auto [data, err] = ReadFileData(path);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    // Buffer is allocated separately, so string values stay valid when the document is moved.
+    mData = std::make_unique<std::string>(std::move(data));
+
+    return ParseImpl(*mData);
+}
+
+void JsonDocument::Clear()
+{
+    mChunks.clear();
+    mCurrent = nullptr;
+    mLeft    = 0;
+    mData.reset();
+    mRoot = JsonValue();
+}
+
+size_t JsonDocument::GetArenaSize() const
+{
+    size_t size = 0;
+
+    for (const auto& [chunk, chunkSize] : mChunks) {
+        size += chunkSize;
+    }
+
+    return size;
+}
+
+void* JsonDocument::Allocate(size_t size, size_t alignment)
+{
+    auto padding = (alignment - reinterpret_cast<uintptr_t>(mCurrent) % alignment) % alignment;
+
+    if (mCurrent == nullptr || padding + size > mLeft) {
+        auto chunkSize = std::clamp(mChunks.empty() ? cMinChunkSize : mChunks.back().second * 2, cMinChunkSize,
+            cMaxChunkSize);
+
+        chunkSize = std::max(chunkSize, size + alignment);
+
+        mChunks.emplace_back(std::unique_ptr<uint8_t[]>(new uint8_t[chunkSize]), chunkSize);
+
+        mCurrent = mChunks.back().first.get();
+        mLeft    = chunkSize;
+        padding  = (alignment - reinterpret_cast<uintptr_t>(mCurrent) % alignment) % alignment;
+    }
+
+    auto* result = mCurrent + padding;
+
+    mCurrent += padding + size;
+    mLeft -= padding + size;
+
+    return result;
+}
+
+const char* JsonDocument::CopyString(std::string_view str)
+{
+    auto* result = static_cast<char*>(Allocate(str.size(), 1));
+
+    memcpy(result, str.data(), str.size());
+
+    return result;
+}
+
+Error JsonDocument::ParseImpl(std::string_view json)
+{
+    std::vector<uint32_t> index;
+
+    if (auto err = ScanJson(json, index); !err.IsNone()) {
+        return err;
+    }
+
+    if (auto err = Builder(*this, json, index).Build(mRoot); !err.IsNone()) {
+        Clear();
+
+        return err;
+    }
+
+    return ErrorEnum::eNone;
+}
+
+/***********************************************************************************************************************
+ * JsonObjectView
+ **********************************************************************************************************************/
+
+JsonObjectView::JsonObjectView(const JsonValue& value)
+    : mObject(&value)
+{
+    if (!value.IsObject()) {
+        throw Poco::BadCastException("json value is not object");
+    }
+}
+
+const JsonValue& JsonObjectView::Get(std::string_view key) const
+{
+    const auto* value = Find(key);
+
+    if (value == nullptr) {
+        throw Poco::NotFoundException("Key not found");
+    }
+
+    return *value;
+}
+
+const JsonValue* JsonObjectView::Find(std::string_view key) const
+{
+    const auto members = mObject->GetMembers();
+
+    // Search from the end, so the last duplicate key wins as in Poco::JSON::Object.
+    for (auto it = members.end(); it != members.begin();) {
+        --it;
+
+        if (EqualsIgnoreCase(it->mKey, key)) {
+            return &it->mValue;
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace aos::common::utils
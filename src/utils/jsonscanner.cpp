@@ -0,0 +1,636 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "utils/jsonscanner.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr size_t cBlockSize = 64;
+
+/***********************************************************************************************************************
+ * Types
+ **********************************************************************************************************************/
+
+struct BlockMasks {
+    uint64_t mQuote;
+    uint64_t mBackslash;
+    uint64_t mOperator;
+    uint64_t mWhitespace;
+    uint64_t mNonASCII;
+};
+
+using ClassifyFunc = void (*)(const uint8_t* block, BlockMasks& masks);
+
+/***********************************************************************************************************************
+ * Classifiers
+ **********************************************************************************************************************/
+
+void ClassifyScalar(const uint8_t* block, BlockMasks& masks)
+{
+    masks = {};
+
+    for (size_t i = 0; i < cBlockSize; i++) {
+        const auto bit = uint64_t(1) << i;
+
+        switch (block[i]) {
+        case '"':
+            masks.mQuote |= bit;
+            break;
+
+        case '\\':
+            masks.mBackslash |= bit;
+            break;
+
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            masks.mOperator |= bit;
+            break;
+
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            masks.mWhitespace |= bit;
+            break;
+
+        default:
+            if (block[i] & 0x80) {
+                masks.mNonASCII |= bit;
+            }
+
+            break;
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse2"))) __m128i EqSSE2(__m128i chunk, char c)
+{
+    return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c));
+}
+
+__attribute__((target("sse2"))) uint64_t MaskSSE2(__m128i v, size_t shift)
+{
+    return uint64_t(uint16_t(_mm_movemask_epi8(v))) << shift;
+}
+
+__attribute__((target("sse2"))) void ClassifySSE2(const uint8_t* block, BlockMasks& masks)
+{
+    masks = {};
+
+    for (size_t i = 0; i < cBlockSize; i += sizeof(__m128i)) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        const auto ops   = _mm_or_si128(_mm_or_si128(EqSSE2(chunk, '{'), EqSSE2(chunk, '}')),
+              _mm_or_si128(_mm_or_si128(EqSSE2(chunk, '['), EqSSE2(chunk, ']')),
+                  _mm_or_si128(EqSSE2(chunk, ':'), EqSSE2(chunk, ','))));
+        const auto whitespace = _mm_or_si128(_mm_or_si128(EqSSE2(chunk, ' '), EqSSE2(chunk, '\t')),
+            _mm_or_si128(EqSSE2(chunk, '\n'), EqSSE2(chunk, '\r')));
+
+        masks.mQuote |= MaskSSE2(EqSSE2(chunk, '"'), i);
+        masks.mBackslash |= MaskSSE2(EqSSE2(chunk, '\\'), i);
+        masks.mOperator |= MaskSSE2(ops, i);
+        masks.mWhitespace |= MaskSSE2(whitespace, i);
+        masks.mNonASCII |= MaskSSE2(chunk, i);
+    }
+}
+
+__attribute__((target("avx2"))) __m256i EqAVX2(__m256i chunk, char c)
+{
+    return _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c));
+}
+
+__attribute__((target("avx2"))) uint64_t MaskAVX2(__m256i v, size_t shift)
+{
+    return uint64_t(uint32_t(_mm256_movemask_epi8(v))) << shift;
+}
+
+__attribute__((target("avx2"))) void ClassifyAVX2(const uint8_t* block, BlockMasks& masks)
+{
+    masks = {};
+
+    for (size_t i = 0; i < cBlockSize; i += sizeof(__m256i)) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        const auto ops   = _mm256_or_si256(_mm256_or_si256(EqAVX2(chunk, '{'), EqAVX2(chunk, '}')),
+              _mm256_or_si256(_mm256_or_si256(EqAVX2(chunk, '['), EqAVX2(chunk, ']')),
+                  _mm256_or_si256(EqAVX2(chunk, ':'), EqAVX2(chunk, ','))));
+        const auto whitespace = _mm256_or_si256(_mm256_or_si256(EqAVX2(chunk, ' '), EqAVX2(chunk, '\t')),
+            _mm256_or_si256(EqAVX2(chunk, '\n'), EqAVX2(chunk, '\r')));
+
+        masks.mQuote |= MaskAVX2(EqAVX2(chunk, '"'), i);
+        masks.mBackslash |= MaskAVX2(EqAVX2(chunk, '\\'), i);
+        masks.mOperator |= MaskAVX2(ops, i);
+        masks.mWhitespace |= MaskAVX2(whitespace, i);
+        masks.mNonASCII |= MaskAVX2(chunk, i);
+    }
+}
+
+#endif
+
+#if defined(__aarch64__)
+
+uint64_t ToBitmask(uint8x16_t v0, uint8x16_t v1, uint8x16_t v2, uint8x16_t v3)
+{
+    const uint8x16_t bits
+        = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+
+    auto sum0 = vpaddq_u8(vandq_u8(v0, bits), vandq_u8(v1, bits));
+    auto sum1 = vpaddq_u8(vandq_u8(v2, bits), vandq_u8(v3, bits));
+
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+void ClassifyNEON(const uint8_t* block, BlockMasks& masks)
+{
+    uint8x16_t quote[4], backslash[4], op[4], whitespace[4], nonASCII[4];
+
+    for (size_t i = 0; i < 4; i++) {
+        const auto chunk = vld1q_u8(block + i * 16);
+        const auto eq    = [&chunk](uint8_t c) { return vceqq_u8(chunk, vdupq_n_u8(c)); };
+
+        quote[i]      = eq('"');
+        backslash[i]  = eq('\\');
+        op[i]
+            = vorrq_u8(vorrq_u8(vorrq_u8(eq('{'), eq('}')), vorrq_u8(eq('['), eq(']'))), vorrq_u8(eq(':'), eq(',')));
+        whitespace[i] = vorrq_u8(vorrq_u8(eq(' '), eq('\t')), vorrq_u8(eq('\n'), eq('\r')));
+        nonASCII[i]   = vcgeq_u8(chunk, vdupq_n_u8(0x80));
+    }
+
+    masks.mQuote      = ToBitmask(quote[0], quote[1], quote[2], quote[3]);
+    masks.mBackslash  = ToBitmask(backslash[0], backslash[1], backslash[2], backslash[3]);
+    masks.mOperator   = ToBitmask(op[0], op[1], op[2], op[3]);
+    masks.mWhitespace = ToBitmask(whitespace[0], whitespace[1], whitespace[2], whitespace[3]);
+    masks.mNonASCII   = ToBitmask(nonASCII[0], nonASCII[1], nonASCII[2], nonASCII[3]);
+}
+
+#endif
+
+ClassifyFunc GetClassifier(SIMDLevel level)
+{
+    if (level > GetSIMDLevel()) {
+        level = GetSIMDLevel();
+    }
+
+    switch (level) {
+#if defined(__x86_64__) || defined(__i386__)
+    case SIMDLevel::eAVX2:
+        return ClassifyAVX2;
+
+    case SIMDLevel::eSSE2:
+        return ClassifySSE2;
+#endif
+
+#if defined(__aarch64__)
+    case SIMDLevel::eNEON:
+        return ClassifyNEON;
+#endif
+
+    default:
+        return ClassifyScalar;
+    }
+}
+
+/***********************************************************************************************************************
+ * Helpers
+ **********************************************************************************************************************/
+
+// Returns mask of characters escaped by backslashes. Backslashes are rare in json, so they are processed one by one.
+uint64_t FindEscaped(uint64_t backslash, uint64_t& prevEscaped)
+{
+    uint64_t escaped = prevEscaped;
+
+    backslash &= ~prevEscaped;
+    prevEscaped = 0;
+
+    while (backslash != 0) {
+        const auto bit  = backslash & (~backslash + 1);
+        const auto next = bit << 1;
+
+        if (next == 0) {
+            prevEscaped = 1;
+        }
+
+        escaped |= next;
+        backslash &= ~(bit | next);
+    }
+
+    return escaped;
+}
+
+uint64_t PrefixXor(uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+
+bool IsContinuation(uint8_t c)
+{
+    return (c & 0xC0) == 0x80;
+}
+
+// Validates UTF-8 sequences starting from pos up to end. The last sequence may continue beyond end, in this case pos
+// is set after it.
+bool ValidateUTF8(const uint8_t* data, size_t size, size_t& pos, size_t end)
+{
+    while (pos < end) {
+        const auto c = data[pos];
+
+        if (c < 0x80) {
+            pos++;
+
+            continue;
+        }
+
+        size_t  length  = 0;
+        uint8_t minNext = 0x80;
+        uint8_t maxNext = 0xBF;
+
+        if (c >= 0xC2 && c <= 0xDF) {
+            length = 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            length  = 3;
+            minNext = c == 0xE0 ? 0xA0 : 0x80;
+            maxNext = c == 0xED ? 0x9F : 0xBF;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            length  = 4;
+            minNext = c == 0xF0 ? 0x90 : 0x80;
+            maxNext = c == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            return false;
+        }
+
+        if (pos + length > size || data[pos + 1] < minNext || data[pos + 1] > maxNext) {
+            return false;
+        }
+
+        for (size_t i = 2; i < length; i++) {
+            if (!IsContinuation(data[pos + i])) {
+                return false;
+            }
+        }
+
+        pos += length;
+    }
+
+    return true;
+}
+
+bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Returns decimal exponent of the first significant digit of the valid json number, e.g. 2 for 123 and -3 for 0.001.
+int64_t GetDecimalOrder(std::string_view token)
+{
+    constexpr int64_t cMaxExponent = 1000000000;
+
+    int64_t order = -1, exponent = 0;
+    bool    found = false, fraction = false, negative = false;
+    size_t  i     = token.front() == '-' ? 1 : 0;
+
+    for (; i < token.size() && token[i] != 'e' && token[i] != 'E'; i++) {
+        if (token[i] == '.') {
+            fraction = true;
+        } else if (!fraction && (found || token[i] != '0')) {
+            found = true;
+            order++;
+        } else if (fraction && !found && token[i] == '0') {
+            order--;
+        } else if (fraction) {
+            found = true;
+        }
+    }
+
+    if (i < token.size() && ++i < token.size() && (token[i] == '+' || token[i] == '-')) {
+        negative = token[i++] == '-';
+    }
+
+    for (; i < token.size(); i++) {
+        exponent = std::min(exponent * 10 + (token[i] - '0'), cMaxExponent);
+    }
+
+    return order + (negative ? -exponent : exponent);
+}
+
+bool ParseHex(std::string_view str, size_t pos, uint32_t& value)
+{
+    if (pos + 4 > str.size()) {
+        return false;
+    }
+
+    auto res = std::from_chars(str.data() + pos, str.data() + pos + 4, value, 16);
+
+    return res.ec == std::errc() && res.ptr == str.data() + pos + 4;
+}
+
+void AppendUTF8(std::string& str, uint32_t codePoint)
+{
+    if (codePoint < 0x80) {
+        str += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        str += static_cast<char>(0xC0 | (codePoint >> 6));
+        str += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        str += static_cast<char>(0xE0 | (codePoint >> 12));
+        str += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        str += static_cast<char>(0xF0 | (codePoint >> 18));
+        str += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        str += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+SIMDLevel GetSIMDLevel()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const auto sLevel = __builtin_cpu_supports("avx2") ? SIMDLevel::eAVX2
+        : __builtin_cpu_supports("sse2")                      ? SIMDLevel::eSSE2
+                                                              : SIMDLevel::eScalar;
+
+    return sLevel;
+#elif defined(__aarch64__)
+    return SIMDLevel::eNEON;
+#else
+    return SIMDLevel::eScalar;
+#endif
+}
+
+Error ScanJson(std::string_view json, std::vector<uint32_t>& index, SIMDLevel level)
+{
+    if (json.size() > std::numeric_limits<uint32_t>::max()) {
+        return Error(ErrorEnum::eInvalidArgument, "json is too big");
+    }
+
+    const auto classify = GetClassifier(level);
+    const auto data     = reinterpret_cast<const uint8_t*>(json.data());
+    const auto size     = json.size();
+
+    uint64_t prevInString = 0;
+    uint64_t prevEscaped  = 0;
+    uint64_t prevPseudo   = 1;
+    size_t   utf8Pos      = 0;
+
+    index.clear();
+    index.reserve(size / 4);
+
+    for (size_t blockStart = 0; blockStart < size; blockStart += cBlockSize) {
+        const uint8_t* block = data + blockStart;
+        uint8_t        tail[cBlockSize];
+        BlockMasks     masks;
+
+        if (size - blockStart < cBlockSize) {
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, size - blockStart);
+
+            block = tail;
+        }
+
+        classify(block, masks);
+
+        if (masks.mNonASCII != 0) {
+            utf8Pos = std::max(utf8Pos, blockStart);
+
+            if (!ValidateUTF8(data, size, utf8Pos, std::min(blockStart + cBlockSize, size))) {
+                return Error(ErrorEnum::eInvalidArgument, "invalid UTF-8");
+            }
+        }
+
+        const auto quotes   = masks.mQuote & ~FindEscaped(masks.mBackslash, prevEscaped);
+        const auto inString = PrefixXor(quotes) ^ prevInString;
+
+        prevInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+        const auto structural = (masks.mOperator & ~inString) | quotes;
+        const auto pseudoPred = structural | masks.mWhitespace;
+        const auto scalars    = ((pseudoPred << 1) | prevPseudo) & ~masks.mWhitespace & ~inString & ~structural;
+
+        prevPseudo = pseudoPred >> 63;
+
+        for (auto bits = structural | scalars; bits != 0; bits &= bits - 1) {
+            index.push_back(static_cast<uint32_t>(blockStart + __builtin_ctzll(bits)));
+        }
+    }
+
+    if (prevInString != 0) {
+        return Error(ErrorEnum::eInvalidArgument, "unterminated string");
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error ParseJsonNumber(std::string_view token, JsonNumber& number)
+{
+    const auto* begin = token.data();
+    const auto* end   = begin + token.size();
+    const auto* cur   = begin;
+    bool        real  = false;
+
+    auto skipDigits = [&cur, end]() {
+        const auto* start = cur;
+
+        while (cur != end && IsDigit(*cur)) {
+            cur++;
+        }
+
+        return cur != start;
+    };
+
+    if (cur != end && *cur == '-') {
+        cur++;
+    }
+
+    if (cur != end && *cur == '0') {
+        cur++;
+    } else if (!skipDigits()) {
+        return ErrorEnum::eInvalidArgument;
+    }
+
+    if (cur != end && *cur == '.') {
+        cur++;
+        real = true;
+
+        if (!skipDigits()) {
+            return ErrorEnum::eInvalidArgument;
+        }
+    }
+
+    if (cur != end && (*cur == 'e' || *cur == 'E')) {
+        cur++;
+        real = true;
+
+        if (cur != end && (*cur == '+' || *cur == '-')) {
+            cur++;
+        }
+
+        if (!skipDigits()) {
+            return ErrorEnum::eInvalidArgument;
+        }
+    }
+
+    if (cur != end) {
+        return ErrorEnum::eInvalidArgument;
+    }
+
+    if (real) {
+        number.mType = JsonNumber::Type::eDouble;
+
+        // Out of range value is left unset, it overflows to infinity or underflows to zero as with strtod.
+        if (std::from_chars(begin, end, number.mDouble).ec == std::errc::result_out_of_range) {
+            number.mDouble = std::copysign(GetDecimalOrder(token) >= 0 ? HUGE_VAL : 0.0, *begin == '-' ? -1.0 : 1.0);
+        }
+
+        return ErrorEnum::eNone;
+    }
+
+    if (std::from_chars(begin, end, number.mInt).ec == std::errc()) {
+        number.mType = JsonNumber::Type::eInt;
+
+        return ErrorEnum::eNone;
+    }
+
+    if (std::from_chars(begin, end, number.mUInt).ec == std::errc()) {
+        number.mType = JsonNumber::Type::eUInt;
+
+        return ErrorEnum::eNone;
+    }
+
+    return ErrorEnum::eOutOfRange;
+}
+
+Error DecodeJsonString(std::string_view raw, std::string& result)
+{
+    result.clear();
+
+    if (std::any_of(raw.begin(), raw.end(), [](char c) { return static_cast<unsigned char>(c) < 0x20; })) {
+        return Error(ErrorEnum::eInvalidArgument, "unescaped control character");
+    }
+
+    if (raw.find('\\') == std::string_view::npos) {
+        result.assign(raw);
+
+        return ErrorEnum::eNone;
+    }
+
+    result.reserve(raw.size());
+
+    for (size_t i = 0; i < raw.size(); i++) {
+        if (raw[i] != '\\') {
+            result += raw[i];
+
+            continue;
+        }
+
+        if (++i == raw.size()) {
+            return Error(ErrorEnum::eInvalidArgument, "invalid escape");
+        }
+
+        switch (raw[i]) {
+        case '"':
+        case '\\':
+        case '/':
+            result += raw[i];
+            break;
+
+        case 'b':
+            result += '\b';
+            break;
+
+        case 'f':
+            result += '\f';
+            break;
+
+        case 'n':
+            result += '\n';
+            break;
+
+        case 'r':
+            result += '\r';
+            break;
+
+        case 't':
+            result += '\t';
+            break;
+
+        case 'u': {
+            uint32_t codePoint {};
+
+            if (!ParseHex(raw, i + 1, codePoint)) {
+                return Error(ErrorEnum::eInvalidArgument, "invalid unicode escape");
+            }
+
+            i += 4;
+
+            if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                return Error(ErrorEnum::eInvalidArgument, "dangling surrogate");
+            }
+
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                uint32_t low {};
+
+                if (i + 2 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u' || !ParseHex(raw, i + 3, low)
+                    || low < 0xDC00 || low > 0xDFFF) {
+                    return Error(ErrorEnum::eInvalidArgument, "invalid surrogate pair");
+                }
+
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                i += 6;
+            }
+
+            AppendUTF8(result, codePoint);
+
+            break;
+        }
+
+        default:
+            return Error(ErrorEnum::eInvalidArgument, "invalid escape");
+        }
+    }
+
+    return ErrorEnum::eNone;
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <thread>
+
+#include <unistd.h>
+
+#include "utils/channel.hpp"
+#include "utils/json.hpp"
+#include "utils/jsonstream.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Types
+ **********************************************************************************************************************/
+
+struct Task {
+    size_t      mIndex {};
+    std::string mRecord;
+};
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool IsScalarEnd(char c)
+{
+    return IsWhitespace(c) || c == '{' || c == '}' || c == '[' || c == ']' || c == '"' || c == ',' || c == ':';
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+JsonStreamReader::JsonStreamReader(std::istream& in, size_t maxRecordSize, Format format)
+    : JsonStreamReader(
+        [&in](char* data, size_t size) -> RetWithError<size_t> {
+            in.read(data, size);
+
+            if (in.bad()) {
+                return {0, Error(ErrorEnum::eFailed, "stream read error")};
+            }
+
+            return static_cast<size_t>(in.gcount());
+        },
+        maxRecordSize, format)
+{
+}
+
+JsonStreamReader::JsonStreamReader(int fd, size_t maxRecordSize, Format format)
+    : JsonStreamReader(
+        [fd](char* data, size_t size) -> RetWithError<size_t> {
+            for (;;) {
+                const auto result = read(fd, data, size);
+
+                if (result >= 0) {
+                    return static_cast<size_t>(result);
+                }
+
+                if (errno != EINTR) {
+                    return {0, Error(ErrorEnum::eFailed, strerror(errno))};
+                }
+            }
+        },
+        maxRecordSize, format)
+{
+}
+
+Error JsonStreamReader::Next(Poco::Dynamic::Var& document)
+{
+    std::string_view record;
+
+    if (auto err = NextRecord(record); !err.IsNone()) {
+        return err;
+    }
+
+    auto result = ParseJsonFast(record, mIndex);
+    if (!result.mError.IsNone()) {
+        return result.mError;
+    }
+
+    document = std::move(result.mValue);
+
+    return ErrorEnum::eNone;
+}
+
+Error JsonStreamReader::ForEach(const RecordHandler& handler, size_t threads)
+{
+    Error            err;
+    std::string_view record;
+
+    if (threads == 0) {
+        while ((err = NextRecord(record)).IsNone()) {
+            handler(mRecordCount - 1, ParseJsonFast(record, mIndex));
+        }
+
+        return err.Is(ErrorEnum::eNotFound) ? ErrorEnum::eNone : err;
+    }
+
+    Channel<std::optional<Task>> channel(threads * 2);
+    std::vector<std::thread>     workers;
+
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back([&channel, &handler]() {
+            std::vector<uint32_t> index;
+
+            for (;;) {
+                auto task = channel.Receive();
+                if (!task.mError.IsNone() || !task.mValue.has_value()) {
+                    break;
+                }
+
+                handler(task.mValue->mIndex, ParseJsonFast(task.mValue->mRecord, index));
+            }
+        });
+    }
+
+    while ((err = NextRecord(record)).IsNone()) {
+        channel.Send(Task {mRecordCount - 1, std::string(record)});
+    }
+
+    for (size_t i = 0; i < threads; i++) {
+        channel.Send(std::nullopt);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return err.Is(ErrorEnum::eNotFound) ? ErrorEnum::eNone : err;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+JsonStreamReader::JsonStreamReader(ReadFunc read, size_t maxRecordSize, Format format)
+    : mRead(std::move(read))
+    , mMaxRecordSize(maxRecordSize)
+    , mFormat(format)
+    , mBuffer(std::min(cDefaultBufferSize, maxRecordSize), '\0')
+{
+}
+
+Error JsonStreamReader::NextRecord(std::string_view& record)
+{
+    if (!mError.IsNone()) {
+        return mError;
+    }
+
+    for (;;) {
+        while (mStart < mEnd && IsWhitespace(mBuffer[mStart])) {
+            mStart++;
+        }
+
+        if (mStart < mEnd) {
+            break;
+        }
+
+        if (mEOF) {
+            return ErrorEnum::eNotFound;
+        }
+
+        if (auto err = Fill(); !err.IsNone()) {
+            return err;
+        }
+    }
+
+    mScanPos  = mStart;
+    mDepth    = 0;
+    mInString = false;
+    mEscape   = false;
+
+    while (!FindRecordEnd()) {
+        // Incomplete record at the end of stream is returned as is and fails on parsing.
+        if (mEOF) {
+            mScanPos = mEnd;
+
+            break;
+        }
+
+        if (auto err = Fill(); !err.IsNone()) {
+            return err;
+        }
+    }
+
+    record = std::string_view(mBuffer.data() + mStart, mScanPos - mStart);
+    mStart = mScanPos;
+
+    mRecordCount++;
+
+    return ErrorEnum::eNone;
+}
+
+// Scans buffer from the last scan position and returns true if the record end is found. Containers and strings end
+// at the matching closing character, other values at whitespace or structural character. In json lines format any
+// new line ends the record: it can't be a part of a valid string, so a broken record ends at its line.
+bool JsonStreamReader::FindRecordEnd()
+{
+    const auto first = mBuffer[mStart];
+
+    if (first != '{' && first != '[' && first != '"') {
+        auto pos = std::max(mScanPos, mStart + 1);
+
+        while (pos < mEnd && !IsScalarEnd(mBuffer[pos])) {
+            pos++;
+        }
+
+        mScanPos = pos;
+
+        return pos < mEnd;
+    }
+
+    for (; mScanPos < mEnd; mScanPos++) {
+        const auto c = mBuffer[mScanPos];
+
+        if (c == '\n' && mFormat == Format::eLines) {
+            return true;
+        }
+
+        if (mInString) {
+            if (mEscape) {
+                mEscape = false;
+            } else if (c == '\\') {
+                mEscape = true;
+            } else if (c == '"') {
+                mInString = false;
+
+                if (mDepth == 0) {
+                    mScanPos++;
+
+                    return true;
+                }
+            }
+
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            mInString = true;
+            break;
+
+        case '{':
+        case '[':
+            mDepth++;
+            break;
+
+        case '}':
+        case ']':
+            if (mDepth > 0 && --mDepth == 0) {
+                mScanPos++;
+
+                return true;
+            }
+
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return false;
+}
+
+// Reads more data to the buffer. Unconsumed data is moved to the buffer beginning and the buffer grows if the current
+// record occupies it completely.
+Error JsonStreamReader::Fill()
+{
+    if (mStart > 0) {
+        std::memmove(mBuffer.data(), mBuffer.data() + mStart, mEnd - mStart);
+
+        mEnd -= mStart;
+        mScanPos = mScanPos > mStart ? mScanPos - mStart : 0;
+        mStart   = 0;
+    }
+
+    if (mEnd == mBuffer.size()) {
+        if (mBuffer.size() >= mMaxRecordSize) {
+            mError = Error(ErrorEnum::eOutOfRange, "record exceeds max size");
+
+            return mError;
+        }
+
+        mBuffer.resize(std::min(mBuffer.size() * 2, mMaxRecordSize));
+    }
+
+    auto [size, err] = mRead(mBuffer.data() + mEnd, mBuffer.size() - mEnd);
+    if (!err.IsNone()) {
+        mError = err;
+
+        return err;
+    }
+
+    if (size == 0) {
+        mEOF = true;
+    }
+
+    mEnd += size;
+
+    return ErrorEnum::eNone;
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <array>
+#include <charconv>
+#include <cmath>
+
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+
+#include "utils/jsonwriter.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr size_t cMaxNumberLen = 32;
+
+// Escape sequences for characters that must be escaped, empty for characters written as is. The set matches
+// Poco::JSON::Stringifier output.
+const auto cEscapes = []() {
+    std::array<std::string_view, 256> escapes {};
+
+    static const char* const cControl[] = {"\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006",
+        "\\u0007", "\\b", "\\t", "\\n", "\\u000B", "\\f", "\\r", "\\u000E", "\\u000F", "\\u0010", "\\u0011", "\\u0012",
+        "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017", "\\u0018", "\\u0019", "\\u001A", "\\u001B", "\\u001C",
+        "\\u001D", "\\u001E", "\\u001F"};
+
+    for (size_t i = 0; i < std::size(cControl); i++) {
+        escapes[i] = cControl[i];
+    }
+
+    escapes['"']  = "\\\"";
+    escapes['\\'] = "\\\\";
+    escapes['/']  = "\\/";
+
+    return escapes;
+}();
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+JsonWriter::JsonWriter(size_t reserve)
+    : mBufferSize(0)
+{
+    mBuffer.reserve(reserve);
+}
+
+JsonWriter::JsonWriter(FlushFunc flush, size_t bufferSize)
+    : mFlush(std::move(flush))
+    , mBufferSize(bufferSize)
+{
+    mBuffer.reserve(bufferSize + cMaxNumberLen);
+}
+
+JsonWriter& JsonWriter::BeginObject()
+{
+    if (BeginValue()) {
+        mBuffer += '{';
+        mScopes.push_back({true, true});
+    }
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndObject()
+{
+    if (!mError.IsNone()) {
+        return *this;
+    }
+
+    if (mScopes.empty() || !mScopes.back().mObject || mKeyWritten) {
+        SetError(Error(ErrorEnum::eWrongState, "unexpected end of object"));
+
+        return *this;
+    }
+
+    mScopes.pop_back();
+
+    return WriteRaw("}");
+}
+
+JsonWriter& JsonWriter::BeginArray()
+{
+    if (BeginValue()) {
+        mBuffer += '[';
+        mScopes.push_back({false, true});
+    }
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndArray()
+{
+    if (!mError.IsNone()) {
+        return *this;
+    }
+
+    if (mScopes.empty() || mScopes.back().mObject) {
+        SetError(Error(ErrorEnum::eWrongState, "unexpected end of array"));
+
+        return *this;
+    }
+
+    mScopes.pop_back();
+
+    return WriteRaw("]");
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key)
+{
+    if (!mError.IsNone()) {
+        return *this;
+    }
+
+    if (mScopes.empty() || !mScopes.back().mObject || mKeyWritten) {
+        SetError(Error(ErrorEnum::eWrongState, "unexpected key"));
+
+        return *this;
+    }
+
+    if (!mScopes.back().mEmpty) {
+        mBuffer += ',';
+    }
+
+    mScopes.back().mEmpty = false;
+    mKeyWritten           = true;
+
+    WriteString(key);
+    mBuffer += ':';
+
+    FlushIfFull();
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(std::string_view value)
+{
+    if (BeginValue()) {
+        WriteString(value);
+        FlushIfFull();
+    }
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(bool value)
+{
+    if (BeginValue()) {
+        WriteRaw(value ? "true" : "false");
+    }
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(const Poco::Dynamic::Var& value)
+{
+    const auto& type = value.type();
+
+    if (type == typeid(Poco::JSON::Object::Ptr) || type == typeid(Poco::JSON::Object)) {
+        const auto& object = type == typeid(Poco::JSON::Object::Ptr) ? *value.extract<Poco::JSON::Object::Ptr>()
+                                                                     : value.extract<Poco::JSON::Object>();
+
+        BeginObject();
+
+        // Names are returned in insertion order if the object preserves it, as Stringifier writes them.
+        for (const auto& key : object.getNames()) {
+            Key(key).Value(object.get(key));
+        }
+
+        return EndObject();
+    }
+
+    if (type == typeid(Poco::JSON::Array::Ptr) || type == typeid(Poco::JSON::Array)) {
+        const auto& array = type == typeid(Poco::JSON::Array::Ptr) ? *value.extract<Poco::JSON::Array::Ptr>()
+                                                                   : value.extract<Poco::JSON::Array>();
+
+        BeginArray();
+
+        for (const auto& item : array) {
+            Value(item);
+        }
+
+        return EndArray();
+    }
+
+    if (value.isEmpty()) {
+        return Null();
+    }
+
+    if (value.isString()) {
+        return Value(value.extract<std::string>());
+    }
+
+    // Char is numeric for Var but written as a string by Stringifier.
+    if (type == typeid(char) || value.isDateTime() || value.isDate() || value.isTime()) {
+        return Value(value.convert<std::string>());
+    }
+
+    if (value.isBoolean()) {
+        return Value(value.convert<bool>());
+    }
+
+    if (value.isInteger()) {
+        return value.isSigned() ? WriteInt(value.convert<Poco::Int64>()) : WriteUInt(value.convert<Poco::UInt64>());
+    }
+
+    if (value.isNumeric()) {
+        return WriteDouble(value.convert<double>());
+    }
+
+    // Structs, vectors of Var and other holders are converted to json by Var itself and written as is.
+    if (BeginValue()) {
+        WriteRaw(value.convert<std::string>());
+    }
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::Null()
+{
+    if (BeginValue()) {
+        WriteRaw("null");
+    }
+
+    return *this;
+}
+
+Error JsonWriter::Flush()
+{
+    if (!mError.IsNone() || !mFlush || mBuffer.empty()) {
+        return mError;
+    }
+
+    SetError(mFlush(mBuffer));
+
+    mBuffer.clear();
+
+    return mError;
+}
+
+std::string JsonWriter::TakeString()
+{
+    auto result = std::move(mBuffer);
+
+    Reset();
+
+    return result;
+}
+
+void JsonWriter::Reset()
+{
+    mBuffer.clear();
+    mScopes.clear();
+    mKeyWritten = false;
+    mError      = ErrorEnum::eNone;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+bool JsonWriter::BeginValue()
+{
+    if (!mError.IsNone()) {
+        return false;
+    }
+
+    if (mScopes.empty()) {
+        return true;
+    }
+
+    auto& scope = mScopes.back();
+
+    if (scope.mObject) {
+        if (!mKeyWritten) {
+            SetError(Error(ErrorEnum::eWrongState, "object key expected"));
+
+            return false;
+        }
+
+        mKeyWritten = false;
+
+        return true;
+    }
+
+    if (!scope.mEmpty) {
+        mBuffer += ',';
+    }
+
+    scope.mEmpty = false;
+
+    return true;
+}
+
+JsonWriter& JsonWriter::WriteInt(int64_t value)
+{
+    if (BeginValue()) {
+        char buffer[cMaxNumberLen];
+
+        WriteRaw(std::string_view(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer));
+    }
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::WriteUInt(uint64_t value)
+{
+    if (BeginValue()) {
+        char buffer[cMaxNumberLen];
+
+        WriteRaw(std::string_view(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer));
+    }
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::WriteDouble(double value)
+{
+    if (!BeginValue()) {
+        return *this;
+    }
+
+    if (!std::isfinite(value)) {
+        return WriteRaw("null");
+    }
+
+    char buffer[cMaxNumberLen];
+
+    return WriteRaw(std::string_view(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer));
+}
+
+JsonWriter& JsonWriter::WriteRaw(std::string_view raw)
+{
+    mBuffer.append(raw);
+
+    FlushIfFull();
+
+    return *this;
+}
+
+void JsonWriter::WriteString(std::string_view str)
+{
+    mBuffer += '"';
+
+    size_t start = 0;
+
+    for (size_t i = 0; i < str.size(); i++) {
+        const auto& escape = cEscapes[static_cast<unsigned char>(str[i])];
+
+        if (escape.empty()) {
+            continue;
+        }
+
+        mBuffer.append(str.data() + start, i - start);
+        mBuffer.append(escape);
+
+        start = i + 1;
+    }
+
+    mBuffer.append(str.data() + start, str.size() - start);
+    mBuffer += '"';
+}
+
+void JsonWriter::FlushIfFull()
+{
+    if (mFlush && mBuffer.size() >= mBufferSize) {
+        Flush();
+    }
+}
+
+void JsonWriter::SetError(const Error& err)
+{
+    if (mError.IsNone()) {
+        mError = err;
+    }
+}
+
+} // namespace aos::common::utils
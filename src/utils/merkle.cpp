@@ -0,0 +1,801 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "utils/digest.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/merkle.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+constexpr std::string_view cMerkleHeader = "aosmerkle 1\n";
+constexpr size_t           cHashLength   = 64;
+
+// Root of the node without children: sha256 of empty data.
+constexpr std::string_view cEmptyRoot = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+// Orders paths component by component, the same way as WalkFiles visits them.
+bool IsWalkOrder(const std::string& lhs, const std::string& rhs)
+{
+    const auto [l, r] = std::mismatch(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+
+    if (r == rhs.end()) {
+        return false;
+    }
+
+    if (l == lhs.end()) {
+        return true;
+    }
+
+    const auto rank = [](char c) { return c == '/' ? 0 : static_cast<unsigned char>(c) + 1; };
+
+    return rank(*l) < rank(*r);
+}
+
+bool IsValidPath(std::string_view path)
+{
+    if (path.empty() || path.find('\n') != std::string_view::npos) {
+        return false;
+    }
+
+    for (size_t start = 0; start <= path.size();) {
+        auto end = path.find('/', start);
+        if (end == std::string_view::npos) {
+            end = path.size();
+        }
+
+        const auto component = path.substr(start, end - start);
+
+        if (component.empty() || component == "." || component == "..") {
+            return false;
+        }
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+size_t GetChunkCount(uint64_t size)
+{
+    return static_cast<size_t>((size + cMerkleChunkSize - 1) / cMerkleChunkSize);
+}
+
+Error ValidateFile(const MerkleFile& file)
+{
+    if (!IsValidPath(file.mPath)) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid file path");
+    }
+
+    if (file.mHash.size() != cHashLength || file.mChunks.size() != GetChunkCount(file.mSize)) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid file hash");
+    }
+
+    if (file.mChunks.size() == 1 && file.mChunks.front() != file.mHash) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid file hash");
+    }
+
+    for (const auto& chunk : file.mChunks) {
+        if (chunk.size() != cHashLength) {
+            return Error(ErrorEnum::eInvalidArgument, "Invalid file hash");
+        }
+    }
+
+    return ErrorEnum::eNone;
+}
+
+// Hashes are hex encoded and have the same length, so the fields don't need separators.
+std::string CombineNodes(std::string_view left, std::string_view right)
+{
+    Hasher hasher;
+
+    hasher.Update("node ");
+    hasher.Update(left);
+    hasher.Update(right);
+
+    return hasher.Finish();
+}
+
+std::string HashFileNode(std::string_view name, const MerkleFile& file, std::string_view chunkRoot)
+{
+    Hasher hasher;
+
+    hasher.Update("file ");
+    hasher.Update(std::to_string(file.mSize));
+    hasher.Update(" ");
+    hasher.Update(file.mHash);
+    hasher.Update(chunkRoot);
+    hasher.Update(name);
+
+    return hasher.Finish();
+}
+
+std::string HashDirNode(std::string_view name, std::string_view root)
+{
+    Hasher hasher;
+
+    hasher.Update("dir ");
+    hasher.Update(root);
+    hasher.Update(name);
+
+    return hasher.Finish();
+}
+
+// Levels of the binary hash tree: the first level is leaves, the last one is the root. The last node of an odd level
+// is promoted to the next level as is.
+std::vector<std::vector<std::string>> BuildLevels(std::vector<std::string> leaves)
+{
+    std::vector<std::vector<std::string>> levels {std::move(leaves)};
+
+    while (levels.back().size() > 1) {
+        const auto&              level = levels.back();
+        std::vector<std::string> next;
+
+        next.reserve((level.size() + 1) / 2);
+
+        for (size_t i = 0; i < level.size(); i += 2) {
+            next.push_back(i + 1 < level.size() ? CombineNodes(level[i], level[i + 1]) : level[i]);
+        }
+
+        levels.push_back(std::move(next));
+    }
+
+    return levels;
+}
+
+std::string GetRoot(const std::vector<std::vector<std::string>>& levels)
+{
+    return levels.back().empty() ? std::string(cEmptyRoot) : levels.back().front();
+}
+
+// Computes the root from the leaf hash and hashes of its siblings.
+std::string ProveRoot(const std::vector<std::vector<std::string>>& levels, size_t index, std::string hash)
+{
+    for (size_t i = 0; i + 1 < levels.size(); i++, index /= 2) {
+        const auto sibling = index ^ 1;
+
+        if (sibling >= levels[i].size()) {
+            continue;
+        }
+
+        hash = index % 2 ? CombineNodes(levels[i][sibling], hash) : CombineNodes(hash, levels[i][sibling]);
+    }
+
+    return hash;
+}
+
+RetWithError<size_t> ReadFull(int fd, uint64_t offset, char* data, size_t size)
+{
+    size_t done = 0;
+
+    while (done < size) {
+        const auto ret = pread(fd, data + done, size - done, static_cast<off_t>(offset + done));
+
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (ret < 0) {
+            return {done, Error(ErrorEnum::eFailed, strerror(errno))};
+        }
+
+        if (ret == 0) {
+            break;
+        }
+
+        done += static_cast<size_t>(ret);
+    }
+
+    return done;
+}
+
+RetWithError<int> OpenFile(const std::string& path)
+{
+    const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {-1, Error(errno == ENOENT ? ErrorEnum::eNotFound : ErrorEnum::eFailed, strerror(errno))};
+    }
+
+    return fd;
+}
+
+bool TakeField(std::string_view& line, std::string_view& field)
+{
+    const auto end = line.find(' ');
+    if (end == std::string_view::npos) {
+        return false;
+    }
+
+    field = line.substr(0, end);
+    line.remove_prefix(end + 1);
+
+    return true;
+}
+
+// File line: "f <size> <sha256> <chunk hashes separated by comma or - for one chunk> <path>".
+bool ParseFile(std::string_view line, MerkleFile& file)
+{
+    std::string_view size, hash, chunks;
+
+    if (!TakeField(line, size) || !TakeField(line, hash) || !TakeField(line, chunks)) {
+        return false;
+    }
+
+    const auto [ptr, ec] = std::from_chars(size.data(), size.data() + size.size(), file.mSize);
+    if (ec != std::errc() || ptr != size.data() + size.size()) {
+        return false;
+    }
+
+    file.mHash = hash;
+    file.mPath = line;
+
+    if (chunks == "-") {
+        if (file.mSize != 0) {
+            file.mChunks.emplace_back(hash);
+        }
+
+        return true;
+    }
+
+    for (size_t start = 0; start <= chunks.size();) {
+        auto end = chunks.find(',', start);
+        if (end == std::string_view::npos) {
+            end = chunks.size();
+        }
+
+        file.mChunks.emplace_back(chunks.substr(start, end - start));
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+RetWithError<MerkleFile> HashMerkleFile(const std::string& path)
+{
+    thread_local std::vector<char> buffer(cMerkleChunkSize);
+
+    auto [fd, err] = OpenFile(path);
+    if (!err.IsNone()) {
+        return {{}, err};
+    }
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    MerkleFile file;
+    Hasher     hasher;
+    Hasher     chunkHasher;
+
+    while (true) {
+        size_t size = 0;
+
+        if (Tie(size, err) = ReadFull(fd, file.mSize, buffer.data(), buffer.size()); !err.IsNone() || size == 0) {
+            break;
+        }
+
+        hasher.Update(buffer.data(), size);
+        file.mSize += size;
+
+        // Short first chunk is the whole file, its hash is the content hash.
+        if (file.mSize == size && size < buffer.size()) {
+            break;
+        }
+
+        chunkHasher.Update(buffer.data(), size);
+        file.mChunks.push_back(chunkHasher.Finish());
+
+        if (size < buffer.size()) {
+            break;
+        }
+    }
+
+    close(fd);
+
+    if (!err.IsNone()) {
+        return {{}, err};
+    }
+
+    file.mHash = hasher.Finish();
+
+    if (file.mSize != 0 && file.mSize <= cMerkleChunkSize) {
+        file.mChunks = {file.mHash};
+    }
+
+    return file;
+}
+
+Error MerkleTree::Build(std::vector<MerkleFile> files)
+{
+    Clear();
+
+    std::sort(files.begin(), files.end(),
+        [](const MerkleFile& lhs, const MerkleFile& rhs) { return IsWalkOrder(lhs.mPath, rhs.mPath); });
+
+    mNodes.emplace_back();
+    mPaths.emplace("", 0);
+
+    // Sorted files of a directory are adjacent, so only directories of the previous file may be reused.
+    std::vector<size_t> dirs {0};
+
+    for (size_t i = 0; i < files.size(); i++) {
+        const auto& path = files[i].mPath;
+
+        if (auto err = ValidateFile(files[i]); !err.IsNone()) {
+            Clear();
+
+            return err;
+        }
+
+        size_t depth = 0, start = 0;
+
+        for (auto end = path.find('/'); end != std::string::npos; end = path.find('/', start)) {
+            auto dirPath = path.substr(0, end);
+
+            depth++;
+
+            if (auto it = mPaths.find(dirPath); it != mPaths.end()) {
+                if (depth >= dirs.size() || dirs[depth] != it->second) {
+                    Clear();
+
+                    return Error(ErrorEnum::eInvalidArgument, "File is used as a directory");
+                }
+            } else {
+                dirs.resize(depth);
+                dirs.push_back(AddNode(dirs.back(), path.substr(start, end - start), std::move(dirPath)));
+            }
+
+            start = end + 1;
+        }
+
+        if (mPaths.count(path) != 0) {
+            Clear();
+
+            return Error(ErrorEnum::eInvalidArgument, "Duplicated file path");
+        }
+
+        dirs.resize(depth + 1);
+
+        mNodes[AddNode(dirs.back(), path.substr(start), path)].mFile = static_cast<int64_t>(i);
+    }
+
+    mFiles = std::move(files);
+
+    // Children follow their parents, so nodes hashed in reverse order have their children hashed.
+    for (auto i = mNodes.size(); i-- > 0;) {
+        auto& node = mNodes[i];
+
+        if (node.mFile >= 0) {
+            const auto& file = mFiles[node.mFile];
+
+            node.mLevels = BuildLevels(file.mChunks);
+            node.mHash   = HashFileNode(node.mName, file, GetRoot(node.mLevels));
+
+            continue;
+        }
+
+        std::vector<std::string> leaves;
+
+        leaves.reserve(node.mChildren.size());
+
+        for (auto child : node.mChildren) {
+            leaves.push_back(mNodes[child].mHash);
+        }
+
+        node.mLevels = BuildLevels(std::move(leaves));
+        node.mHash   = HashDirNode(node.mName, GetRoot(node.mLevels));
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error MerkleTree::Scan(const std::string& dir)
+{
+    std::vector<MerkleFile> files;
+
+    auto err = WalkFiles(dir, [&](const WalkEntry& entry) -> Error {
+        auto [file, hashErr] = HashMerkleFile(dir + "/" + entry.mPath);
+        if (!hashErr.IsNone()) {
+            return hashErr;
+        }
+
+        file.mPath = entry.mPath;
+        files.push_back(std::move(file));
+
+        return ErrorEnum::eNone;
+    });
+    if (!err.IsNone()) {
+        Clear();
+
+        return err;
+    }
+
+    return Build(std::move(files));
+}
+
+// Line: "d <hash> <path>" for directories, the root has empty path. Files are stored by ParseFile format.
+Error MerkleTree::Load(const std::string& path)
+{
+    Clear();
+
+    MappedFile file;
+
+    if (auto err = file.Open(path, true); !err.IsNone()) {
+        return err;
+    }
+
+    auto data = file.View();
+
+    if (data.substr(0, cMerkleHeader.size()) != cMerkleHeader) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid Merkle tree");
+    }
+
+    data.remove_prefix(cMerkleHeader.size());
+
+    std::vector<MerkleFile>                                    files;
+    std::vector<std::pair<std::string_view, std::string_view>> dirs;
+
+    while (!data.empty()) {
+        const auto end = data.find('\n');
+        if (end == std::string_view::npos) {
+            return Error(ErrorEnum::eInvalidArgument, "Invalid Merkle tree");
+        }
+
+        auto             line = data.substr(0, end);
+        std::string_view type, hash;
+
+        data.remove_prefix(end + 1);
+
+        if (!TakeField(line, type)) {
+            return Error(ErrorEnum::eInvalidArgument, "Invalid Merkle tree");
+        }
+
+        if (type == "d" && TakeField(line, hash)) {
+            dirs.emplace_back(line, hash);
+
+            continue;
+        }
+
+        if (type != "f" || !ParseFile(line, files.emplace_back())) {
+            return Error(ErrorEnum::eInvalidArgument, "Invalid Merkle tree");
+        }
+    }
+
+    if (auto err = Build(std::move(files)); !err.IsNone()) {
+        return err;
+    }
+
+    const auto dirCount = std::count_if(
+        mNodes.begin(), mNodes.end(), [](const Node& node) { return node.mFile < 0; });
+
+    if (static_cast<size_t>(dirCount) != dirs.size()) {
+        Clear();
+
+        return Error(ErrorEnum::eInvalidChecksum, "Merkle tree directories mismatch");
+    }
+
+    for (const auto& [dirPath, hash] : dirs) {
+        auto it = mPaths.find(std::string(dirPath));
+
+        if (it == mPaths.end() || mNodes[it->second].mFile >= 0 || mNodes[it->second].mHash != hash) {
+            Clear();
+
+            return Error(ErrorEnum::eInvalidChecksum, "Merkle tree directories mismatch");
+        }
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error MerkleTree::Save(const std::string& path) const
+{
+    if (mNodes.empty()) {
+        return Error(ErrorEnum::eWrongState, "Merkle tree is not built");
+    }
+
+    std::string              data(cMerkleHeader);
+    std::vector<std::string> paths(mNodes.size());
+
+    // Nodes are stored in WalkFiles order, parents precede their children.
+    for (size_t i = 0; i < mNodes.size(); i++) {
+        const auto& node = mNodes[i];
+
+        if (i != 0) {
+            const auto& parentPath = paths[node.mParent];
+
+            paths[i] = parentPath.empty() ? node.mName : parentPath + "/" + node.mName;
+        }
+
+        if (node.mFile < 0) {
+            data.append("d ").append(node.mHash).append(" ").append(paths[i]).append("\n");
+
+            continue;
+        }
+
+        const auto& file = mFiles[node.mFile];
+
+        data.append("f ").append(std::to_string(file.mSize)).append(" ").append(file.mHash).append(" ");
+
+        if (file.mChunks.size() <= 1) {
+            data.append("-");
+        }
+
+        for (size_t j = 0; file.mChunks.size() > 1 && j < file.mChunks.size(); j++) {
+            data.append(j == 0 ? "" : ",").append(file.mChunks[j]);
+        }
+
+        data.append(" ").append(file.mPath).append("\n");
+    }
+
+    AtomicFile file;
+
+    if (auto err = file.Open(path); !err.IsNone()) {
+        return err;
+    }
+
+    if (auto err = file.Write(data); !err.IsNone()) {
+        return err;
+    }
+
+    return file.Commit();
+}
+
+Digest MerkleTree::GetDigest() const
+{
+    return mNodes.empty() ? "" : "sha256:" + mNodes.front().mHash;
+}
+
+Digest MerkleTree::GetFlatDigest() const
+{
+    Hasher hasher;
+
+    for (const auto& file : mFiles) {
+        hasher.Update(file.mHash);
+        hasher.Update("\n");
+    }
+
+    return "sha256:" + hasher.Finish();
+}
+
+RetWithError<MerkleFile> MerkleTree::FindFile(std::string_view path) const
+{
+    auto [node, err] = FindNode(path);
+    if (!err.IsNone()) {
+        return {{}, err};
+    }
+
+    if (mNodes[node].mFile < 0) {
+        return {{}, Error(ErrorEnum::eNotFound, "File not found")};
+    }
+
+    return mFiles[mNodes[node].mFile];
+}
+
+Error MerkleTree::VerifyFile(const std::string& dir, std::string_view path) const
+{
+    auto [stored, err] = FindFile(path);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    auto [file, hashErr] = HashMerkleFile(dir + "/" + stored.mPath);
+    if (!hashErr.IsNone()) {
+        return hashErr;
+    }
+
+    const auto node = mPaths.at(stored.mPath);
+
+    return VerifyNode(node, HashFileNode(mNodes[node].mName, file, GetRoot(BuildLevels(file.mChunks))));
+}
+
+Error MerkleTree::VerifyChunk(const std::string& dir, std::string_view path, size_t index) const
+{
+    auto [stored, err] = FindFile(path);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    if (index >= stored.mChunks.size()) {
+        return Error(ErrorEnum::eOutOfRange, "Chunk not found");
+    }
+
+    int fd = -1;
+
+    if (Tie(fd, err) = OpenFile(dir + "/" + stored.mPath); !err.IsNone()) {
+        return err;
+    }
+
+    std::vector<char> buffer(cMerkleChunkSize);
+    size_t            size = 0;
+
+    Tie(size, err) = ReadFull(fd, static_cast<uint64_t>(index) * cMerkleChunkSize, buffer.data(), buffer.size());
+
+    close(fd);
+
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    Hasher hasher;
+
+    hasher.Update(buffer.data(), size);
+
+    const auto  node      = mPaths.at(stored.mPath);
+    const auto& fileNode  = mNodes[node];
+    const auto  chunkRoot = ProveRoot(fileNode.mLevels, index, hasher.Finish());
+
+    return VerifyNode(node, HashFileNode(fileNode.mName, stored, chunkRoot));
+}
+
+Error MerkleTree::VerifyDir(const std::string& dir, std::string_view path) const
+{
+    auto [node, err] = FindNode(path);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    if (mNodes[node].mFile >= 0) {
+        return Error(ErrorEnum::eNotFound, "Directory not found");
+    }
+
+    MerkleTree tree;
+
+    if (err = tree.Scan(path.empty() ? dir : dir + "/" + std::string(path)); !err.IsNone()) {
+        return err;
+    }
+
+    return VerifyNode(node, HashDirNode(mNodes[node].mName, GetRoot(tree.mNodes.front().mLevels)));
+}
+
+std::vector<std::string> MerkleTree::Diff(const MerkleTree& other) const
+{
+    std::vector<std::string> paths;
+
+    if (mNodes.empty() || other.mNodes.empty()) {
+        for (const auto* tree : {this, &other}) {
+            if (!tree->mNodes.empty()) {
+                tree->CollectFiles(0, paths);
+            }
+        }
+    } else {
+        DiffNodes(other, 0, 0, paths);
+    }
+
+    std::sort(paths.begin(), paths.end(), IsWalkOrder);
+
+    return paths;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+void MerkleTree::Clear()
+{
+    mFiles.clear();
+    mNodes.clear();
+    mPaths.clear();
+}
+
+size_t MerkleTree::AddNode(size_t parent, std::string name, std::string path)
+{
+    const auto index = mNodes.size();
+
+    auto& node = mNodes.emplace_back();
+
+    node.mName   = std::move(name);
+    node.mParent = parent;
+    node.mIndex  = mNodes[parent].mChildren.size();
+
+    mNodes[parent].mChildren.push_back(index);
+    mPaths.emplace(std::move(path), index);
+
+    return index;
+}
+
+RetWithError<size_t> MerkleTree::FindNode(std::string_view path) const
+{
+    auto it = mPaths.find(std::string(path));
+    if (it == mPaths.end()) {
+        return {0, Error(ErrorEnum::eNotFound, "Path not found")};
+    }
+
+    return it->second;
+}
+
+// Only siblings of the nodes on the path to the root are used, so O(log n) nodes are hashed.
+Error MerkleTree::VerifyNode(size_t node, std::string hash) const
+{
+    while (node != 0) {
+        const auto& parent = mNodes[mNodes[node].mParent];
+
+        hash = HashDirNode(parent.mName, ProveRoot(parent.mLevels, mNodes[node].mIndex, std::move(hash)));
+        node = mNodes[node].mParent;
+    }
+
+    if (hash != mNodes.front().mHash) {
+        return Error(ErrorEnum::eInvalidChecksum, "Merkle root mismatch");
+    }
+
+    return ErrorEnum::eNone;
+}
+
+void MerkleTree::CollectFiles(size_t node, std::vector<std::string>& paths) const
+{
+    if (mNodes[node].mFile >= 0) {
+        paths.push_back(mFiles[mNodes[node].mFile].mPath);
+
+        return;
+    }
+
+    for (auto child : mNodes[node].mChildren) {
+        CollectFiles(child, paths);
+    }
+}
+
+void MerkleTree::DiffNodes(
+    const MerkleTree& other, size_t node, size_t otherNode, std::vector<std::string>& paths) const
+{
+    const auto& lhs = mNodes[node];
+    const auto& rhs = other.mNodes[otherNode];
+
+    if (lhs.mHash == rhs.mHash) {
+        return;
+    }
+
+    if (lhs.mFile >= 0 && rhs.mFile >= 0) {
+        paths.push_back(mFiles[lhs.mFile].mPath);
+
+        return;
+    }
+
+    if (lhs.mFile >= 0 || rhs.mFile >= 0) {
+        CollectFiles(node, paths);
+        other.CollectFiles(otherNode, paths);
+
+        return;
+    }
+
+    // Children are sorted by name in both trees.
+    size_t i = 0, j = 0;
+
+    while (i < lhs.mChildren.size() || j < rhs.mChildren.size()) {
+        if (j == rhs.mChildren.size()
+            || (i < lhs.mChildren.size() && mNodes[lhs.mChildren[i]].mName < other.mNodes[rhs.mChildren[j]].mName)) {
+            CollectFiles(lhs.mChildren[i++], paths);
+        } else if (i == lhs.mChildren.size()
+            || other.mNodes[rhs.mChildren[j]].mName < mNodes[lhs.mChildren[i]].mName) {
+            other.CollectFiles(rhs.mChildren[j++], paths);
+        } else {
+            DiffNodes(other, lhs.mChildren[i++], rhs.mChildren[j++], paths);
+        }
+    }
+}
+
+} // namespace aos::common::utils
@@ -4,11 +4,10 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
-#include <regex>
+#include <string_view>
 
 #include <aos/common/crypto/utils.hpp>
 
-#include "utils/exception.hpp"
 #include "utils/pkcs11helper.hpp"
 
 namespace aos::common::utils {
@@ -17,30 +16,38 @@ namespace aos::common::utils {
  * Statics
  **********************************************************************************************************************/
 
-// LibP11 has its limitations on RFC7512 urls:
-// https://www.rfc-editor.org/rfc/rfc7512.html
-static std::string CreateLibP11PKCS11URL(const String& url)
+// Removes all "<name>=<value>" occurrences with the following separator, same as regex "<name>=[^&?;]*[&?;]?".
+static std::string RemoveAttribute(std::string_view url, std::string_view name)
 {
     std::string result;
+    size_t      pos = 0;
 
-    try {
-        // libp11 v0.4.11(provided with Ubuntu 22.04) loads pkcs11 objects with invalid id if label available.
-        // Remove label to protect against loading invalid objects.
-        std::regex objLabelRegex {"object=[^&?;]*[&?;]?"};
+    result.reserve(url.size());
 
-        result = std::regex_replace(url.CStr(), objLabelRegex, "");
+    for (auto start = url.find(name); start != std::string_view::npos; start = url.find(name, pos)) {
+        const auto end = url.find_first_of("&?;", start + name.size());
 
-        // libp11 doesn't process module-path
-        std::regex modulePathRegex {"module\\-path=[^&?;]*[&?;]?"};
-
-        result = std::regex_replace(result, modulePathRegex, "");
-    } catch (const std::exception& exc) {
-        AOS_ERROR_THROW(exc.what(), aos::ErrorEnum::eFailed);
+        result.append(url.substr(pos, start - pos));
+        pos = end == std::string_view::npos ? url.size() : end + 1;
     }
 
+    result.append(url.substr(pos));
+
     return result;
 }
 
+// LibP11 has its limitations on RFC7512 urls:
+// https://www.rfc-editor.org/rfc/rfc7512.html
+static std::string CreateLibP11PKCS11URL(const String& url)
+{
+    // libp11 v0.4.11(provided with Ubuntu 22.04) loads pkcs11 objects with invalid id if label available.
+    // Remove label to protect against loading invalid objects.
+    auto result = RemoveAttribute(url.CStr(), "object=");
+
+    // libp11 doesn't process module-path
+    return RemoveAttribute(result, "module-path=");
+}
+
 /***********************************************************************************************************************
  * Public functions
  **********************************************************************************************************************/
@@ -0,0 +1,1137 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+#include "utils/tar.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+struct Field {
+    size_t mOffset;
+    size_t mSize;
+};
+
+constexpr Field cNameField     = {0, 100};
+constexpr Field cModeField     = {100, 8};
+constexpr Field cUIDField      = {108, 8};
+constexpr Field cGIDField      = {116, 8};
+constexpr Field cSizeField     = {124, 12};
+constexpr Field cMTimeField    = {136, 12};
+constexpr Field cChecksumField = {148, 8};
+constexpr Field cLinkNameField = {157, 100};
+constexpr Field cMagicField    = {257, 8};
+constexpr Field cDevMajorField = {329, 8};
+constexpr Field cDevMinorField = {337, 8};
+constexpr Field cPrefixField   = {345, 155};
+
+constexpr auto             cTypeFlagOffset = 156;
+constexpr std::string_view cUstarMagic("ustar\0" "00", 8);
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+Error ErrnoToError(int errNo)
+{
+    switch (errNo) {
+    case ENOENT:
+        return Error(ErrorEnum::eNotFound, strerror(errNo));
+
+    case EEXIST:
+    case ENOTEMPTY:
+        return Error(ErrorEnum::eAlreadyExist, strerror(errNo));
+
+    case ENOSPC:
+    case ENOMEM:
+        return Error(ErrorEnum::eNoMemory, strerror(errNo));
+
+    default:
+        return Error(ErrorEnum::eFailed, strerror(errNo));
+    }
+}
+
+std::string_view GetString(const char* block, const Field& field)
+{
+    std::string_view str(block + field.mOffset, field.mSize);
+
+    return str.substr(0, str.find('\0'));
+}
+
+RetWithError<uint64_t> GetNumber(const char* block, const Field& field)
+{
+    const auto* data  = reinterpret_cast<const uint8_t*>(block + field.mOffset);
+    uint64_t    value = 0;
+
+    // GNU base-256 encoding: the first byte has the high bit set, the second highest bit is the sign.
+    if (data[0] & 0x80) {
+        if (data[0] & 0x40) {
+            return {0, Error(ErrorEnum::eFailed, "negative number in tar header")};
+        }
+
+        value = data[0] & 0x3f;
+
+        for (size_t i = 1; i < field.mSize; i++) {
+            if (value > (std::numeric_limits<uint64_t>::max() >> 8)) {
+                return {0, Error(ErrorEnum::eFailed, "number in tar header is too big")};
+            }
+
+            value = (value << 8) | data[i];
+        }
+
+        return value;
+    }
+
+    size_t i = 0;
+
+    for (; i < field.mSize && (data[i] == ' ' || data[i] == '\0'); i++) { }
+
+    for (; i < field.mSize && data[i] >= '0' && data[i] <= '7'; i++) {
+        if (value > (std::numeric_limits<uint64_t>::max() >> 3)) {
+            return {0, Error(ErrorEnum::eFailed, "number in tar header is too big")};
+        }
+
+        value = (value << 3) | (data[i] - '0');
+    }
+
+    for (; i < field.mSize; i++) {
+        if (data[i] != ' ' && data[i] != '\0') {
+            return {0, Error(ErrorEnum::eFailed, "invalid number in tar header")};
+        }
+    }
+
+    return value;
+}
+
+bool IsZeroBlock(const char* block)
+{
+    return std::all_of(block, block + TarReader::cBlockSize, [](char c) { return c == '\0'; });
+}
+
+Error VerifyChecksum(const char* block)
+{
+    auto [checksum, err] = GetNumber(block, cChecksumField);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    uint64_t unsignedSum = 0;
+    int64_t  signedSum   = 0;
+
+    for (size_t i = 0; i < TarReader::cBlockSize; i++) {
+        const bool inField = i >= cChecksumField.mOffset && i < cChecksumField.mOffset + cChecksumField.mSize;
+
+        unsignedSum += inField ? ' ' : static_cast<uint8_t>(block[i]);
+        signedSum += inField ? ' ' : static_cast<int8_t>(block[i]);
+    }
+
+    // Some old archivers computed the checksum with signed chars.
+    if (checksum != unsignedSum && static_cast<int64_t>(checksum) != signedSum) {
+        return Error(ErrorEnum::eInvalidChecksum, "tar header checksum mismatch");
+    }
+
+    return ErrorEnum::eNone;
+}
+
+template <typename T>
+bool ParseDecimal(std::string_view str, T& value)
+{
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+
+    return ec == std::errc() && ptr == str.data() + str.size();
+}
+
+bool ParsePaxTime(std::string_view str, timespec& time)
+{
+    const auto dot     = str.find('.');
+    int64_t    seconds = 0;
+    long       nsec    = 0;
+
+    if (!ParseDecimal(str.substr(0, dot), seconds)) {
+        return false;
+    }
+
+    if (dot != std::string_view::npos) {
+        auto fraction = str.substr(dot + 1);
+
+        if (fraction.empty()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < fraction.size(); i++) {
+            if (fraction[i] < '0' || fraction[i] > '9') {
+                return false;
+            }
+
+            if (i < 9) {
+                nsec = nsec * 10 + (fraction[i] - '0');
+            }
+        }
+
+        for (auto i = fraction.size(); i < 9; i++) {
+            nsec *= 10;
+        }
+
+        // Fraction of negative time is subtracted: -1.25 is 1.25 seconds before the epoch.
+        if (str[0] == '-' && nsec != 0) {
+            seconds--;
+            nsec = 1000000000 - nsec;
+        }
+    }
+
+    time.tv_sec  = static_cast<time_t>(seconds);
+    time.tv_nsec = nsec;
+
+    return true;
+}
+
+std::pair<std::string_view, std::string> SplitPath(std::string_view path)
+{
+    const auto pos = path.rfind('/');
+
+    if (pos == std::string_view::npos) {
+        return {{}, std::string(path)};
+    }
+
+    return {path.substr(0, pos), std::string(path.substr(pos + 1))};
+}
+
+Error WriteAll(int fd, std::string_view data)
+{
+    while (!data.empty()) {
+        const auto written = write(fd, data.data(), data.size());
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return ErrnoToError(errno);
+        }
+
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+
+    return ErrorEnum::eNone;
+}
+
+template <typename CreateFunc>
+int CreateReplacing(int parentFD, const char* name, CreateFunc create)
+{
+    auto res = create();
+
+    if (res < 0 && errno == EEXIST) {
+        if (unlinkat(parentFD, name, 0) != 0) {
+            // EISDIR from unlink means the existing entry is a directory which is never replaced by a non-directory.
+            if (errno == EISDIR) {
+                errno = EEXIST;
+            }
+
+            return -1;
+        }
+
+        res = create();
+    }
+
+    return res;
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * TarReader
+ **********************************************************************************************************************/
+
+TarReader::TarReader(int fd, size_t bufferSize)
+    : TarReader(
+        [fd](char* data, size_t size) -> RetWithError<size_t> {
+            while (true) {
+                const auto res = read(fd, data, size);
+
+                if (res >= 0) {
+                    return static_cast<size_t>(res);
+                }
+
+                if (errno != EINTR) {
+                    return {0, ErrnoToError(errno)};
+                }
+            }
+        },
+        bufferSize)
+{
+    struct stat st {};
+
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return;
+    }
+
+    mSeek = [fd, fileSize = st.st_size](uint64_t size) -> Error {
+        const auto offset = lseek(fd, static_cast<off_t>(size), SEEK_CUR);
+
+        if (offset < 0) {
+            return ErrnoToError(errno);
+        }
+
+        if (offset > fileSize) {
+            return Error(ErrorEnum::eFailed, "unexpected end of archive");
+        }
+
+        return ErrorEnum::eNone;
+    };
+}
+
+TarReader::TarReader(std::istream& in, size_t bufferSize)
+    : TarReader(
+        [&in](char* data, size_t size) -> RetWithError<size_t> {
+            in.read(data, static_cast<std::streamsize>(size));
+
+            if (in.bad()) {
+                return {0, Error(ErrorEnum::eFailed, "stream read error")};
+            }
+
+            return static_cast<size_t>(in.gcount());
+        },
+        bufferSize)
+{
+}
+
+TarReader::TarReader(ReadFunc read, size_t bufferSize)
+    : mRead(std::move(read))
+    , mBuffer(std::max(bufferSize, cBlockSize))
+{
+}
+
+Error TarReader::Next(TarEntry& entry)
+{
+    if (mEnded) {
+        return ErrorEnum::eNotFound;
+    }
+
+    if (auto err = Skip(mRemaining + mPadding); !err.IsNone()) {
+        return err;
+    }
+
+    mRemaining = 0;
+    mPadding   = 0;
+
+    PaxHeaders  localHeaders;
+    std::string longName, longLink;
+    bool        extended = false;
+
+    while (true) {
+        const char* block = nullptr;
+
+        if (auto err = ReadBlock(block); !err.IsNone()) {
+            return err;
+        }
+
+        if (block == nullptr || IsZeroBlock(block)) {
+            if (extended) {
+                return Error(ErrorEnum::eFailed, "unexpected end of archive");
+            }
+
+            mEnded = true;
+
+            return ErrorEnum::eNotFound;
+        }
+
+        TarEntry header;
+        char     typeflag = '\0';
+
+        if (auto err = ParseHeader(block, header, typeflag); !err.IsNone()) {
+            return err;
+        }
+
+        const auto padding = (cBlockSize - header.mSize % cBlockSize) % cBlockSize;
+
+        switch (typeflag) {
+        case 'x':
+        case 'g':
+        case 'L':
+        case 'K': {
+            std::string data;
+
+            if (auto err = ReadExtended(header.mSize, data); !err.IsNone()) {
+                return err;
+            }
+
+            if (auto err = Skip(padding); !err.IsNone()) {
+                return err;
+            }
+
+            if (typeflag == 'x' || typeflag == 'g') {
+                if (auto err = ParsePax(data, typeflag == 'x' ? localHeaders : mGlobalHeaders); !err.IsNone()) {
+                    return err;
+                }
+            } else {
+                data.resize(std::strlen(data.c_str()));
+                (typeflag == 'L' ? longName : longLink) = std::move(data);
+            }
+
+            extended = extended || typeflag != 'g';
+
+            continue;
+        }
+
+        case 'V':
+            if (auto err = Skip(header.mSize + padding); !err.IsNone()) {
+                return err;
+            }
+
+            continue;
+
+        case 'S':
+            return Error(ErrorEnum::eNotSupported, "sparse files are not supported");
+
+        default:
+            break;
+        }
+
+        if (!longName.empty()) {
+            header.mPath = std::move(longName);
+        }
+
+        if (!longLink.empty()) {
+            header.mLinkPath = std::move(longLink);
+        }
+
+        if (auto err = ApplyPax(mGlobalHeaders, header); !err.IsNone()) {
+            return err;
+        }
+
+        if (auto err = ApplyPax(localHeaders, header); !err.IsNone()) {
+            return err;
+        }
+
+        header.mOffset = mOffset;
+        mRemaining     = header.mSize;
+        mPadding       = (cBlockSize - header.mSize % cBlockSize) % cBlockSize;
+        entry          = std::move(header);
+
+        return ErrorEnum::eNone;
+    }
+}
+
+Error TarReader::ReadData(const DataHandler& handler)
+{
+    while (mRemaining > 0) {
+        if (auto err = Fill(1); !err.IsNone()) {
+            return err;
+        }
+
+        if (mStart == mEnd) {
+            return Error(ErrorEnum::eFailed, "unexpected end of archive");
+        }
+
+        const auto size = static_cast<size_t>(std::min<uint64_t>(mEnd - mStart, mRemaining));
+        const auto err  = handler(std::string_view(mBuffer.data() + mStart, size));
+
+        Consume(size);
+        mRemaining -= size;
+
+        if (!err.IsNone()) {
+            return err;
+        }
+    }
+
+    return ErrorEnum::eNone;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+Error TarReader::ReadBlock(const char*& block)
+{
+    if (auto err = Fill(cBlockSize); !err.IsNone()) {
+        return err;
+    }
+
+    if (mStart == mEnd) {
+        block = nullptr;
+
+        return ErrorEnum::eNone;
+    }
+
+    if (mEnd - mStart < cBlockSize) {
+        return Error(ErrorEnum::eFailed, "unexpected end of archive");
+    }
+
+    block = mBuffer.data() + mStart;
+
+    Consume(cBlockSize);
+
+    return ErrorEnum::eNone;
+}
+
+Error TarReader::ReadExtended(uint64_t size, std::string& data)
+{
+    if (size > cMaxExtendedHeaderSize) {
+        return Error(ErrorEnum::eOutOfRange, "tar extended header is too big");
+    }
+
+    data.clear();
+    data.reserve(size);
+
+    while (data.size() < size) {
+        if (auto err = Fill(1); !err.IsNone()) {
+            return err;
+        }
+
+        if (mStart == mEnd) {
+            return Error(ErrorEnum::eFailed, "unexpected end of archive");
+        }
+
+        const auto chunk = std::min(mEnd - mStart, static_cast<size_t>(size) - data.size());
+
+        data.append(mBuffer.data() + mStart, chunk);
+        Consume(chunk);
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error TarReader::Skip(uint64_t size)
+{
+    while (size > 0) {
+        if (mStart == mEnd) {
+            // Data bigger than the buffer is skipped without reading.
+            if (mSeek && !mEOF && size >= mBuffer.size()) {
+                if (auto err = mSeek(size); !err.IsNone()) {
+                    return err;
+                }
+
+                mOffset += size;
+
+                return ErrorEnum::eNone;
+            }
+
+            if (auto err = Fill(1); !err.IsNone()) {
+                return err;
+            }
+
+            if (mStart == mEnd) {
+                return Error(ErrorEnum::eFailed, "unexpected end of archive");
+            }
+        }
+
+        const auto chunk = static_cast<size_t>(std::min<uint64_t>(mEnd - mStart, size));
+
+        Consume(chunk);
+        size -= chunk;
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error TarReader::Fill(size_t size)
+{
+    if (mEnd - mStart >= size) {
+        return ErrorEnum::eNone;
+    }
+
+    if (mStart > 0) {
+        std::memmove(mBuffer.data(), mBuffer.data() + mStart, mEnd - mStart);
+
+        mEnd -= mStart;
+        mStart = 0;
+    }
+
+    while (mEnd < size && !mEOF) {
+        auto [read, err] = mRead(mBuffer.data() + mEnd, mBuffer.size() - mEnd);
+        if (!err.IsNone()) {
+            return err;
+        }
+
+        if (read == 0) {
+            mEOF = true;
+        }
+
+        mEnd += read;
+    }
+
+    return ErrorEnum::eNone;
+}
+
+void TarReader::Consume(size_t size)
+{
+    mStart += size;
+    mOffset += size;
+}
+
+Error TarReader::ParseHeader(const char* block, TarEntry& entry, char& typeflag)
+{
+    if (auto err = VerifyChecksum(block); !err.IsNone()) {
+        return err;
+    }
+
+    const Field* fields[]
+        = {&cModeField, &cUIDField, &cGIDField, &cSizeField, &cMTimeField, &cDevMajorField, &cDevMinorField};
+    uint64_t     values[std::size(fields)] {};
+
+    for (size_t i = 0; i < std::size(fields); i++) {
+        Error err;
+
+        Tie(values[i], err) = GetNumber(block, *fields[i]);
+        if (!err.IsNone()) {
+            return err;
+        }
+    }
+
+    entry.mMode          = static_cast<mode_t>(values[0] & 07777);
+    entry.mUID           = static_cast<uid_t>(values[1]);
+    entry.mGID           = static_cast<gid_t>(values[2]);
+    entry.mSize          = values[3];
+    entry.mMTime.tv_sec  = static_cast<time_t>(values[4]);
+    entry.mMTime.tv_nsec = 0;
+    entry.mDevMajor      = static_cast<uint32_t>(values[5]);
+    entry.mDevMinor      = static_cast<uint32_t>(values[6]);
+    entry.mPath          = GetString(block, cNameField);
+    entry.mLinkPath      = GetString(block, cLinkNameField);
+
+    // Prefix field is defined by POSIX ustar only, old GNU format uses this space for other data.
+    if (std::string_view(block + cMagicField.mOffset, cMagicField.mSize) == cUstarMagic) {
+        if (auto prefix = GetString(block, cPrefixField); !prefix.empty()) {
+            entry.mPath = std::string(prefix) + "/" + entry.mPath;
+        }
+    }
+
+    typeflag = block[cTypeFlagOffset];
+
+    switch (typeflag) {
+    case '1':
+        entry.mType = TarEntry::Type::eHardLink;
+        break;
+
+    case '2':
+        entry.mType = TarEntry::Type::eSymLink;
+        break;
+
+    case '3':
+        entry.mType = TarEntry::Type::eCharDevice;
+        break;
+
+    case '4':
+        entry.mType = TarEntry::Type::eBlockDevice;
+        break;
+
+    case '5':
+    case 'D':
+        entry.mType = TarEntry::Type::eDirectory;
+        break;
+
+    case '6':
+        entry.mType = TarEntry::Type::eFifo;
+        break;
+
+    default:
+        // POSIX: unknown types are extracted as regular files.
+        entry.mType = TarEntry::Type::eFile;
+        break;
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error TarReader::ParsePax(std::string_view data, PaxHeaders& headers)
+{
+    // Each record is "<length> <key>=<value>\n" where length includes the whole record.
+    while (!data.empty()) {
+        const auto space  = data.find(' ');
+        size_t     length = 0;
+
+        if (space == std::string_view::npos || !ParseDecimal(data.substr(0, space), length) || length <= space + 2
+            || length > data.size() || data[length - 1] != '\n') {
+            return Error(ErrorEnum::eFailed, "invalid pax header");
+        }
+
+        const auto record = data.substr(space + 1, length - space - 2);
+        const auto equal  = record.find('=');
+
+        if (equal == std::string_view::npos || equal == 0) {
+            return Error(ErrorEnum::eFailed, "invalid pax header");
+        }
+
+        headers[std::string(record.substr(0, equal))] = record.substr(equal + 1);
+
+        data.remove_prefix(length);
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error TarReader::ApplyPax(const PaxHeaders& headers, TarEntry& entry)
+{
+    for (const auto& [key, value] : headers) {
+        // Empty value removes the header.
+        if (value.empty()) {
+            continue;
+        }
+
+        bool valid = true;
+
+        if (key == "path") {
+            entry.mPath = value;
+        } else if (key == "linkpath") {
+            entry.mLinkPath = value;
+        } else if (key == "size") {
+            valid = ParseDecimal(value, entry.mSize);
+        } else if (key == "uid") {
+            valid = ParseDecimal(value, entry.mUID);
+        } else if (key == "gid") {
+            valid = ParseDecimal(value, entry.mGID);
+        } else if (key == "mtime") {
+            valid = ParsePaxTime(value, entry.mMTime);
+        } else if (key.compare(0, 11, "GNU.sparse.") == 0) {
+            return Error(ErrorEnum::eNotSupported, "sparse files are not supported");
+        }
+
+        if (!valid) {
+            return Error(ErrorEnum::eFailed, "invalid pax header value");
+        }
+    }
+
+    return ErrorEnum::eNone;
+}
+
+/***********************************************************************************************************************
+ * TarExtractor
+ **********************************************************************************************************************/
+
+TarExtractor::~TarExtractor()
+{
+    CloseParent();
+
+    if (mRootFD >= 0) {
+        close(mRootFD);
+    }
+}
+
+Error TarExtractor::Open(const std::string& destination, bool sync)
+{
+    if (mRootFD >= 0) {
+        return Error(ErrorEnum::eWrongState, "extractor is already opened");
+    }
+
+    mRootFD = open(destination.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (mRootFD < 0) {
+        return ErrnoToError(errno);
+    }
+
+    mSync = sync;
+    mRoot = geteuid() == 0;
+
+    return ErrorEnum::eNone;
+}
+
+Error TarExtractor::Extract(TarReader& reader, const TarEntry& entry, const TarReader::DataHandler& observer)
+{
+    if (mRootFD < 0) {
+        return Error(ErrorEnum::eWrongState, "extractor is not opened");
+    }
+
+    auto [path, err] = NormalizeTarPath(entry.mPath);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    // Entry for the destination directory itself.
+    if (path.empty()) {
+        return ErrorEnum::eNone;
+    }
+
+    int parentFD = -1;
+
+    Tie(parentFD, err) = OpenParent(path);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    const auto name = SplitPath(path).second;
+
+    switch (entry.mType) {
+    case TarEntry::Type::eFile:
+        return ExtractFile(reader, entry, observer, parentFD, name.c_str());
+
+    case TarEntry::Type::eDirectory:
+        return ExtractDirectory(entry, path, parentFD, name.c_str());
+
+    case TarEntry::Type::eHardLink:
+        return ExtractHardLink(entry, parentFD, name.c_str());
+
+    case TarEntry::Type::eSymLink:
+        if (CreateReplacing(parentFD, name.c_str(),
+                [&]() { return symlinkat(entry.mLinkPath.c_str(), parentFD, name.c_str()); })
+            != 0) {
+            return ErrnoToError(errno);
+        }
+
+        break;
+
+    case TarEntry::Type::eCharDevice:
+    case TarEntry::Type::eBlockDevice:
+    case TarEntry::Type::eFifo: {
+        const mode_t type = entry.mType == TarEntry::Type::eCharDevice ? S_IFCHR
+            : entry.mType == TarEntry::Type::eBlockDevice              ? S_IFBLK
+                                                                       : S_IFIFO;
+        const auto   dev  = makedev(entry.mDevMajor, entry.mDevMinor);
+
+        if (CreateReplacing(parentFD, name.c_str(),
+                [&]() { return mknodat(parentFD, name.c_str(), type | (entry.mMode & 0777), dev); })
+            != 0) {
+            return ErrnoToError(errno);
+        }
+
+        break;
+    }
+    }
+
+    return SetAttributes(entry, parentFD, name.c_str());
+}
+
+Error TarExtractor::Close()
+{
+    if (mRootFD < 0) {
+        return Error(ErrorEnum::eWrongState, "extractor is not opened");
+    }
+
+    Error err;
+
+    // Apply in reverse order: setting attributes of nested directories doesn't change parent modification time.
+    for (auto it = mDirectories.rbegin(); it != mDirectories.rend() && err.IsNone(); ++it) {
+        auto [parentFD, openErr] = OpenParent(it->mPath);
+        if (!openErr.IsNone()) {
+            err = openErr;
+
+            break;
+        }
+
+        const auto name  = SplitPath(it->mPath).second;
+        TarEntry   entry;
+        struct stat st {};
+
+        entry.mType  = TarEntry::Type::eDirectory;
+        entry.mMode  = it->mMode;
+        entry.mUID   = it->mUID;
+        entry.mGID   = it->mGID;
+        entry.mMTime = it->mMTime;
+
+        // Without root privileges umask applied on creation is kept for group and others.
+        if (!mRoot) {
+            if (fstatat(parentFD, name.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                err = ErrnoToError(errno);
+
+                break;
+            }
+
+            entry.mMode = (st.st_mode & 0077) | (it->mMode & 0700);
+        }
+
+        err = SetAttributes(entry, parentFD, name.c_str());
+    }
+
+    mDirectories.clear();
+    CloseParent();
+
+    if (mSync && err.IsNone()) {
+        const auto fd = openat(mRootFD, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        if (fd < 0 || syncfs(fd) != 0) {
+            err = ErrnoToError(errno);
+        }
+
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    close(mRootFD);
+    mRootFD = -1;
+
+    return err;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+RetWithError<int> TarExtractor::OpenDir(std::string_view path, bool create)
+{
+    auto fd = openat(mRootFD, ".", O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return {-1, ErrnoToError(errno)};
+    }
+
+    while (!path.empty()) {
+        const auto end  = path.find('/');
+        const auto name = std::string(path.substr(0, end));
+        auto       next = openat(fd, name.c_str(), O_PATH | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+
+        if (next < 0 && errno == ENOENT && create) {
+            if (mkdirat(fd, name.c_str(), 0777) == 0 || errno == EEXIST) {
+                next = openat(fd, name.c_str(), O_PATH | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            }
+        }
+
+        const auto errNo = errno;
+
+        close(fd);
+
+        if (next < 0) {
+            if (errNo == ELOOP || errNo == ENOTDIR) {
+                return {-1, Error(ErrorEnum::eInvalidArgument, "path component is not a directory")};
+            }
+
+            return {-1, ErrnoToError(errNo)};
+        }
+
+        fd = next;
+
+        path.remove_prefix(end == std::string_view::npos ? path.size() : end + 1);
+    }
+
+    return fd;
+}
+
+RetWithError<int> TarExtractor::OpenParent(std::string_view path)
+{
+    const auto parent = SplitPath(path).first;
+
+    // Entries are usually grouped by directory, so the last parent is reused.
+    if (mParentFD >= 0 && parent == mParentPath) {
+        return mParentFD;
+    }
+
+    CloseParent();
+
+    auto [fd, err] = OpenDir(parent, true);
+    if (!err.IsNone()) {
+        return {-1, err};
+    }
+
+    mParentFD   = fd;
+    mParentPath = parent;
+
+    return mParentFD;
+}
+
+Error TarExtractor::ExtractFile(
+    TarReader& reader, const TarEntry& entry, const TarReader::DataHandler& observer, int parentFD, const char* name)
+{
+    const auto fd = CreateReplacing(parentFD, name, [&]() {
+        return openat(parentFD, name, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, entry.mMode & 0777);
+    });
+    if (fd < 0) {
+        return ErrnoToError(errno);
+    }
+
+    auto err = reader.ReadData([fd, &observer](std::string_view data) {
+        if (observer) {
+            if (auto err = observer(data); !err.IsNone()) {
+                return err;
+            }
+        }
+
+        return WriteAll(fd, data);
+    });
+
+    if (err.IsNone() && mRoot && fchown(fd, entry.mUID, entry.mGID) != 0) {
+        err = ErrnoToError(errno);
+    }
+
+    // Ownership change clears set-user-ID and set-group-ID bits, so permissions are set after it.
+    if (err.IsNone() && mRoot && fchmod(fd, entry.mMode) != 0) {
+        err = ErrnoToError(errno);
+    }
+
+    const timespec times[2] = {{0, UTIME_OMIT}, entry.mMTime};
+
+    if (err.IsNone() && futimens(fd, times) != 0) {
+        err = ErrnoToError(errno);
+    }
+
+    if (close(fd) != 0 && err.IsNone()) {
+        err = ErrnoToError(errno);
+    }
+
+    return err;
+}
+
+Error TarExtractor::ExtractDirectory(const TarEntry& entry, const std::string& path, int parentFD, const char* name)
+{
+    // Owner gets full access until attributes are applied on close.
+    if (mkdirat(parentFD, name, (entry.mMode & 0777) | S_IRWXU) != 0) {
+        struct stat st {};
+
+        if (errno != EEXIST || fstatat(parentFD, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            return ErrnoToError(errno);
+        }
+
+        if (!S_ISDIR(st.st_mode)) {
+            if (unlinkat(parentFD, name, 0) != 0 || mkdirat(parentFD, name, (entry.mMode & 0777) | S_IRWXU) != 0) {
+                return ErrnoToError(errno);
+            }
+        }
+    }
+
+    mDirectories.push_back({path, entry.mMode, entry.mUID, entry.mGID, entry.mMTime});
+
+    return ErrorEnum::eNone;
+}
+
+Error TarExtractor::ExtractHardLink(const TarEntry& entry, int parentFD, const char* name)
+{
+    auto [target, err] = NormalizeTarPath(entry.mLinkPath);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    if (target.empty()) {
+        return Error(ErrorEnum::eInvalidArgument, "invalid hard link target");
+    }
+
+    const auto [targetDir, targetName] = SplitPath(target);
+
+    int targetFD = -1;
+
+    Tie(targetFD, err) = OpenDir(targetDir, false);
+    if (!err.IsNone()) {
+        return err;
+    }
+
+    struct stat targetStat {}, st {};
+
+    // Link to itself: the file is already in place.
+    if (fstatat(targetFD, targetName.c_str(), &targetStat, AT_SYMLINK_NOFOLLOW) == 0
+        && fstatat(parentFD, name, &st, AT_SYMLINK_NOFOLLOW) == 0 && targetStat.st_dev == st.st_dev
+        && targetStat.st_ino == st.st_ino) {
+        close(targetFD);
+
+        return ErrorEnum::eNone;
+    }
+
+    if (CreateReplacing(parentFD, name, [&]() { return linkat(targetFD, targetName.c_str(), parentFD, name, 0); })
+        != 0) {
+        err = ErrnoToError(errno);
+    }
+
+    close(targetFD);
+
+    return err;
+}
+
+Error TarExtractor::SetAttributes(const TarEntry& entry, int parentFD, const char* name)
+{
+    if (mRoot && fchownat(parentFD, name, entry.mUID, entry.mGID, AT_SYMLINK_NOFOLLOW) != 0) {
+        return ErrnoToError(errno);
+    }
+
+    // Symlink permissions are not used on Linux.
+    if ((mRoot || entry.mType == TarEntry::Type::eDirectory) && entry.mType != TarEntry::Type::eSymLink
+        && fchmodat(parentFD, name, entry.mMode, 0) != 0) {
+        return ErrnoToError(errno);
+    }
+
+    const timespec times[2] = {{0, UTIME_OMIT}, entry.mMTime};
+
+    if (utimensat(parentFD, name, times, AT_SYMLINK_NOFOLLOW) != 0) {
+        return ErrnoToError(errno);
+    }
+
+    return ErrorEnum::eNone;
+}
+
+void TarExtractor::CloseParent()
+{
+    if (mParentFD >= 0) {
+        close(mParentFD);
+    }
+
+    mParentFD = -1;
+    mParentPath.clear();
+}
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+RetWithError<std::string> NormalizeTarPath(std::string_view path)
+{
+    std::string result;
+
+    if (path.find('\0') != std::string_view::npos) {
+        return {"", Error(ErrorEnum::eInvalidArgument, "path contains null character")};
+    }
+
+    result.reserve(path.size());
+
+    while (!path.empty()) {
+        const auto end       = path.find('/');
+        const auto component = path.substr(0, end);
+
+        if (component == "..") {
+            return {"", Error(ErrorEnum::eInvalidArgument, "path contains '..'")};
+        }
+
+        if (!component.empty() && component != ".") {
+            if (!result.empty()) {
+                result += '/';
+            }
+
+            result.append(component);
+        }
+
+        path.remove_prefix(end == std::string_view::npos ? path.size() : end + 1);
+    }
+
+    return result;
+}
+
+Error ExtractTar(TarReader& reader, const std::string& destination, bool sync)
+{
+    TarExtractor extractor;
+
+    if (auto err = extractor.Open(destination, sync); !err.IsNone()) {
+        return err;
+    }
+
+    TarEntry entry;
+
+    while (true) {
+        auto err = reader.Next(entry);
+        if (err.Is(ErrorEnum::eNotFound)) {
+            break;
+        }
+
+        if (!err.IsNone()) {
+            return err;
+        }
+
+        if (err = extractor.Extract(reader, entry); !err.IsNone()) {
+            return err;
+        }
+    }
+
+    return extractor.Close();
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,386 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/decompressor.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/tarindex.hpp"
+
+namespace aos::common::utils {
+
+namespace {
+
+/***********************************************************************************************************************
+ * Consts
+ **********************************************************************************************************************/
+
+// Index is a local cache, so numbers are stored in host byte order.
+constexpr std::string_view cIndexHeader = "aostarindex 1\n";
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+template <typename T>
+void Append(std::string& data, T value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool Take(std::string_view& data, T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    if (data.size() < sizeof(value)) {
+        return false;
+    }
+
+    memcpy(&value, data.data(), sizeof(value));
+    data.remove_prefix(sizeof(value));
+
+    return true;
+}
+
+bool TakeString(std::string_view& data, std::string& str)
+{
+    uint32_t size = 0;
+
+    if (!Take(data, size) || data.size() < size) {
+        return false;
+    }
+
+    str.assign(data.data(), size);
+    data.remove_prefix(size);
+
+    return true;
+}
+
+void AppendEntry(std::string& data, const TarEntry& entry)
+{
+    Append<uint64_t>(data, entry.mOffset);
+    Append<uint64_t>(data, entry.mSize);
+    Append<int64_t>(data, entry.mMTime.tv_sec);
+    Append<int64_t>(data, entry.mMTime.tv_nsec);
+    Append<uint32_t>(data, entry.mMode);
+    Append<uint32_t>(data, entry.mUID);
+    Append<uint32_t>(data, entry.mGID);
+    Append<uint32_t>(data, entry.mDevMajor);
+    Append<uint32_t>(data, entry.mDevMinor);
+    Append<uint8_t>(data, static_cast<uint8_t>(entry.mType));
+    Append<uint32_t>(data, static_cast<uint32_t>(entry.mPath.size()));
+    data.append(entry.mPath);
+    Append<uint32_t>(data, static_cast<uint32_t>(entry.mLinkPath.size()));
+    data.append(entry.mLinkPath);
+}
+
+bool TakeEntry(std::string_view& data, TarEntry& entry)
+{
+    int64_t  sec = 0, nsec = 0;
+    uint32_t mode = 0, uid = 0, gid = 0;
+    uint8_t  type = 0;
+
+    if (!Take(data, entry.mOffset) || !Take(data, entry.mSize) || !Take(data, sec) || !Take(data, nsec)
+        || !Take(data, mode) || !Take(data, uid) || !Take(data, gid) || !Take(data, entry.mDevMajor)
+        || !Take(data, entry.mDevMinor) || !Take(data, type) || !TakeString(data, entry.mPath)
+        || !TakeString(data, entry.mLinkPath)) {
+        return false;
+    }
+
+    if (type > static_cast<uint8_t>(TarEntry::Type::eFifo)) {
+        return false;
+    }
+
+    entry.mMTime = {static_cast<time_t>(sec), static_cast<long>(nsec)};
+    entry.mMode  = mode;
+    entry.mUID   = uid;
+    entry.mGID   = gid;
+    entry.mType  = static_cast<TarEntry::Type>(type);
+
+    return true;
+}
+
+} // namespace
+
+/***********************************************************************************************************************
+ * Public
+ **********************************************************************************************************************/
+
+TarIndex::~TarIndex()
+{
+    Close();
+}
+
+Error TarIndex::Open(const std::string& archivePath, const std::string& indexPath)
+{
+    Close();
+
+    mFD = open(archivePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (mFD < 0) {
+        return Error(errno == ENOENT ? ErrorEnum::eNotFound : ErrorEnum::eFailed, strerror(errno));
+    }
+
+    struct stat st {};
+
+    if (fstat(mFD, &st) != 0) {
+        auto err = Error(ErrorEnum::eFailed, strerror(errno));
+
+        Close();
+
+        return err;
+    }
+
+    const FileID id {static_cast<uint64_t>(st.st_ino), static_cast<uint64_t>(st.st_size),
+        static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec};
+    const auto path = indexPath.empty() ? archivePath + cTarIndexSuffix : indexPath;
+
+    mArchiveSize = id.mSize;
+
+    if (Load(path, id).IsNone()) {
+        return ErrorEnum::eNone;
+    }
+
+    if (auto err = Build(); !err.IsNone()) {
+        Close();
+
+        return err;
+    }
+
+    // Index is still usable if it can't be saved, the archive is scanned again on next open.
+    Save(path, id);
+
+    return ErrorEnum::eNone;
+}
+
+void TarIndex::Close()
+{
+    if (mFD >= 0) {
+        close(mFD);
+    }
+
+    mFD          = -1;
+    mArchiveSize = 0;
+
+    mEntries.clear();
+    mPaths.clear();
+}
+
+RetWithError<TarEntry> TarIndex::Find(std::string_view path) const
+{
+    auto [normalized, err] = NormalizeTarPath(path);
+    if (!err.IsNone()) {
+        return {{}, err};
+    }
+
+    auto it = mPaths.find(normalized);
+    if (it == mPaths.end()) {
+        return {{}, Error(ErrorEnum::eNotFound, "Entry not found")};
+    }
+
+    return mEntries[it->second];
+}
+
+RetWithError<size_t> TarIndex::Read(const TarEntry& entry, uint64_t offset, char* data, size_t size) const
+{
+    if (mFD < 0) {
+        return {0, Error(ErrorEnum::eWrongState, "Archive is not opened")};
+    }
+
+    if (entry.mType != TarEntry::Type::eFile) {
+        return {0, Error(ErrorEnum::eInvalidArgument, "Entry is not a regular file")};
+    }
+
+    if (offset >= entry.mSize) {
+        return 0;
+    }
+
+    const auto count = static_cast<size_t>(std::min<uint64_t>(size, entry.mSize - offset));
+
+    for (size_t done = 0; done < count;) {
+        const auto ret = pread(mFD, data + done, count - done, static_cast<off_t>(entry.mOffset + offset + done));
+
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (ret < 0) {
+            return {done, Error(ErrorEnum::eFailed, strerror(errno))};
+        }
+
+        if (ret == 0) {
+            return {done, Error(ErrorEnum::eFailed, "Unexpected end of archive")};
+        }
+
+        done += static_cast<size_t>(ret);
+    }
+
+    return count;
+}
+
+RetWithError<std::string> TarIndex::ReadFile(std::string_view path) const
+{
+    auto [entry, err] = Find(path);
+    if (!err.IsNone()) {
+        return {"", err};
+    }
+
+    if (entry.mType == TarEntry::Type::eHardLink) {
+        if (Tie(entry, err) = Find(entry.mLinkPath); !err.IsNone()) {
+            return {"", err};
+        }
+    }
+
+    std::string data(entry.mSize, '\0');
+
+    if (auto [count, readErr] = Read(entry, 0, data.data(), data.size()); !readErr.IsNone()) {
+        return {"", readErr};
+    }
+
+    return data;
+}
+
+/***********************************************************************************************************************
+ * Private
+ **********************************************************************************************************************/
+
+Error TarIndex::Build()
+{
+    char       header[8] {};
+    const auto size = pread(mFD, header, sizeof(header), 0);
+
+    if (size > 0 && DetectCompression(std::string_view(header, static_cast<size_t>(size))) != CompressionType::eNone) {
+        return Error(ErrorEnum::eNotSupported, "Compressed archive can't be indexed");
+    }
+
+    if (lseek(mFD, 0, SEEK_SET) < 0) {
+        return Error(ErrorEnum::eFailed, strerror(errno));
+    }
+
+    // Entry data is skipped by seeking, so only headers are read.
+    TarReader reader(mFD, TarReader::cBlockSize * 16);
+    TarEntry  entry;
+
+    while (true) {
+        auto err = reader.Next(entry);
+        if (err.Is(ErrorEnum::eNotFound)) {
+            break;
+        }
+
+        if (!err.IsNone()) {
+            return err;
+        }
+
+        mEntries.push_back(std::move(entry));
+        AddPath(mEntries.size() - 1);
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error TarIndex::Load(const std::string& indexPath, const FileID& id)
+{
+    MappedFile file;
+
+    if (auto err = file.Open(indexPath, true); !err.IsNone()) {
+        return err;
+    }
+
+    auto   data = file.View();
+    FileID indexID;
+    size_t count = 0;
+
+    if (data.substr(0, cIndexHeader.size()) != cIndexHeader) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid tar index");
+    }
+
+    data.remove_prefix(cIndexHeader.size());
+
+    if (!Take(data, indexID.mInode) || !Take(data, indexID.mSize) || !Take(data, indexID.mMTime)
+        || !Take(data, count)) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid tar index");
+    }
+
+    if (indexID.mInode != id.mInode || indexID.mSize != id.mSize || indexID.mMTime != id.mMTime) {
+        return Error(ErrorEnum::eInvalidArgument, "Tar index is outdated");
+    }
+
+    // Entry takes at least a header block, so the count is bounded by the archive size.
+    if (count > id.mSize / TarReader::cBlockSize) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid tar index");
+    }
+
+    mEntries.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const auto& entry = mEntries[i];
+
+        // Compare without adding so crafted offsets and sizes can't wrap around.
+        if (!TakeEntry(data, mEntries[i]) || entry.mOffset > id.mSize || entry.mSize > id.mSize - entry.mOffset) {
+            mEntries.clear();
+            mPaths.clear();
+
+            return Error(ErrorEnum::eInvalidArgument, "Invalid tar index");
+        }
+
+        AddPath(i);
+    }
+
+    if (!data.empty()) {
+        mEntries.clear();
+        mPaths.clear();
+
+        return Error(ErrorEnum::eInvalidArgument, "Invalid tar index");
+    }
+
+    return ErrorEnum::eNone;
+}
+
+Error TarIndex::Save(const std::string& indexPath, const FileID& id) const
+{
+    std::string data(cIndexHeader);
+
+    Append(data, id.mInode);
+    Append(data, id.mSize);
+    Append(data, id.mMTime);
+    Append<size_t>(data, mEntries.size());
+
+    for (const auto& entry : mEntries) {
+        AppendEntry(data, entry);
+    }
+
+    AtomicFile file;
+
+    if (auto err = file.Open(indexPath); !err.IsNone()) {
+        return err;
+    }
+
+    if (auto err = file.Write(data); !err.IsNone()) {
+        return err;
+    }
+
+    return file.Commit();
+}
+
+// Entries with unsafe paths are not extracted, so they can't be found by path.
+void TarIndex::AddPath(size_t index)
+{
+    if (auto [path, err] = NormalizeTarPath(mEntries[index].mPath); err.IsNone()) {
+        mPaths[path] = index;
+    }
+}
+
+} // namespace aos::common::utils
@@ -5,40 +5,89 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#include <map>
-#include <regex>
-#include <sstream>
+#include <cctype>
+#include <charconv>
+#include <string_view>
 
 #include "utils/time.hpp"
 
 namespace aos::common::utils {
 
+namespace {
+
+struct DurationUnit {
+    std::string_view         mName;
+    std::chrono::nanoseconds mValue;
+};
+
+// Units are matched in order: "ms" is tried before "m".
+const DurationUnit cDurationUnits[] = {{"ns", std::chrono::nanoseconds(1)}, {"us", std::chrono::microseconds(1)},
+    {"µs", std::chrono::microseconds(1)}, {"ms", std::chrono::milliseconds(1)}, {"s", std::chrono::seconds(1)},
+    {"m", std::chrono::minutes(1)}, {"h", std::chrono::hours(1)}, {"d", std::chrono::hours(24)},
+    {"w", std::chrono::hours(24 * 7)}, {"y", std::chrono::hours(24 * 365)}};
+
+} // namespace
+
+// Duration is a non-empty sequence of components: decimal number followed by unit.
 aos::RetWithError<Duration> ParseDuration(const std::string& durationStr)
 {
-    static const std::map<std::string, std::chrono::nanoseconds> units
-        = {{"ns", std::chrono::nanoseconds(1)}, {"us", std::chrono::microseconds(1)},
-            {"µs", std::chrono::microseconds(1)}, {"ms", std::chrono::milliseconds(1)}, {"s", std::chrono::seconds(1)},
-            {"m", std::chrono::minutes(1)}, {"h", std::chrono::hours(1)}, {"d", std::chrono::hours(24)},
-            {"w", std::chrono::hours(24 * 7)}, {"y", std::chrono::hours(24 * 365)}};
-
     std::chrono::nanoseconds totalDuration {};
-    std::regex               wholeStringPattern(R"((\d+(ns|us|µs|ms|s|m|h|d|w|y))+$)");
+    std::string_view         str        = durationStr;
+    bool                     outOfRange = false;
 
-    if (!std::regex_match(durationStr, wholeStringPattern)) {
-        return {totalDuration, aos::ErrorEnum::eInvalidArgument};
+    if (str.empty()) {
+        return {std::chrono::nanoseconds {}, aos::ErrorEnum::eInvalidArgument};
     }
 
-    std::regex           componentPattern(R"((\d+)(ns|us|µs|ms|s|m|h|d|w|y))");
-    auto                 begin = std::sregex_iterator(durationStr.begin(), durationStr.end(), componentPattern);
-    std::sregex_iterator end;
+    while (!str.empty()) {
+        if (!std::isdigit(static_cast<unsigned char>(str.front()))) {
+            return {std::chrono::nanoseconds {}, aos::ErrorEnum::eInvalidArgument};
+        }
+
+        int64_t value = 0;
+
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+
+        // Too big number is skipped, so the rest of the string is still validated.
+        if (ec == std::errc::result_out_of_range) {
+            outOfRange = true;
+
+            while (ptr != str.data() + str.size() && std::isdigit(static_cast<unsigned char>(*ptr))) {
+                ptr++;
+            }
+        }
 
-    for (auto i = begin; i != end; ++i) {
-        std::smatch match = *i;
-        std::string unit  = match[2].str();
+        str.remove_prefix(ptr - str.data());
 
-        std::transform(unit.begin(), unit.end(), unit.begin(), ::tolower);
+        const DurationUnit* unit = nullptr;
+
+        for (const auto& durationUnit : cDurationUnits) {
+            if (str.substr(0, durationUnit.mName.size()) == durationUnit.mName) {
+                unit = &durationUnit;
+
+                break;
+            }
+        }
+
+        if (unit == nullptr) {
+            return {std::chrono::nanoseconds {}, aos::ErrorEnum::eInvalidArgument};
+        }
+
+        str.remove_prefix(unit->mName.size());
+
+        int64_t component = 0;
+        int64_t total     = 0;
+
+        if (__builtin_mul_overflow(unit->mValue.count(), value, &component)
+            || __builtin_add_overflow(totalDuration.count(), component, &total)) {
+            outOfRange = true;
+        }
+
+        totalDuration = std::chrono::nanoseconds(total);
+    }
 
-        totalDuration += units.at(unit) * std::stoll(match[1].str());
+    if (outOfRange) {
+        return {std::chrono::nanoseconds {}, aos::ErrorEnum::eOutOfRange};
     }
 
     return totalDuration;
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILEUTILS_HPP_
+#define FILEUTILS_HPP_
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace aos::common::utils {
+
+/**
+ * Writes content to the file replacing it.
+ *
+ * @param path file path.
+ * @param content file content.
+ */
+inline void writeFile(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+/**
+ * Reads the whole file.
+ *
+ * @param path file path.
+ * @return std::string.
+ */
+inline std::string readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * Generates content of the given size. Its period is not a power of two, so misplaced blocks change the content.
+ *
+ * @param size content size.
+ * @return std::string.
+ */
+inline std::string makeContent(size_t size)
+{
+    std::string content;
+
+    content.reserve(size);
+
+    for (size_t i = 0; i < size; i++) {
+        content.push_back(static_cast<char>('a' + i % 23));
+    }
+
+    return content;
+}
+
+} // namespace aos::common::utils
+
+#endif
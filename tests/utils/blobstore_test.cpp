@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "utils/blobstore.hpp"
+#include "utils/digest.hpp"
+#include "utils/tarindex.hpp"
+
+using namespace testing;
+
+namespace fs = std::filesystem;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Suite
+ **********************************************************************************************************************/
+
+class BlobStoreTest : public Test {
+protected:
+    void SetUp() override
+    {
+        fs::remove_all(cStoreDir);
+        fs::create_directories(cSourceDir);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(cStoreDir);
+        fs::remove_all(cSourceDir);
+    }
+
+    // Creates source file and returns its digest.
+    Digest CreateFile(const std::string& name, size_t size)
+    {
+        const auto content = std::string(size, name.front());
+        Hasher     hasher;
+
+        std::ofstream(cSourceDir + "/" + name) << content;
+
+        hasher.Update(content);
+
+        return "sha256:" + hasher.Finish();
+    }
+
+    static inline const std::string cStoreDir  = "test_blob_store";
+    static inline const std::string cSourceDir = "test_blob_source";
+};
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST_F(BlobStoreTest, AddVerifiesDigest)
+{
+    BlobStore store;
+
+    ASSERT_EQ(store.Init(cStoreDir, 1000), ErrorEnum::eNone);
+
+    const auto digest = CreateFile("a", 100);
+
+    EXPECT_EQ(store.Add("sha256:" + std::string(64, '0'), cSourceDir + "/a"), ErrorEnum::eInvalidChecksum);
+    EXPECT_FALSE(store.Contains("sha256:" + std::string(64, '0')));
+    EXPECT_EQ(std::distance(fs::directory_iterator(cStoreDir + "/blobs/sha256"), fs::directory_iterator()), 0);
+
+    EXPECT_EQ(store.Add("sha256:1234", cSourceDir + "/a"), ErrorEnum::eInvalidArgument);
+    EXPECT_EQ(store.Add(digest, cSourceDir + "/missing"), ErrorEnum::eNotFound);
+    EXPECT_EQ(store.Add(CreateFile("b", 1001), cSourceDir + "/b"), ErrorEnum::eNoMemory);
+
+    ASSERT_EQ(store.Add(digest, cSourceDir + "/a"), ErrorEnum::eNone);
+    ASSERT_EQ(store.Add(digest, cSourceDir + "/a"), ErrorEnum::eNone);
+
+    // Algorithm is case-insensitive: the same blob is stored once.
+    const auto upperDigest = "SHA256" + digest.substr(digest.find(':'));
+
+    ASSERT_EQ(store.Add(upperDigest, cSourceDir + "/a"), ErrorEnum::eNone);
+
+    EXPECT_TRUE(store.Contains(digest));
+    EXPECT_TRUE(store.Contains(upperDigest));
+    EXPECT_EQ(store.GetSize(), 100);
+    EXPECT_EQ(std::distance(fs::directory_iterator(cStoreDir + "/blobs"), fs::directory_iterator()), 1);
+
+    auto [path, err] = store.Pin(digest);
+
+    ASSERT_EQ(err, ErrorEnum::eNone);
+    EXPECT_EQ(fs::file_size(path), 100);
+    EXPECT_EQ(store.Remove(digest), ErrorEnum::eWrongState);
+    EXPECT_EQ(store.Unpin(digest), ErrorEnum::eNone);
+    EXPECT_EQ(store.Unpin(digest), ErrorEnum::eWrongState);
+
+    std::ofstream(path + cTarIndexSuffix) << "index";
+
+    EXPECT_EQ(store.Remove(digest), ErrorEnum::eNone);
+
+    EXPECT_FALSE(fs::exists(path));
+    EXPECT_FALSE(fs::exists(path + cTarIndexSuffix));
+    EXPECT_EQ(store.GetSize(), 0);
+    EXPECT_EQ(store.Pin(digest).mError, ErrorEnum::eNotFound);
+}
+
+TEST_F(BlobStoreTest, EvictsLeastRecentlyUsed)
+{
+    BlobStore store;
+
+    ASSERT_EQ(store.Init(cStoreDir, 300), ErrorEnum::eNone);
+
+    const auto a = CreateFile("a", 100);
+    const auto b = CreateFile("b", 100);
+    const auto c = CreateFile("c", 100);
+    const auto d = CreateFile("d", 100);
+
+    ASSERT_EQ(store.Add(a, cSourceDir + "/a"), ErrorEnum::eNone);
+    ASSERT_EQ(store.Add(b, cSourceDir + "/b"), ErrorEnum::eNone);
+    ASSERT_EQ(store.Add(c, cSourceDir + "/c"), ErrorEnum::eNone);
+
+    // Pinned blob is not evicted, so the least recently used unpinned one is.
+    ASSERT_EQ(store.Pin(a).mError, ErrorEnum::eNone);
+    ASSERT_EQ(store.Pin(a).mError, ErrorEnum::eNone);
+    ASSERT_EQ(store.Add(d, cSourceDir + "/d"), ErrorEnum::eNone);
+
+    EXPECT_TRUE(store.Contains(a));
+    EXPECT_FALSE(store.Contains(b));
+    EXPECT_TRUE(store.Contains(c));
+    EXPECT_TRUE(store.Contains(d));
+
+    // Size limit may be exceeded by pinned blobs: the store is trimmed after the last unpin.
+    ASSERT_EQ(store.Pin(c).mError, ErrorEnum::eNone);
+    ASSERT_EQ(store.Pin(d).mError, ErrorEnum::eNone);
+    ASSERT_EQ(store.Add(b, cSourceDir + "/b"), ErrorEnum::eNone);
+
+    EXPECT_EQ(store.GetSize(), 400);
+
+    ASSERT_EQ(store.Unpin(a), ErrorEnum::eNone);
+
+    EXPECT_TRUE(store.Contains(a));
+
+    ASSERT_EQ(store.Unpin(a), ErrorEnum::eNone);
+
+    EXPECT_FALSE(store.Contains(a));
+    EXPECT_EQ(store.GetSize(), 300);
+}
+
+TEST_F(BlobStoreTest, LoadsIndex)
+{
+    std::vector<Digest> digests;
+
+    {
+        BlobStore store;
+
+        ASSERT_EQ(store.Init(cStoreDir, 1000), ErrorEnum::eNone);
+
+        for (const auto& name : {"a", "b", "c"}) {
+            digests.push_back(CreateFile(name, 100));
+
+            ASSERT_EQ(store.Add(digests.back(), cSourceDir + "/" + name), ErrorEnum::eNone);
+        }
+
+        ASSERT_EQ(store.Pin(digests[0]).mError, ErrorEnum::eNone);
+        ASSERT_EQ(store.Flush(), ErrorEnum::eNone);
+    }
+
+    // Usage order is restored: b is the least recently used blob.
+    BlobStore store;
+
+    ASSERT_EQ(store.Init(cStoreDir, 250), ErrorEnum::eNone);
+
+    EXPECT_TRUE(store.Contains(digests[0]));
+    EXPECT_FALSE(store.Contains(digests[1]));
+    EXPECT_TRUE(store.Contains(digests[2]));
+    EXPECT_EQ(store.GetSize(), 200);
+
+    // Index is rebuilt from blobs, temporary files are removed, tar indexes are kept and stray files are skipped.
+    std::ofstream(cStoreDir + "/index") << "corrupted";
+    std::ofstream(cStoreDir + "/blobs/stray") << "stray";
+    std::ofstream(cStoreDir + "/blobs/sha256/" + std::string(64, '0') + ".tmp") << "temporary";
+    std::ofstream(store.Pin(digests[0]).mValue + cTarIndexSuffix) << "index";
+
+    ASSERT_EQ(store.Unpin(digests[0]), ErrorEnum::eNone);
+
+    ASSERT_EQ(store.Init(cStoreDir, 1000), ErrorEnum::eNone);
+
+    EXPECT_TRUE(store.Contains(digests[0]));
+    EXPECT_TRUE(store.Contains(digests[2]));
+    EXPECT_EQ(store.GetSize(), 200);
+    EXPECT_EQ(std::distance(fs::directory_iterator(cStoreDir + "/blobs/sha256"), fs::directory_iterator()), 3);
+
+    // Index is synced with blobs removed or added without saving it.
+    const auto orphan = CreateFile("d", 100);
+
+    fs::remove(store.Pin(digests[2]).mValue);
+    ASSERT_EQ(store.Unpin(digests[2]), ErrorEnum::eNone);
+    fs::copy_file(cSourceDir + "/d", cStoreDir + "/blobs/sha256/" + orphan.substr(orphan.find(':') + 1));
+
+    ASSERT_EQ(store.Init(cStoreDir, 1000), ErrorEnum::eNone);
+
+    EXPECT_TRUE(store.Contains(digests[0]));
+    EXPECT_FALSE(store.Contains(digests[2]));
+    EXPECT_TRUE(store.Contains(orphan));
+    EXPECT_EQ(store.GetSize(), 200);
+    EXPECT_EQ(store.Pin(digests[2]).mError, ErrorEnum::eNotFound);
+}
+
+} // namespace aos::common::utils
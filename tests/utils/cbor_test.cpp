@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cmath>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <Poco/JSON/Array.h>
+
+#include "utils/cbor.hpp"
+#include "utils/json.hpp"
+#include "utils/jsonwriter.hpp"
+
+using namespace testing;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+static std::string fromHex(const std::string& hex)
+{
+    std::string result;
+
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        result += static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16));
+    }
+
+    return result;
+}
+
+static std::string toHex(const std::string& data)
+{
+    static const char cDigits[] = "0123456789abcdef";
+
+    std::string result;
+
+    for (auto c : data) {
+        result += cDigits[static_cast<uint8_t>(c) >> 4];
+        result += cDigits[static_cast<uint8_t>(c) & 0xf];
+    }
+
+    return result;
+}
+
+static std::string toJson(const Poco::Dynamic::Var& value)
+{
+    JsonWriter writer;
+
+    writer.Value(value);
+
+    return writer.TakeString();
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(CborTest, EncodesRFCVectors)
+{
+    const std::vector<std::pair<Poco::Dynamic::Var, std::string>> vectors = {
+        {0, "00"},
+        {23, "17"},
+        {24, "1818"},
+        {100, "1864"},
+        {1000, "1903e8"},
+        {1000000, "1a000f4240"},
+        {Poco::UInt64(1000000000000), "1b000000e8d4a51000"},
+        {Poco::UInt64(18446744073709551615ULL), "1bffffffffffffffff"},
+        {-1, "20"},
+        {-1000, "3903e7"},
+        {1.5, "fa3fc00000"},
+        {1.1, "fb3ff199999999999a"},
+        {1.0e300, "fb7e37e43c8800759c"},
+        {-1.0e300, "fbfe37e43c8800759c"},
+        {true, "f5"},
+        {Poco::Dynamic::Var(), "f6"},
+        {"a", "6161"},
+        {u8"ü", "62c3bc"},
+    };
+
+    for (const auto& [value, hex] : vectors) {
+        auto result = EncodeCbor(value);
+
+        ASSERT_TRUE(result.mError.IsNone());
+        EXPECT_EQ(toHex(result.mValue), hex);
+    }
+
+    auto json = ParseJson(R"({"a":[1,[2,3]]})");
+
+    ASSERT_TRUE(json.mError.IsNone());
+    EXPECT_EQ(toHex(EncodeCbor(json.mValue).mValue), "a161618201820203");
+
+    // Keys are encoded in insertion order if the object preserves it.
+    Poco::JSON::Object::Ptr object = new Poco::JSON::Object(Poco::JSON_PRESERVE_KEY_ORDER);
+
+    object->set("z", 1);
+    object->set("a", 2);
+
+    EXPECT_EQ(toHex(EncodeCbor(object).mValue), "a2617a01616102");
+}
+
+TEST(CborTest, DecodesRFCVectors)
+{
+    const std::vector<std::pair<std::string, std::string>> vectors = {
+        {"1bffffffffffffffff", "18446744073709551615"},
+        {"3903e7", "-1000"},
+        {"f93c00", "1"},
+        {"f9c400", "-4"},
+        {"fa47c35000", "1e+05"},
+        {"f4", "false"},
+        {"f7", "null"},
+        {"c11a514b67b0", "1363896240"},
+        {"5f42010243030405ff", "\"\\u0001\\u0002\\u0003\\u0004\\u0005\""},
+        {"7f657374726561646d696e67ff", R"("streaming")"},
+        {"9f018202039f0405ffff", "[1,[2,3],[4,5]]"},
+        {"bf61610161629f0203ffff", R"({"a":1,"b":[2,3]})"},
+    };
+
+    for (const auto& [hex, json] : vectors) {
+        auto result = DecodeCbor(fromHex(hex));
+
+        ASSERT_TRUE(result.mError.IsNone()) << hex;
+        EXPECT_EQ(toJson(result.mValue), json) << hex;
+    }
+
+    auto infinity = DecodeCbor(fromHex("f97c00"));
+
+    ASSERT_TRUE(infinity.mError.IsNone());
+    EXPECT_TRUE(std::isinf(infinity.mValue.convert<double>()));
+
+    EXPECT_TRUE(DecodeCbor(fromHex("3bffffffffffffffff")).mError.Is(ErrorEnum::eOutOfRange));
+
+    for (const auto& hex : {"", "1c", "8201", "62c3", "0000", "ff", "a10102", "9f01", "5f01ff"}) {
+        EXPECT_TRUE(DecodeCbor(fromHex(hex)).mError.Is(ErrorEnum::eInvalidArgument)) << hex;
+    }
+}
+
+TEST(CborTest, RoundTripsJson)
+{
+    const std::string json = R"({"string":"value \"escaped\" é","int":-42,"uint":18446744073709551615,)"
+                             R"("double":0.1,"float":2.5,"bool":true,"null":null,"array":[1,"two",[3],{}],)"
+                             R"("object":{"nested":{"deep":[]}}})";
+
+    auto parsed = ParseJson(json);
+
+    ASSERT_TRUE(parsed.mError.IsNone());
+
+    auto encoded = EncodeCbor(parsed.mValue);
+
+    ASSERT_TRUE(encoded.mError.IsNone());
+    EXPECT_LT(encoded.mValue.size(), json.size());
+
+    auto decoded = DecodeCbor(encoded.mValue);
+
+    ASSERT_TRUE(decoded.mError.IsNone());
+    EXPECT_EQ(toJson(decoded.mValue), toJson(parsed.mValue));
+
+    CaseInsensitiveObjectWrapper wrapper(decoded.mValue);
+
+    EXPECT_EQ(wrapper.GetValue<std::string>("STRING"), "value \"escaped\" é");
+    EXPECT_EQ(wrapper.GetValue<int>("int"), -42);
+    EXPECT_EQ(wrapper.GetValue<double>("double"), 0.1);
+    EXPECT_EQ(GetArrayValue<std::string>(wrapper.GetObject("object").GetObject("nested"), "deep").size(), 0);
+
+    const auto path = "test.cbor";
+
+    ASSERT_TRUE(WriteCborToFile(parsed.mValue.extract<Poco::JSON::Object::Ptr>(), path, true).IsNone());
+
+    auto file = ParseCborFile(path);
+
+    ASSERT_TRUE(file.mError.IsNone());
+    EXPECT_EQ(toJson(file.mValue), toJson(parsed.mValue));
+
+    std::remove(path);
+
+    EXPECT_TRUE(ParseCborFile(path).mError.Is(ErrorEnum::eNotFound));
+}
+
+TEST(CborTest, StreamsItems)
+{
+    std::string output;
+
+    CborEncoder encoder(
+        [&output](std::string_view data) {
+            output.append(data);
+
+            return ErrorEnum::eNone;
+        },
+        4);
+
+    encoder.BeginArray();
+
+    for (int i = 0; i < 100; i++) {
+        encoder.Value(i);
+    }
+
+    encoder.EndArray();
+    encoder.BeginObject(2).Key("key").Value("value").Key("list").BeginArray(1).Null().EndArray().EndObject();
+
+    ASSERT_TRUE(encoder.Flush().IsNone());
+
+    std::istringstream in(output);
+    CborDecoder        decoder(in, 3);
+    Poco::Dynamic::Var value;
+
+    ASSERT_TRUE(decoder.Next(value).IsNone());
+    ASSERT_EQ(value.extract<Poco::JSON::Array::Ptr>()->size(), 100);
+    EXPECT_EQ(value.extract<Poco::JSON::Array::Ptr>()->get(99).convert<int>(), 99);
+
+    ASSERT_TRUE(decoder.Next(value).IsNone());
+    EXPECT_EQ(toJson(value), R"({"key":"value","list":[null]})");
+
+    EXPECT_TRUE(decoder.Next(value).Is(ErrorEnum::eNotFound));
+
+    CborEncoder invalid;
+
+    EXPECT_TRUE(invalid.BeginArray(1).Value(1).Value(2).GetError().Is(ErrorEnum::eWrongState));
+
+    invalid.Reset();
+
+    EXPECT_TRUE(invalid.BeginObject(1).EndObject().GetError().Is(ErrorEnum::eWrongState));
+}
+
+} // namespace aos::common::utils
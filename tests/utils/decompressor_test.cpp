@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <zlib.h>
+#include <zstd.h>
+
+#include "utils/decompressor.hpp"
+
+using namespace testing;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+static std::string makeData(size_t size, size_t seed = 0)
+{
+    std::string data;
+
+    data.reserve(size);
+
+    // Compressible but not trivial data.
+    for (size_t i = 0; i < size; i++) {
+        data.push_back(static_cast<char>('a' + ((i + seed) * 2654435761u >> 20) % 8));
+    }
+
+    return data;
+}
+
+static std::string gzipCompress(const std::string& data)
+{
+    z_stream stream {};
+
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+
+    std::string result(deflateBound(&stream, data.size()), '\0');
+
+    stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in  = static_cast<uInt>(data.size());
+    stream.next_out  = reinterpret_cast<Bytef*>(result.data());
+    stream.avail_out = static_cast<uInt>(result.size());
+
+    deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return result;
+}
+
+static std::string zstdCompress(const std::string& data)
+{
+    std::string result(ZSTD_compressBound(data.size()), '\0');
+
+    result.resize(ZSTD_compress(result.data(), result.size(), data.data(), data.size(), 3));
+
+    return result;
+}
+
+// Compresses as a stream, so the frame has no content size.
+static std::string zstdCompressStream(const std::string& data)
+{
+    auto* context = ZSTD_createCCtx();
+
+    std::string    result(ZSTD_compressBound(data.size()), '\0');
+    ZSTD_inBuffer  in {data.data(), data.size(), 0};
+    ZSTD_outBuffer out {result.data(), result.size(), 0};
+
+    // Input passed before the end directive isn't counted as the frame content size.
+    ZSTD_compressStream2(context, &out, &in, ZSTD_e_continue);
+
+    while (ZSTD_compressStream2(context, &out, &in, ZSTD_e_end) != 0) { }
+
+    ZSTD_freeCCtx(context);
+    result.resize(out.pos);
+
+    return result;
+}
+
+static RetWithError<std::string> decompress(
+    CompressionType type, const std::string& compressed, size_t sourceChunk = 4096, size_t threads = 0)
+{
+    size_t       offset = 0;
+    Decompressor decompressor;
+
+    auto err = decompressor.Open(
+        type,
+        [&](char* data, size_t size) -> RetWithError<size_t> {
+            const auto count = std::min({size, sourceChunk, compressed.size() - offset});
+
+            compressed.copy(data, count, offset);
+            offset += count;
+
+            return count;
+        },
+        threads);
+    if (!err.IsNone()) {
+        return {"", err};
+    }
+
+    std::string result;
+    char        buffer[10000];
+
+    while (true) {
+        auto [count, readErr] = decompressor.Read(buffer, sizeof(buffer));
+        if (!readErr.IsNone()) {
+            return {result, readErr};
+        }
+
+        if (count == 0) {
+            return result;
+        }
+
+        result.append(buffer, count);
+    }
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(DecompressorTest, DetectCompression)
+{
+    EXPECT_EQ(DetectCompression(gzipCompress("data")), CompressionType::eGzip);
+    EXPECT_EQ(DetectCompression(zstdCompress("data")), CompressionType::eZstd);
+    EXPECT_EQ(DetectCompression("BZh91AY"), CompressionType::eBzip2);
+    EXPECT_EQ(DetectCompression(std::string("\xfd" "7zXZ\0\0", 7)), CompressionType::eXz);
+    EXPECT_EQ(DetectCompression("ustar"), CompressionType::eNone);
+    EXPECT_EQ(DetectCompression(""), CompressionType::eNone);
+
+    Decompressor decompressor;
+
+    EXPECT_EQ(decompressor.Open(CompressionType::eXz, nullptr), ErrorEnum::eNotSupported);
+}
+
+TEST(DecompressorTest, Gzip)
+{
+    const auto data = makeData(3 * Decompressor::cChunkSize + 123);
+
+    for (size_t sourceChunk : {1000, 1024 * 1024}) {
+        auto result = decompress(CompressionType::eGzip, gzipCompress(data), sourceChunk);
+
+        ASSERT_EQ(result.mError, ErrorEnum::eNone);
+        EXPECT_EQ(result.mValue, data);
+    }
+
+    // Concatenated members are decompressed as one stream.
+    auto result
+        = decompress(CompressionType::eGzip, gzipCompress("first ") + gzipCompress("") + gzipCompress("second"));
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+    EXPECT_EQ(result.mValue, "first second");
+
+    const auto compressed = gzipCompress(data);
+
+    EXPECT_FALSE(decompress(CompressionType::eGzip, compressed.substr(0, compressed.size() / 2)).mError.IsNone());
+    EXPECT_FALSE(decompress(CompressionType::eGzip, compressed.substr(0, 20) + "corrupted").mError.IsNone());
+}
+
+TEST(DecompressorTest, Zstd)
+{
+    // Frames with content size are decompressed in parallel, stream frames on the decompression thread.
+    std::string compressed;
+    std::string expected;
+
+    for (size_t i = 0; i < 20; i++) {
+        const auto data = makeData(i * 100000 + i, i);
+
+        compressed += i % 3 == 0 ? zstdCompressStream(data) : zstdCompress(data);
+        expected += data;
+    }
+
+    ASSERT_EQ(ZSTD_getFrameContentSize(compressed.data(), compressed.size()), ZSTD_CONTENTSIZE_UNKNOWN);
+
+    for (size_t threads : {1, 4}) {
+        for (size_t sourceChunk : {1000, 1024 * 1024}) {
+            auto result = decompress(CompressionType::eZstd, compressed, sourceChunk, threads);
+
+            ASSERT_EQ(result.mError, ErrorEnum::eNone);
+            EXPECT_EQ(result.mValue, expected);
+        }
+    }
+
+    // Frame bigger than the input buffer.
+    const auto data = makeData(3 * 1024 * 1024);
+
+    auto result = decompress(CompressionType::eZstd, zstdCompress(data), 100000);
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+    EXPECT_EQ(result.mValue, data);
+
+    for (const auto& frame : {zstdCompress(data), zstdCompressStream(data)}) {
+        EXPECT_FALSE(decompress(CompressionType::eZstd, frame.substr(0, frame.size() / 2)).mError.IsNone());
+        EXPECT_FALSE(decompress(CompressionType::eZstd, frame + "corrupted").mError.IsNone());
+    }
+}
+
+TEST(DecompressorTest, CloseBeforeEnd)
+{
+    const auto data = makeData(1000000);
+
+    for (auto type : {CompressionType::eGzip, CompressionType::eZstd}) {
+        const auto compressed = type == CompressionType::eGzip ? gzipCompress(data) : zstdCompress(data);
+        size_t     offset     = 0;
+
+        Decompressor decompressor;
+
+        // Endless source of concatenated members or frames.
+        auto err = decompressor.Open(type, [&](char* buffer, size_t size) -> RetWithError<size_t> {
+            const auto count = std::min(size, compressed.size() - offset);
+
+            compressed.copy(buffer, count, offset);
+            offset = (offset + count) % compressed.size();
+
+            return count;
+        });
+        ASSERT_EQ(err, ErrorEnum::eNone);
+
+        char buffer[100];
+
+        auto result = decompressor.Read(buffer, sizeof(buffer));
+
+        ASSERT_EQ(result.mError, ErrorEnum::eNone);
+        EXPECT_EQ(std::string(buffer, result.mValue), data.substr(0, result.mValue));
+
+        decompressor.Close();
+
+        EXPECT_EQ(decompressor.Read(buffer, sizeof(buffer)).mValue, 0);
+    }
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <Poco/DigestEngine.h>
+#include <Poco/SHA2Engine.h>
+
+#include "utils/digest.hpp"
+
+using namespace testing;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+static std::string hashData(HashAlgorithm algorithm, bool portable, const std::string& data, size_t chunkSize)
+{
+    Hasher hasher(algorithm, portable);
+
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+        hasher.Update(std::string_view(data).substr(offset, chunkSize));
+    }
+
+    return hasher.Finish();
+}
+
+static std::string pocoHash(HashAlgorithm algorithm, const std::string& data)
+{
+    const auto pocoAlgorithm = algorithm == HashAlgorithm::eSHA256 ? Poco::SHA2Engine::SHA_256
+        : algorithm == HashAlgorithm::eSHA384                      ? Poco::SHA2Engine::SHA_384
+                                                                   : Poco::SHA2Engine::SHA_512;
+
+    Poco::SHA2Engine engine(pocoAlgorithm);
+
+    engine.update(data);
+
+    return Poco::DigestEngine::digestToHex(engine.digest());
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(HasherTest, KnownVectors)
+{
+    Hasher hasher;
+
+    EXPECT_EQ(hasher.Finish(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    hasher.Update("abc");
+
+    EXPECT_EQ(hasher.Finish(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    hasher.Update(std::string(1000000, 'a'));
+
+    EXPECT_EQ(hasher.Finish(), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    Hasher sha384(HashAlgorithm::eSHA384);
+
+    sha384.Update("abc");
+
+    EXPECT_EQ(sha384.Finish(),
+        "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7");
+
+    Hasher sha512(HashAlgorithm::eSHA512);
+
+    sha512.Update("abc");
+
+    EXPECT_EQ(sha512.Finish(),
+        "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+        "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+}
+
+TEST(HasherTest, KernelsMatchPoco)
+{
+    std::string data;
+
+    for (size_t i = 0; i < 1000; i++) {
+        data.push_back(static_cast<char>((i * 2654435761u) >> 13));
+    }
+
+    for (auto algorithm : {HashAlgorithm::eSHA256, HashAlgorithm::eSHA384, HashAlgorithm::eSHA512}) {
+        // All lengths around block and padding boundaries, hashed at once and in odd chunks.
+        for (size_t size = 0; size <= 300; size++) {
+            const auto message  = data.substr(0, size);
+            const auto expected = pocoHash(algorithm, message);
+
+            for (auto portable : {false, true}) {
+                for (size_t chunkSize : {1, 7, 64, 1000}) {
+                    ASSERT_EQ(hashData(algorithm, portable, message, chunkSize), expected)
+                        << GetHashAlgorithmName(algorithm) << " size " << size << " chunk " << chunkSize;
+                }
+            }
+        }
+
+        EXPECT_EQ(hashData(algorithm, false, data, 333), pocoHash(algorithm, data));
+    }
+}
+
+TEST(HasherTest, ParseHashAlgorithm)
+{
+    for (auto algorithm : {HashAlgorithm::eSHA256, HashAlgorithm::eSHA384, HashAlgorithm::eSHA512}) {
+        auto result = ParseHashAlgorithm(GetHashAlgorithmName(algorithm));
+
+        ASSERT_EQ(result.mError, ErrorEnum::eNone);
+        EXPECT_EQ(result.mValue, algorithm);
+    }
+
+    EXPECT_EQ(ParseHashAlgorithm("md5").mError, ErrorEnum::eNotSupported);
+    EXPECT_STREQ(Hasher(HashAlgorithm::eSHA256, true).GetKernelName(), "portable");
+}
+
+} // namespace aos::common::utils
@@ -7,9 +7,15 @@
 
 #include <filesystem>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "utils/filesystem.hpp"
 
 using namespace testing;
@@ -91,4 +97,236 @@ TEST(MkTmpDirTest, PatternHandling)
     std::filesystem::remove_all(result.mValue);
 }
 
+TEST(MappedFileTest, MapsFile)
+{
+    std::string path    = "mapped_file.txt";
+    std::string content = "This is a test content";
+
+    std::ofstream(path) << content;
+
+    MappedFile file;
+
+    ASSERT_EQ(file.Open(path, true), aos::ErrorEnum::eNone);
+    EXPECT_EQ(file.View(), content);
+
+    file.Close();
+
+    EXPECT_EQ(file.Data(), nullptr);
+    EXPECT_EQ(file.Size(), 0);
+
+    std::ofstream(path, std::ios::trunc).close();
+
+    ASSERT_EQ(file.Open(path), aos::ErrorEnum::eNone);
+    EXPECT_EQ(file.Size(), 0);
+
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(file.Open(path), aos::ErrorEnum::eNotFound);
+}
+
+TEST(ReadFileDataTest, ReadsFile)
+{
+    std::string path    = "read_file.txt";
+    std::string content = "This is a test content";
+
+    std::ofstream(path) << content;
+
+    auto [data, err] = ReadFileData(path);
+
+    ASSERT_EQ(err, aos::ErrorEnum::eNone);
+    EXPECT_EQ(data, content);
+
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(ReadFileData(path).mError, aos::ErrorEnum::eNotFound);
+
+    // Procfs files report zero size.
+    Tie(data, err) = ReadFileData("/proc/self/status");
+
+    ASSERT_EQ(err, aos::ErrorEnum::eNone);
+    EXPECT_EQ(data.substr(0, 5), "Name:");
+}
+
+TEST(CopyFileDataTest, CopiesData)
+{
+    auto tmpDir = MkTmpDir();
+
+    ASSERT_EQ(tmpDir.mError, aos::ErrorEnum::eNone);
+
+    const auto source      = fs::path(tmpDir.mValue) / "source";
+    const auto destination = fs::path(tmpDir.mValue) / "destination";
+
+    std::string content;
+
+    for (size_t i = 0; i < 3 * 1024 * 1024 + 123; i++) {
+        content.push_back(static_cast<char>(i * 7));
+    }
+
+    std::ofstream(source, std::ios::binary) << content;
+
+    const auto inFD  = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    const auto outFD = open(destination.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+
+    ASSERT_GE(inFD, 0);
+    ASSERT_GE(outFD, 0);
+
+    auto result = CopyFileData(inFD, outFD);
+
+    ASSERT_EQ(result.mError, aos::ErrorEnum::eNone);
+    EXPECT_EQ(lseek(inFD, 0, SEEK_CUR), 0);
+
+    close(outFD);
+
+    // Directory is not a file.
+    const auto dirFD = open(tmpDir.mValue.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    EXPECT_FALSE(CopyFileData(dirFD, inFD).mError.IsNone());
+
+    close(dirFD);
+    close(inFD);
+
+    std::ifstream file(destination, std::ios::binary);
+
+    EXPECT_EQ(std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()), content);
+
+    fs::remove_all(tmpDir.mValue);
+}
+
+TEST(WalkFilesTest, WalksFilesSorted)
+{
+    auto tmpDir = MkTmpDir();
+
+    ASSERT_EQ(tmpDir.mError, aos::ErrorEnum::eNone);
+
+    const auto root = fs::path(tmpDir.mValue);
+
+    fs::create_directories(root / "b" / "c");
+    fs::create_directories(root / "empty");
+    fs::create_directories(root / "outside");
+
+    for (const auto& file : {"z", "a", "b/c/file", "b/a", "b-c", "outside/file"}) {
+        std::ofstream(root / file) << file;
+    }
+
+    mkfifo((root / "fifo").c_str(), 0644);
+    fs::create_symlink("z", root / "link");
+    fs::create_symlink("missing", root / "dangling");
+    fs::create_symlink("outside", root / "dirlink");
+
+    std::vector<std::string> files;
+
+    auto err = WalkFiles(tmpDir.mValue, [&](const WalkEntry& entry) -> aos::Error {
+        struct stat st {};
+
+        EXPECT_EQ(fstatat(entry.mDirFD, entry.mName, &st, 0), 0);
+        EXPECT_TRUE(S_ISREG(st.st_mode));
+
+        files.push_back(entry.mPath);
+
+        return aos::ErrorEnum::eNone;
+    });
+
+    ASSERT_EQ(err, aos::ErrorEnum::eNone);
+
+    // Symlinks to files are walked, symlinks to directories are not followed.
+    EXPECT_EQ(files, std::vector<std::string>({"a", "b/a", "b/c/file", "b-c", "link", "outside/file", "z"}));
+
+    // Handler error stops the walk.
+    files.clear();
+
+    err = WalkFiles(tmpDir.mValue, [&](const WalkEntry& entry) -> aos::Error {
+        files.push_back(entry.mPath);
+
+        return files.size() == 2 ? aos::ErrorEnum::eWrongState : aos::ErrorEnum::eNone;
+    });
+
+    EXPECT_EQ(files.size(), 2);
+    EXPECT_EQ(err, aos::ErrorEnum::eWrongState);
+
+    EXPECT_EQ(WalkFiles((root / "missing").string(), [](const WalkEntry&) { return aos::ErrorEnum::eNone; }),
+        aos::ErrorEnum::eNotFound);
+
+    fs::remove_all(tmpDir.mValue);
+}
+
+TEST(AtomicFileTest, ReplacesFile)
+{
+    auto tmpDir = MkTmpDir();
+
+    ASSERT_EQ(tmpDir.mError, aos::ErrorEnum::eNone);
+
+    const auto path = fs::path(tmpDir.mValue) / "atomic.txt";
+
+    std::ofstream(path) << "old content";
+    fs::permissions(path, fs::perms::owner_read | fs::perms::owner_write);
+
+    auto readFile = [&path]() {
+        std::ifstream file(path);
+
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+
+    AtomicFile file;
+
+    ASSERT_EQ(file.Open(path), aos::ErrorEnum::eNone);
+    ASSERT_EQ(file.Write("new "), aos::ErrorEnum::eNone);
+
+    EXPECT_EQ(readFile(), "old content");
+
+    file.Abort();
+
+    EXPECT_EQ(readFile(), "old content");
+    EXPECT_EQ(std::distance(fs::directory_iterator(tmpDir.mValue), fs::directory_iterator()), 1);
+
+    ASSERT_EQ(file.Open(path), aos::ErrorEnum::eNone);
+    ASSERT_EQ(file.Write("new "), aos::ErrorEnum::eNone);
+    ASSERT_EQ(file.Write("content"), aos::ErrorEnum::eNone);
+    ASSERT_EQ(file.Commit(true), aos::ErrorEnum::eNone);
+
+    EXPECT_EQ(readFile(), "new content");
+    EXPECT_EQ(fs::status(path).permissions(), fs::perms::owner_read | fs::perms::owner_write);
+    EXPECT_EQ(std::distance(fs::directory_iterator(tmpDir.mValue), fs::directory_iterator()), 1);
+
+    EXPECT_EQ(file.Write("data"), aos::ErrorEnum::eWrongState);
+    EXPECT_EQ(file.Open(fs::path(tmpDir.mValue) / "missing" / "atomic.txt"), aos::ErrorEnum::eFailed);
+
+    fs::remove_all(tmpDir.mValue);
+}
+
+TEST(AtomicFileTest, KeepsSymlinkAndUmask)
+{
+    auto tmpDir = MkTmpDir();
+
+    ASSERT_EQ(tmpDir.mError, aos::ErrorEnum::eNone);
+
+    const auto target = fs::path(tmpDir.mValue) / "target.txt";
+    const auto link   = fs::path(tmpDir.mValue) / "link.txt";
+    const auto mask   = umask(077);
+
+    AtomicFile file;
+
+    ASSERT_EQ(file.Open(target), aos::ErrorEnum::eNone);
+    ASSERT_EQ(file.Write("content"), aos::ErrorEnum::eNone);
+    ASSERT_EQ(file.Commit(), aos::ErrorEnum::eNone);
+
+    umask(mask);
+
+    EXPECT_EQ(fs::status(target).permissions(), fs::perms::owner_read | fs::perms::owner_write);
+
+    // Symlink is kept, the file it points to is replaced.
+    fs::create_symlink("target.txt", link);
+
+    ASSERT_EQ(file.Open(link), aos::ErrorEnum::eNone);
+    ASSERT_EQ(file.Write("new content"), aos::ErrorEnum::eNone);
+    ASSERT_EQ(file.Commit(), aos::ErrorEnum::eNone);
+
+    std::ifstream stream(target);
+
+    EXPECT_TRUE(fs::is_symlink(link));
+    EXPECT_EQ(std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>()), "new content");
+    EXPECT_EQ(fs::status(target).permissions(), fs::perms::owner_read | fs::perms::owner_write);
+
+    fs::remove_all(tmpDir.mValue);
+}
+
 } // namespace aos::common::utils
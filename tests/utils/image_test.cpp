@@ -5,16 +5,26 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <regex>
+#include <thread>
 
 #include <gtest/gtest.h>
 
+#include <Poco/DigestEngine.h>
+#include <Poco/DigestStream.h>
 #include <Poco/Pipe.h>
 #include <Poco/PipeStream.h>
 #include <Poco/Process.h>
+#include <Poco/SHA2Engine.h>
 #include <Poco/StreamCopier.h>
 
+#include <zstd.h>
+
 #include "utils/image.hpp"
 
 using namespace testing;
@@ -54,6 +64,48 @@ static void createTestTarFile(
     fs::remove(contentFilePath);
 }
 
+static std::string hashFile(const std::string& path, const std::string& algorithm = "sha256")
+{
+    const auto pocoAlgorithm = algorithm == "sha512" ? Poco::SHA2Engine::SHA_512
+        : algorithm == "sha384"                      ? Poco::SHA2Engine::SHA_384
+                                                     : Poco::SHA2Engine::SHA_256;
+
+    std::ifstream            fileStream(path, std::ios::binary);
+    Poco::SHA2Engine         h(pocoAlgorithm);
+    Poco::DigestOutputStream dos(h);
+
+    Poco::StreamCopier::copyStream(fileStream, dos);
+    dos.close();
+
+    return algorithm + ":" + Poco::DigestEngine::digestToHex(h.digest());
+}
+
+// Former regex based implementation used as the reference.
+static Error validateDigestRegex(const Digest& digest)
+{
+    static const std::map<std::string, std::regex> regexps = {{"sha256", std::regex(R"(^[a-f0-9]{64}$)")},
+        {"sha384", std::regex(R"(^[a-f0-9]{96}$)")}, {"sha512", std::regex(R"(^[a-f0-9]{128}$)")}};
+
+    auto [algorithm, hex] = ParseDigest(digest);
+
+    std::transform(algorithm.begin(), algorithm.end(), algorithm.begin(), ::tolower);
+
+    auto it = regexps.find(algorithm);
+    if (it == regexps.end()) {
+        return Error(ErrorEnum::eInvalidArgument, "Unsupported algorithm");
+    }
+
+    if (hex.length() != 2 * (algorithm == "sha256" ? 32 : algorithm == "sha384" ? 48 : 64)) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid encoded length");
+    }
+
+    if (!std::regex_match(hex, it->second)) {
+        return Error(ErrorEnum::eInvalidArgument, "Invalid encoded");
+    }
+
+    return ErrorEnum::eNone;
+}
+
 /***********************************************************************************************************************
  * Tests
  **********************************************************************************************************************/
@@ -78,6 +130,35 @@ TEST(UnpackTarImageTest, UnpackTarImageSuccess)
     fs::remove_all(destination);
 }
 
+TEST(UnpackTarImageTest, UnpackCompressedTarImageSuccess)
+{
+    std::string archivePath     = "test_archive.tar.gz";
+    std::string contentFilePath = "test_content.txt";
+    std::string destination     = "test_unpack_dir";
+
+    std::ofstream ofs(contentFilePath);
+    ofs << "This is a test content";
+    ofs.close();
+
+    Poco::Process::Args args;
+    args.push_back("czf");
+    args.push_back(archivePath);
+    args.push_back(contentFilePath);
+
+    ASSERT_EQ(Poco::Process::launch("tar", args).wait(), 0);
+
+    fs::remove(contentFilePath);
+    fs::create_directory(destination);
+
+    auto result = UnpackTarImage(archivePath, destination);
+
+    ASSERT_EQ(result, ErrorEnum::eNone);
+    EXPECT_TRUE(fs::exists(destination + "/" + contentFilePath));
+
+    fs::remove(archivePath);
+    fs::remove_all(destination);
+}
+
 TEST(UnpackTarImageTest, UnpackTarImageFailure)
 {
     std::string archivePath = "test_archive.tar";
@@ -109,6 +190,83 @@ TEST(UnpackTarImageTest, SourceFileDoesNotExist)
     ASSERT_NE(result.Message(), "");
 }
 
+TEST(UnpackTarImageTest, UnpackVerifiedTarImage)
+{
+    std::string archivePath     = "test_archive.tar";
+    std::string contentFilePath = "test_content.txt";
+    std::string destination     = "test_unpack_dir";
+
+    createTestTarFile(archivePath, contentFilePath, std::string(100000, 'a'));
+
+    for (const auto& algorithm : {"sha256", "sha384", "sha512"}) {
+        ASSERT_EQ(UnpackVerifiedTarImage(archivePath, destination, hashFile(archivePath, algorithm)), ErrorEnum::eNone);
+        EXPECT_EQ(fs::file_size(destination + "/" + contentFilePath), 100000);
+
+        fs::remove_all(destination);
+    }
+
+    const auto digest = hashFile(archivePath);
+
+    EXPECT_EQ(UnpackVerifiedTarImage(archivePath, destination, "sha256:1234"), ErrorEnum::eInvalidArgument);
+    EXPECT_EQ(UnpackVerifiedTarImage(archivePath, destination, ""), ErrorEnum::eInvalidArgument);
+    EXPECT_EQ(UnpackVerifiedTarImage("non_existent_file.tar", destination, digest), ErrorEnum::eNotFound);
+
+    // Corrupted header and truncated data are reported as digest mismatch.
+    {
+        std::fstream file(archivePath, std::ios::in | std::ios::out | std::ios::binary);
+
+        file.seekp(100);
+        file.put('x');
+    }
+
+    EXPECT_EQ(UnpackVerifiedTarImage(archivePath, destination, digest), ErrorEnum::eInvalidChecksum);
+
+    fs::resize_file(archivePath, 50000);
+
+    EXPECT_EQ(UnpackVerifiedTarImage(archivePath, destination, digest), ErrorEnum::eInvalidChecksum);
+
+    // Gzip and zstd archives are decompressed in-process.
+    Poco::Process::Args args {"cf", archivePath, "test_image_test_dummy"};
+
+    std::ofstream("test_image_test_dummy") << "content";
+    ASSERT_EQ(Poco::Process::launch("tar", args).wait(), 0);
+
+    args = {"-kf", archivePath};
+    ASSERT_EQ(Poco::Process::launch("gzip", args).wait(), 0);
+
+    {
+        std::ifstream     tarFile(archivePath, std::ios::binary);
+        const std::string tar((std::istreambuf_iterator<char>(tarFile)), std::istreambuf_iterator<char>());
+        std::string       compressed(ZSTD_compressBound(tar.size()), '\0');
+
+        compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), tar.data(), tar.size(), 3));
+        std::ofstream(archivePath + ".zst", std::ios::binary) << compressed;
+    }
+
+    for (const auto& compressedPath : {archivePath + ".gz", archivePath + ".zst"}) {
+        EXPECT_EQ(UnpackVerifiedTarImage(compressedPath, destination, digest), ErrorEnum::eInvalidChecksum);
+        EXPECT_EQ(UnpackVerifiedTarImage(compressedPath, destination, hashFile(compressedPath)), ErrorEnum::eNone);
+        EXPECT_TRUE(fs::exists(destination + "/test_image_test_dummy"));
+
+        fs::remove_all(destination);
+
+        const auto compressedDigest = hashFile(compressedPath);
+
+        fs::resize_file(compressedPath, fs::file_size(compressedPath) - 10);
+
+        EXPECT_EQ(UnpackVerifiedTarImage(compressedPath, destination, compressedDigest), ErrorEnum::eInvalidChecksum);
+    }
+
+    for (const auto& entry : fs::directory_iterator(".")) {
+        EXPECT_EQ(entry.path().filename().string().find(destination), std::string::npos);
+    }
+
+    fs::remove(archivePath);
+    fs::remove(archivePath + ".gz");
+    fs::remove(archivePath + ".zst");
+    fs::remove("test_image_test_dummy");
+}
+
 TEST(ParseDigestTest, ParseDigestSuccess)
 {
     std::string digest = "sha256:1234567890abcdef";
@@ -148,6 +306,40 @@ TEST(ValidateDigestTest, ValidateDigestInvalidLength)
     ASSERT_NE(result.Message(), "");
 }
 
+TEST(ValidateDigestTest, ValidateDigestMatchesRegex)
+{
+    std::vector<Digest> digests;
+
+    for (const auto& algorithm : {"sha256", "SHA384", "sha512", "md5", ""}) {
+        for (size_t length = 0; length <= 130; length++) {
+            digests.push_back(std::string(algorithm) + ":" + std::string(length, 'f'));
+        }
+
+        // Every byte value at the first, middle and last position.
+        for (const auto length : {64, 96, 128}) {
+            for (const auto pos : {0, length / 2, length - 1}) {
+                for (int c = 0; c < 256; c++) {
+                    auto hex = std::string(length, '0');
+
+                    hex[pos] = static_cast<char>(c);
+                    digests.push_back(std::string(algorithm) + ":" + hex);
+                }
+            }
+        }
+    }
+
+    digests.push_back("sha256");
+    digests.push_back("sha256:e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855:");
+
+    for (const auto& digest : digests) {
+        const auto expected = validateDigestRegex(digest);
+        const auto result   = ValidateDigest(digest);
+
+        ASSERT_EQ(result, expected) << digest;
+        ASSERT_STREQ(result.Message(), expected.Message()) << digest;
+    }
+}
+
 TEST(HashDirTest, HashDir)
 {
     std::string dir         = "test_dir";
@@ -180,4 +372,264 @@ TEST(HashDirTest, HashDir)
     fs::remove_all(dir);
 }
 
+TEST(HashDirTest, HashDirParallel)
+{
+    std::string dir = "test_dir";
+
+    for (int i = 0; i < 100; i++) {
+        auto subdir = dir + "/dir" + std::to_string(i % 7);
+
+        fs::create_directories(subdir);
+
+        std::ofstream ofs(subdir + "/file" + std::to_string(i));
+        ofs << std::string(i * 1000, static_cast<char>('a' + i % 26));
+    }
+
+    auto expected = HashDir(dir);
+
+    ASSERT_EQ(expected.mError, ErrorEnum::eNone);
+
+    for (size_t threads : {1, 4, 200}) {
+        auto result = HashDir(dir, threads);
+
+        ASSERT_EQ(result.mError, ErrorEnum::eNone);
+        EXPECT_EQ(result.mValue, expected.mValue);
+    }
+
+    std::ofstream(dir + "/new\nline") << "content";
+
+    EXPECT_EQ(HashDir(dir, 4).mError, ErrorEnum::eInvalidArgument);
+
+    fs::remove_all(dir);
+
+    fs::create_directory(dir);
+    std::ofstream(dir + "/file") << "This is a test content";
+
+    // sha256 of the file content hash followed by new line.
+    EXPECT_EQ(HashDir(dir, 2).mValue, "sha256:2e1ddc58a57b7dcc9947a5aa7b1fba1f8abaa8ed87ba6407facd82fd823f15e5");
+
+    fs::remove_all(dir);
+}
+
+TEST(HashDirTest, HashDirOrder)
+{
+    std::vector<std::string> names = {"b", "a/z", "a/b", "c", "a-b"};
+
+    // Digest depends on names only, not on the order in which the filesystem returns directory entries.
+    for (const auto& dir : {"test_dir1", "test_dir2"}) {
+        fs::create_directories(fs::path(dir) / "a");
+
+        for (const auto& name : names) {
+            std::ofstream(fs::path(dir) / name) << name;
+        }
+
+        std::reverse(names.begin(), names.end());
+    }
+
+    EXPECT_EQ(HashDir("test_dir1", 2).mValue, HashDir("test_dir2").mValue);
+
+    fs::remove_all("test_dir1");
+    fs::remove_all("test_dir2");
+}
+
+TEST(HashDirTest, HashDirCache)
+{
+    std::string dir       = "test_dir";
+    std::string cachePath = "test_dir.cache";
+
+    for (int i = 0; i < 10; i++) {
+        fs::create_directories(dir + "/dir" + std::to_string(i % 3));
+        std::ofstream(dir + "/dir" + std::to_string(i % 3) + "/file" + std::to_string(i)) << "content " << i;
+    }
+
+    HashDirOptions options;
+
+    options.mCachePath = cachePath;
+
+    // Just created files are racily clean and not cached.
+    auto result = HashDir(dir, options);
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+    EXPECT_EQ(result.mValue, HashDir(dir).mValue);
+    EXPECT_EQ(fs::file_size(cachePath), std::string("aoshashcache 1\n").size());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    const auto expected = HashDir(dir, options);
+
+    ASSERT_EQ(expected.mError, ErrorEnum::eNone);
+    EXPECT_EQ(expected.mValue, result.mValue);
+
+    std::string cache;
+    {
+        std::ifstream file(cachePath);
+        cache.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    EXPECT_EQ(std::count(cache.begin(), cache.end(), '\n'), 11);
+
+    // Cached hashes are used for unchanged files.
+    auto tampered = cache;
+    auto pos      = tampered.find("dir1/file1\n") - 65;
+
+    tampered.replace(pos, 64, std::string(64, '0'));
+    std::ofstream(cachePath) << tampered;
+
+    EXPECT_NE(HashDir(dir, options).mValue, expected.mValue);
+
+    std::ofstream(cachePath) << tampered;
+
+    options.mStrict = true;
+
+    EXPECT_EQ(HashDir(dir, options).mValue, expected.mValue);
+
+    options.mStrict = false;
+
+    EXPECT_EQ(HashDir(dir, options).mValue, expected.mValue);
+
+    // Malformed cache is ignored.
+    std::ofstream(cachePath) << cache.substr(0, cache.size() - 5);
+
+    EXPECT_EQ(HashDir(dir, options).mValue, expected.mValue);
+
+    // Changed file is rehashed.
+    std::ofstream(dir + "/dir1/file1") << "changed content";
+
+    result = HashDir(dir, options);
+
+    EXPECT_NE(result.mValue, expected.mValue);
+    EXPECT_EQ(result.mValue, HashDir(dir).mValue);
+
+    fs::remove_all(dir);
+    fs::remove(cachePath);
+}
+
+TEST(InstallLayerTest, InstallLayer)
+{
+    std::string layerDir    = "test_layer";
+    std::string archivePath = "test_layer.tar";
+    std::string destination = "test_install_dir";
+
+    for (int i = 0; i < 10; i++) {
+        fs::create_directories(layerDir + "/dir" + std::to_string(i % 3));
+        std::ofstream(layerDir + "/dir" + std::to_string(i % 3) + "/file" + std::to_string(i))
+            << std::string(i * 1000, static_cast<char>('a' + i));
+    }
+
+    fs::create_symlink("file0", layerDir + "/dir0/symlink");
+    fs::create_hard_link(layerDir + "/dir1/file1", layerDir + "/dir2/hardlink");
+
+    Poco::Process::Args args {"cf", archivePath, "-C", layerDir, "."};
+
+    ASSERT_EQ(Poco::Process::launch("tar", args).wait(), 0);
+
+    const auto expected      = HashDir(layerDir).mValue;
+    const auto archiveDigest = hashFile(archivePath);
+
+    auto result = InstallLayer(archivePath, destination, "");
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+    EXPECT_EQ(result.mValue, expected);
+    EXPECT_EQ(HashDir(destination).mValue, expected);
+
+    fs::remove_all(destination);
+
+    result = InstallLayer(archivePath, destination, expected, archiveDigest);
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+    EXPECT_EQ(result.mValue, expected);
+    EXPECT_TRUE(fs::is_symlink(destination + "/dir0/symlink"));
+
+    fs::remove_all(destination);
+
+    result = InstallLayer(archivePath, destination, expected, hashFile(archivePath, "sha512"));
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+
+    fs::remove_all(destination);
+
+    // Mismatched digests leave neither destination nor staging directory.
+    const auto wrongDigest = "sha256:" + std::string(64, '0');
+
+    EXPECT_EQ(InstallLayer(archivePath, destination, wrongDigest).mError, ErrorEnum::eInvalidChecksum);
+    EXPECT_EQ(InstallLayer(archivePath, destination, expected, wrongDigest).mError, ErrorEnum::eInvalidChecksum);
+    EXPECT_EQ(InstallLayer(archivePath, destination, "sha256:1234").mError, ErrorEnum::eInvalidArgument);
+    EXPECT_EQ(InstallLayer("non_existent_file.tar", destination, "").mError, ErrorEnum::eNotFound);
+
+    for (const auto& entry : fs::directory_iterator(".")) {
+        EXPECT_EQ(entry.path().filename().string().find(destination), std::string::npos);
+    }
+
+    // Gzip archive is decompressed in-process.
+    args = {"czf", archivePath + ".gz", "-C", layerDir, "."};
+
+    ASSERT_EQ(Poco::Process::launch("tar", args).wait(), 0);
+
+    result = InstallLayer(archivePath + ".gz", destination, expected, hashFile(archivePath + ".gz"));
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+    EXPECT_EQ(HashDir(destination).mValue, expected);
+
+    fs::remove_all(destination);
+    fs::remove_all(layerDir);
+    fs::remove(archivePath);
+    fs::remove(archivePath + ".gz");
+}
+
+TEST(InstallLayerTest, MaterializeLayer)
+{
+    std::string layerDir    = "test_layer";
+    std::string archivePath = "test_layer.tar";
+    std::string store       = "test_layer_store";
+
+    fs::create_directories(layerDir + "/dir/subdir");
+    std::ofstream(layerDir + "/dir/file") << std::string(100000, 'a');
+    std::ofstream(layerDir + "/dir/subdir/empty");
+    fs::create_symlink("../file", layerDir + "/dir/subdir/symlink");
+    fs::create_hard_link(layerDir + "/dir/file", layerDir + "/hardlink");
+    fs::permissions(layerDir + "/dir/file", fs::perms::owner_read | fs::perms::owner_exec);
+    fs::permissions(layerDir + "/dir/subdir", fs::perms::owner_read | fs::perms::owner_exec);
+
+    Poco::Process::Args args {"cf", archivePath, "-C", layerDir, "."};
+
+    ASSERT_EQ(Poco::Process::launch("tar", args).wait(), 0);
+
+    const auto digest = HashDir(layerDir).mValue;
+
+    EXPECT_EQ(MaterializeLayer(store, digest, "test_service1"), ErrorEnum::eNotFound);
+
+    fs::create_directories(store + "/sha256");
+
+    ASSERT_EQ(InstallLayer(archivePath, GetLayerPath(store, digest), digest).mError, ErrorEnum::eNone);
+
+    for (const auto& destination : {"test_service1", "test_service2"}) {
+        ASSERT_EQ(MaterializeLayer(store, digest, destination), ErrorEnum::eNone);
+
+        const auto path = std::string(destination);
+
+        EXPECT_EQ(HashDir(path).mValue, digest);
+        EXPECT_TRUE(fs::equivalent(path + "/dir/file", path + "/hardlink"));
+        EXPECT_EQ(fs::read_symlink(path + "/dir/subdir/symlink"), "../file");
+        EXPECT_EQ(fs::status(path + "/dir/subdir").permissions(), fs::perms::owner_read | fs::perms::owner_exec);
+
+        for (const auto& entry : {"/dir/subdir", "/dir/file"}) {
+            EXPECT_EQ(fs::last_write_time(path + entry), fs::last_write_time(GetLayerPath(store, digest) + entry));
+        }
+    }
+
+    EXPECT_EQ(MaterializeLayer(store, digest, "test_service1"), ErrorEnum::eFailed);
+    EXPECT_EQ(MaterializeLayer(store, "sha256:1234", "test_service3"), ErrorEnum::eInvalidArgument);
+
+    for (const auto& path : {std::string("test_service1"), std::string("test_service2"), GetLayerPath(store, digest),
+             layerDir}) {
+        fs::permissions(path + "/dir/subdir", fs::perms::owner_all, fs::perm_options::add);
+    }
+
+    fs::remove_all("test_service1");
+    fs::remove_all("test_service2");
+    fs::remove_all(store);
+    fs::remove_all(layerDir);
+    fs::remove(archivePath);
+}
+
 } // namespace aos::common::utils
@@ -5,7 +5,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <filesystem>
 #include <fstream>
+#include <random>
 
 #include <Poco/JSON/Object.h>
 #include <gtest/gtest.h>
@@ -21,6 +23,83 @@ using namespace testing;
 
 class JsonTest : public Test { };
 
+static void ExpectEqualJson(const Poco::Dynamic::Var& expected, const Poco::Dynamic::Var& actual)
+{
+    ASSERT_EQ(expected.type(), actual.type());
+
+    if (expected.type() == typeid(Poco::JSON::Object::Ptr)) {
+        auto expectedObject = expected.extract<Poco::JSON::Object::Ptr>();
+        auto actualObject   = actual.extract<Poco::JSON::Object::Ptr>();
+
+        ASSERT_EQ(expectedObject->size(), actualObject->size());
+
+        for (const auto& [key, value] : *expectedObject) {
+            ASSERT_TRUE(actualObject->has(key)) << key;
+            ExpectEqualJson(value, actualObject->get(key));
+        }
+    } else if (expected.type() == typeid(Poco::JSON::Array::Ptr)) {
+        auto expectedArray = expected.extract<Poco::JSON::Array::Ptr>();
+        auto actualArray   = actual.extract<Poco::JSON::Array::Ptr>();
+
+        ASSERT_EQ(expectedArray->size(), actualArray->size());
+
+        for (size_t i = 0; i < expectedArray->size(); i++) {
+            ExpectEqualJson(expectedArray->get(i), actualArray->get(i));
+        }
+    } else if (expected.type() == typeid(double)) {
+        EXPECT_EQ(expected.extract<double>(), actual.extract<double>());
+    } else if (!expected.isEmpty()) {
+        EXPECT_EQ(expected.convert<std::string>(), actual.convert<std::string>());
+    }
+}
+
+static std::string GenerateJson(std::mt19937& rng, int depth)
+{
+    static const std::vector<std::string> cStrings = {"", "value", "with space", R"(quote \" inside)",
+        R"(escapes \\ \/ \b\f\n\r\t)", R"(unicode \u00e9\u4e2d\ud83d\ude00)", u8"raw unicode é中😀", "aos.key"};
+    static const std::vector<std::string> cNumbers = {"0", "-0", "1", "-17", "9223372036854775807",
+        "-9223372036854775808", "18446744073709551615", "3.5", "-0.25", "1e10", "2.5E-3", "1E+2", "123456.789e-2"};
+
+    if (depth == 0) {
+        switch (rng() % 4) {
+        case 0:
+            return "\"" + cStrings[rng() % cStrings.size()] + "\"";
+
+        case 1:
+            return cNumbers[rng() % cNumbers.size()];
+
+        case 2:
+            return rng() % 2 ? "true" : "false";
+
+        default:
+            return "null";
+        }
+    }
+
+    const auto        size = rng() % 6;
+    const std::string ws   = rng() % 2 ? " \n\t" : "";
+    std::string       json;
+
+    if (rng() % 2) {
+        json += "{" + ws;
+
+        for (size_t i = 0; i < size; i++) {
+            json += (i ? "," + ws : "") + "\"key" + std::to_string(rng() % 8) + "\"" + ws + ":"
+                + GenerateJson(rng, rng() % depth);
+        }
+
+        return json + ws + "}";
+    }
+
+    json += "[" + ws;
+
+    for (size_t i = 0; i < size; i++) {
+        json += (i ? "," + ws : "") + GenerateJson(rng, rng() % depth);
+    }
+
+    return json + ws + "]";
+}
+
 /***********************************************************************************************************************
  * Tests
  **********************************************************************************************************************/
@@ -69,6 +148,67 @@ TEST_F(JsonTest, ParseJsonFailsFromStream)
     EXPECT_TRUE(result.isEmpty());
 }
 
+TEST_F(JsonTest, ParseJsonFastMatchesParseJson)
+{
+    std::mt19937 rng(42);
+
+    for (int i = 0; i < 500; i++) {
+        auto json = GenerateJson(rng, 5);
+
+        auto [expected, expectedErr] = ParseJson(json);
+        ASSERT_TRUE(expectedErr.IsNone()) << json;
+
+        auto [actual, err] = ParseJsonFast(json);
+        ASSERT_TRUE(err.IsNone()) << json;
+
+        ExpectEqualJson(expected, actual);
+    }
+}
+
+TEST_F(JsonTest, ParseJsonFastFailsAsParseJson)
+{
+    for (const std::string json : {"", " ", "{", "}", "[1,]", "[1 2]", R"({"key" 1})", R"({"key":1,})", R"({1:2})",
+             "tru", "nul", "[true false]", R"({"key":1}x)", R"("abc)", R"(["a"1])", "1.", ".5", "-", "1e", "[01]",
+             R"(["\x"])", R"(["\u12"])", R"(["\udc00"])"}) {
+        auto expectedErr = ParseJson(json).mError;
+        auto err         = ParseJsonFast(json).mError;
+
+        EXPECT_FALSE(err.IsNone()) << json;
+        EXPECT_EQ(err.IsNone(), expectedErr.IsNone()) << json;
+    }
+}
+
+TEST_F(JsonTest, ParseJsonFileSucceeds)
+{
+    std::string path = "parse_test.json";
+
+    std::ofstream(path) << R"({"key": "value", "array": [1, 2, 3]})";
+
+    auto [result, err] = ParseJsonFile(path);
+
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(err.IsNone());
+    ASSERT_EQ(result.type(), typeid(Poco::JSON::Object::Ptr));
+    EXPECT_EQ(result.extract<Poco::JSON::Object::Ptr>()->getValue<std::string>("key"), "value");
+}
+
+TEST_F(JsonTest, ParseJsonFileFails)
+{
+    std::string path = "parse_test.json";
+
+    EXPECT_TRUE(ParseJsonFile(path).mError.Is(aos::ErrorEnum::eNotFound));
+
+    std::ofstream(path) << R"({"key": )";
+
+    auto [result, err] = ParseJsonFile(path);
+
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(err.Is(aos::ErrorEnum::eInvalidArgument));
+    EXPECT_TRUE(result.isEmpty());
+}
+
 TEST_F(JsonTest, FindByPathSucceeds)
 {
     Poco::JSON::Object object;
@@ -131,6 +271,114 @@ TEST_F(JsonTest, FindByPathFails)
     EXPECT_TRUE(res.isEmpty());
 }
 
+TEST_F(JsonTest, JsonPathCompileSucceeds)
+{
+    auto [path, err] = JsonPath::Compile(R"(services[*].layers[2]["aos.key"].*)");
+    ASSERT_TRUE(err.IsNone());
+
+    const auto& segments = path.GetSegments();
+
+    ASSERT_EQ(segments.size(), 6);
+    EXPECT_EQ(segments[0].mType, JsonPath::Segment::Type::eKey);
+    EXPECT_EQ(segments[0].mKey, "services");
+    EXPECT_EQ(segments[1].mType, JsonPath::Segment::Type::eWildcard);
+    EXPECT_EQ(segments[2].mKey, "layers");
+    EXPECT_EQ(segments[3].mType, JsonPath::Segment::Type::eIndex);
+    EXPECT_EQ(segments[3].mIndex, 2);
+    EXPECT_EQ(segments[4].mKey, "aos.key");
+    EXPECT_EQ(segments[5].mType, JsonPath::Segment::Type::eWildcard);
+    EXPECT_TRUE(path.HasWildcard());
+
+    Tie(path, err) = JsonPath::Compile("");
+    ASSERT_TRUE(err.IsNone());
+    EXPECT_TRUE(path.GetSegments().empty());
+}
+
+TEST_F(JsonTest, JsonPathCompileFails)
+{
+    for (const auto& path :
+        {".key", "key.", "key..value", "key[", "key[a]", "key[]", "key[0]value", R"(["key)", "key[\xc3\xa9]"}) {
+        auto err = JsonPath::Compile(path).mError;
+
+        EXPECT_TRUE(err.Is(ErrorEnum::eInvalidArgument)) << path;
+    }
+}
+
+TEST_F(JsonTest, JsonPathFindSucceeds)
+{
+    auto [object, err] = ParseJson(R"({"data":{"aos.key":"aos.value","items":[{"id":1},{"id":2},{"name":"x"}]}})");
+    ASSERT_TRUE(err.IsNone());
+
+    auto res = JsonPath({"data", "aos.key"}).Find(object);
+    ASSERT_TRUE(res.isString());
+    EXPECT_EQ(res.extract<std::string>(), "aos.value");
+
+    JsonPath path;
+
+    Tie(path, err) = JsonPath::Compile("data.items[1].id");
+    ASSERT_TRUE(err.IsNone());
+
+    res = path.Find(object);
+    EXPECT_EQ(res.convert<int>(), 2);
+
+    Tie(path, err) = JsonPath::Compile("data.items[*].id");
+    ASSERT_TRUE(err.IsNone());
+
+    res = path.Find(object);
+    ASSERT_EQ(res.type(), typeid(Poco::JSON::Array::Ptr));
+
+    auto ids = res.extract<Poco::JSON::Array::Ptr>();
+
+    ASSERT_EQ(ids->size(), 2);
+    EXPECT_EQ(ids->get(0).convert<int>(), 1);
+    EXPECT_EQ(ids->get(1).convert<int>(), 2);
+
+    Tie(path, err) = JsonPath::Compile("data.items[3].id");
+    ASSERT_TRUE(err.IsNone());
+
+    EXPECT_TRUE(path.Find(object).isEmpty());
+}
+
+TEST_F(JsonTest, JsonPathExtractorSucceeds)
+{
+    auto [object, err]
+        = ParseJson(R"({"version":3,"data":{"items":[{"id":1},{"id":2}],"name":"aos"},"list":["a","b"]})");
+    ASSERT_TRUE(err.IsNone());
+
+    JsonPathExtractor   extractor;
+    std::vector<size_t> indices;
+
+    for (const auto& str : {"version", "data.name", "data.items[0].id", "data.items[*].id", "list[*]", "missing.key",
+             "data.items[5]"}) {
+        JsonPath path;
+
+        Tie(path, err) = JsonPath::Compile(str);
+        ASSERT_TRUE(err.IsNone());
+
+        indices.push_back(extractor.Add(path));
+    }
+
+    auto values = extractor.Extract(object);
+
+    ASSERT_EQ(values.size(), indices.size());
+    EXPECT_EQ(values[indices[0]].convert<int>(), 3);
+    EXPECT_EQ(values[indices[1]].convert<std::string>(), "aos");
+    EXPECT_EQ(values[indices[2]].convert<int>(), 1);
+
+    auto ids = values[indices[3]].extract<Poco::JSON::Array::Ptr>();
+
+    ASSERT_EQ(ids->size(), 2);
+    EXPECT_EQ(ids->get(1).convert<int>(), 2);
+
+    auto list = values[indices[4]].extract<Poco::JSON::Array::Ptr>();
+
+    ASSERT_EQ(list->size(), 2);
+    EXPECT_EQ(list->get(0).convert<std::string>(), "a");
+
+    EXPECT_TRUE(values[indices[5]].isEmpty());
+    EXPECT_TRUE(values[indices[6]].isEmpty());
+}
+
 TEST_F(JsonTest, CaseInsensitiveObjectWrapperSucceeds)
 {
     Poco::JSON::Object::Ptr object = new Poco::JSON::Object();
@@ -226,20 +474,104 @@ TEST_F(JsonTest, ParseValueArraySucceeds)
     }
 }
 
+TEST_F(JsonTest, ConvertValueMatchesPocoConvert)
+{
+    const std::vector<Poco::Dynamic::Var> values
+        = {Poco::Int64(-42), Poco::UInt64(42), 42, 42.0, 1.5, -1.5, std::string("42"), std::string("-7"), true};
+
+    for (const auto& value : values) {
+        EXPECT_EQ(ConvertValue<int64_t>(value), value.convert<int64_t>()) << value.toString();
+        EXPECT_EQ(ConvertValue<double>(value), value.convert<double>()) << value.toString();
+        EXPECT_EQ(ConvertValue<int>(value), value.convert<int>()) << value.toString();
+    }
+
+    EXPECT_EQ(ConvertValue<uint32_t>(Poco::UInt64(4294967295)), 4294967295);
+    EXPECT_EQ(ConvertValue<std::string>(Poco::Int64(42)), "42");
+    EXPECT_EQ(ConvertValue<double>(std::string("2.5")), 2.5);
+    EXPECT_EQ(ConvertValue<double>(std::string("1e3")), 1000.0);
+
+    EXPECT_THROW(ConvertValue<uint32_t>(Poco::Int64(-1)), Poco::RangeException);
+    EXPECT_THROW(ConvertValue<uint32_t>(Poco::UInt64(4294967296)), Poco::RangeException);
+    EXPECT_THROW(ConvertValue<int8_t>(Poco::Int64(-129)), Poco::RangeException);
+    EXPECT_THROW(ConvertValue<int64_t>(Poco::UInt64(18446744073709551615ULL)), Poco::RangeException);
+    EXPECT_THROW(ConvertValue<int64_t>(1e19), Poco::RangeException);
+    EXPECT_THROW(ConvertValue<uint16_t>(-1.0), Poco::RangeException);
+    EXPECT_EQ(ConvertValue<float>(1.5), 1.5f);
+    EXPECT_THROW(ConvertValue<float>(1e300), Poco::RangeException);
+    EXPECT_THROW(ConvertValue<float>(-1e300), Poco::RangeException);
+}
+
+TEST_F(JsonTest, GetArrayValueConvertsParsedNumbers)
+{
+    auto json = ParseJson(R"({"ints":[1,-2,3],"uints":[18446744073709551615],"doubles":[0.5,2,-3e2],"mixed":["4",5]})");
+
+    ASSERT_TRUE(json.mError.IsNone());
+
+    CaseInsensitiveObjectWrapper wrapper(json.mValue);
+
+    EXPECT_EQ(GetArrayValue<int>(wrapper, "INTS"), std::vector<int>({1, -2, 3}));
+    EXPECT_EQ(GetArrayValue<uint64_t>(wrapper, "uints"), std::vector<uint64_t>({18446744073709551615ULL}));
+    EXPECT_EQ(GetArrayValue<double>(wrapper, "doubles"), std::vector<double>({0.5, 2, -300}));
+    EXPECT_EQ(GetArrayValue<uint8_t>(wrapper, "mixed"), std::vector<uint8_t>({4, 5}));
+    EXPECT_EQ(wrapper.GetValue<double>("missing", 1.5), 1.5);
+    EXPECT_EQ(wrapper.GetOptionalValue<int>("missing"), std::nullopt);
+    EXPECT_THROW(GetArrayValue<uint32_t>(wrapper, "ints"), Poco::RangeException);
+
+    auto huge = ParseJson(R"({"value":1e300,"values":[1,-1e300]})");
+
+    ASSERT_TRUE(huge.mError.IsNone());
+
+    CaseInsensitiveObjectWrapper hugeWrapper(huge.mValue);
+
+    EXPECT_THROW(hugeWrapper.GetValue<float>("value"), Poco::RangeException);
+    EXPECT_THROW(GetArrayValue<float>(hugeWrapper, "values"), Poco::RangeException);
+}
+
 TEST_F(JsonTest, WriteJsonToFileSucceeds)
 {
     Poco::JSON::Object::Ptr object = new Poco::JSON::Object();
     object->set("key", "value");
 
     std::string path = "test.json";
+    std::string link = "test-link.json";
+
+    // File is rewritten in place by default, so hard links are kept.
+    std::ofstream(path) << "old content";
+    std::filesystem::create_hard_link(path, link);
 
     EXPECT_EQ(WriteJsonToFile(object, path), aos::ErrorEnum::eNone);
 
-    std::ifstream file(path);
+    std::ifstream file(link);
     std::string   content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
     EXPECT_EQ(content, R"({"key":"value"})");
 
+    std::remove(path.c_str());
+    std::remove(link.c_str());
+}
+
+TEST_F(JsonTest, WriteJsonToFileModesSucceed)
+{
+    Poco::JSON::Object::Ptr object = new Poco::JSON::Object();
+
+    for (int i = 0; i < 1000; i++) {
+        object->set("key" + std::to_string(i), std::string(100, 'a'));
+    }
+
+    std::string path = "test.json";
+
+    for (const auto& options : {WriteJsonOptions {true, true, 4096}, WriteJsonOptions {false, true, 4096},
+             WriteJsonOptions {false, false, 1}}) {
+        std::ofstream(path) << "old content which is longer than the new one" << std::string(200000, ' ');
+
+        ASSERT_EQ(WriteJsonToFile(object, path, options), aos::ErrorEnum::eNone);
+
+        auto result = ParseJsonFile(path);
+
+        ASSERT_EQ(result.mError, aos::ErrorEnum::eNone);
+        EXPECT_EQ(result.mValue.extract<Poco::JSON::Object::Ptr>()->size(), 1000);
+    }
+
     std::remove(path.c_str());
 }
 
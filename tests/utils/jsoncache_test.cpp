@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include <Poco/JSON/Object.h>
+
+#include "utils/filesystem.hpp"
+#include "utils/jsoncache.hpp"
+
+using namespace testing;
+
+namespace fs = std::filesystem;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Suite
+ **********************************************************************************************************************/
+
+class JsonFileCacheTest : public Test {
+protected:
+    void SetUp() override
+    {
+        auto [dir, err] = MkTmpDir();
+
+        ASSERT_TRUE(err.IsNone());
+
+        mDir = dir;
+    }
+
+    void TearDown() override { fs::remove_all(mDir); }
+
+    // Files are dated back, so they are not treated as modified within the racy interval.
+    std::string WriteFile(const std::string& name, const std::string& content, bool recent = false)
+    {
+        const auto path = (fs::path(mDir) / name).string();
+
+        std::ofstream(path) << content;
+
+        if (!recent) {
+            fs::last_write_time(path, fs::file_time_type::clock::now() - std::chrono::seconds(10));
+        }
+
+        return path;
+    }
+
+    std::string mDir;
+};
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST_F(JsonFileCacheTest, ReturnsCachedDocument)
+{
+    JsonFileCache cache;
+
+    const auto path = WriteFile("config.json", R"({"key":"value1","nested":{"array":[1]}})");
+
+    auto first = cache.ParseFile(path);
+
+    ASSERT_TRUE(first.mError.IsNone());
+    EXPECT_EQ(first.mValue.extract<Poco::JSON::Object::Ptr>()->getValue<std::string>("key"), "value1");
+    EXPECT_GT(cache.GetSize(), 0);
+
+    // Cached document is shared, it is returned without parsing or copying.
+    auto second = cache.ParseFile(path);
+
+    ASSERT_TRUE(second.mError.IsNone());
+    EXPECT_EQ(second.mValue.extract<Poco::JSON::Object::Ptr>(), first.mValue.extract<Poco::JSON::Object::Ptr>());
+
+    // Replaced file has different inode.
+    const auto tmpPath = WriteFile("config.json.tmp", R"({"key":"value2"})");
+
+    fs::rename(tmpPath, path);
+
+    auto third = cache.ParseFile(path);
+
+    ASSERT_TRUE(third.mError.IsNone());
+    EXPECT_EQ(third.mValue.extract<Poco::JSON::Object::Ptr>()->getValue<std::string>("key"), "value2");
+
+    cache.Invalidate(path);
+
+    EXPECT_EQ(cache.GetSize(), 0);
+
+    fs::remove(path);
+
+    EXPECT_TRUE(cache.ParseFile(path).mError.Is(ErrorEnum::eNotFound));
+
+    WriteFile("invalid.json", "{");
+
+    EXPECT_FALSE(cache.ParseFile((fs::path(mDir) / "invalid.json").string()).mError.IsNone());
+    EXPECT_EQ(cache.GetSize(), 0);
+}
+
+TEST_F(JsonFileCacheTest, SkipsRecentlyModified)
+{
+    JsonFileCache cache;
+
+    const auto path = WriteFile("config.json", R"({"key":"value1"})", true);
+
+    ASSERT_TRUE(cache.ParseFile(path).mError.IsNone());
+    EXPECT_EQ(cache.GetSize(), 0);
+
+    // Same size rewrite keeping the timestamp is not detected for a cached file, so recent files are not cached.
+    const auto modTime = fs::last_write_time(path);
+
+    std::ofstream(path) << R"({"key":"value2"})";
+    fs::last_write_time(path, modTime);
+
+    EXPECT_EQ(cache.ParseFile(path).mValue.extract<Poco::JSON::Object::Ptr>()->getValue<std::string>("key"), "value2");
+}
+
+TEST_F(JsonFileCacheTest, EvictsLeastRecentlyUsed)
+{
+    const std::string content = R"({"key":"value"})";
+
+    const auto path1 = WriteFile("1.json", content);
+    const auto path2 = WriteFile("2.json", content);
+    const auto path3 = WriteFile("3.json", content);
+
+    JsonFileCache cache;
+
+    ASSERT_TRUE(cache.ParseFile(path1).mError.IsNone());
+
+    // Size is estimated for the parsed document, not for the file.
+    const auto documentSize = cache.GetSize();
+
+    EXPECT_GT(documentSize, content.size());
+
+    cache.SetMaxSize(documentSize * 2);
+
+    ASSERT_TRUE(cache.ParseFile(path2).mError.IsNone());
+    ASSERT_TRUE(cache.ParseFile(path1).mError.IsNone());
+    ASSERT_TRUE(cache.ParseFile(path3).mError.IsNone());
+
+    EXPECT_EQ(cache.GetSize(), documentSize * 2);
+
+    // The least recently used file is evicted: changed content of the first file is still returned from the cache.
+    const auto modTime = fs::last_write_time(path1);
+
+    std::ofstream(path1) << R"({"key":"other"})";
+    fs::last_write_time(path1, modTime);
+
+    EXPECT_EQ(cache.ParseFile(path1).mValue.extract<Poco::JSON::Object::Ptr>()->getValue<std::string>("key"), "value");
+
+    cache.SetMaxSize(documentSize);
+
+    EXPECT_EQ(cache.GetSize(), documentSize);
+
+    cache.Clear();
+
+    EXPECT_EQ(cache.GetSize(), 0);
+    EXPECT_EQ(&JsonFileCache::Get(), &JsonFileCache::Get());
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "utils/jsondom.hpp"
+
+using namespace testing;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(JsonDocumentTest, ParseSucceeds)
+{
+    const std::string json = R"({"Key":"value","Escaped":"a\"bé","Numbers":[1,-2,18446744073709551615,2.5],
+        "Nested":{"Flag":true,"Null":null},"Empty":{},"EmptyArray":[]})";
+
+    JsonDocument document;
+
+    ASSERT_TRUE(document.Parse(json).IsNone());
+    ASSERT_TRUE(document.GetRoot().IsObject());
+
+    JsonObjectView object(document.GetRoot());
+
+    EXPECT_TRUE(object.Has("key"));
+    EXPECT_FALSE(object.Has("unknown"));
+    EXPECT_EQ(object.GetValue<std::string>("KEY"), "value");
+    EXPECT_EQ(object.GetValue<std::string>("unknown", "default"), "default");
+    EXPECT_EQ(object.GetValue<std::string_view>("escaped"), u8"a\"bé");
+
+    // Strings without escapes reference the input
+    auto key = object.GetValue<std::string_view>("key");
+    EXPECT_GE(key.data(), json.data());
+    EXPECT_LT(key.data(), json.data() + json.size());
+
+    auto numbers = object.GetArray("numbers");
+
+    ASSERT_EQ(numbers.Size(), 4);
+    EXPECT_EQ(numbers[0].As<int>(), 1);
+    EXPECT_EQ(numbers[1].As<int64_t>(), -2);
+    EXPECT_EQ(numbers[2].As<uint64_t>(), 18446744073709551615ULL);
+    EXPECT_EQ(numbers[3].As<double>(), 2.5);
+    EXPECT_THROW(numbers[1].As<uint32_t>(), Poco::RangeException);
+    EXPECT_THROW(numbers[2].As<int64_t>(), Poco::RangeException);
+
+    // Max values round up to 2^63 and 2^64 as double.
+    JsonDocument boundsDocument;
+
+    ASSERT_TRUE(boundsDocument.Parse("[9223372036854775808.0,18446744073709551616.0,9223372036854774784.0]").IsNone());
+
+    const auto bounds = boundsDocument.GetRoot().GetItems();
+
+    EXPECT_THROW(bounds[0].As<int64_t>(), Poco::RangeException);
+    EXPECT_EQ(bounds[0].As<uint64_t>(), 9223372036854775808ULL);
+    EXPECT_THROW(bounds[1].As<uint64_t>(), Poco::RangeException);
+    EXPECT_EQ(bounds[2].As<int64_t>(), 9223372036854774784LL);
+
+    auto nested = object.GetObject("nested");
+
+    EXPECT_TRUE(nested.GetValue<bool>("flag"));
+    EXPECT_TRUE(nested.Get("null").IsNull());
+    EXPECT_FALSE(nested.GetOptionalValue<bool>("missing").has_value());
+    EXPECT_THROW(nested.Get("missing"), Poco::NotFoundException);
+    EXPECT_THROW(nested.GetValue<std::string>("flag"), Poco::BadCastException);
+
+    EXPECT_EQ(object.GetObject("empty").GetOptionalValue<int>("any"), std::nullopt);
+    EXPECT_EQ(object.GetArray("emptyArray").Size(), 0);
+    EXPECT_THROW(JsonObjectView {numbers[0]}, Poco::BadCastException);
+
+    const auto values = GetArrayValue<double>(JsonObjectView(document.GetRoot()), "numbers");
+
+    EXPECT_EQ(values.size(), 4);
+    EXPECT_GT(document.GetArenaSize(), 0);
+
+    document.Clear();
+
+    EXPECT_TRUE(document.GetRoot().IsNull());
+    EXPECT_EQ(document.GetArenaSize(), 0);
+}
+
+TEST(JsonDocumentTest, ParseMembersInDocumentOrder)
+{
+    JsonDocument document;
+
+    ASSERT_TRUE(document.Parse(R"({"b":1,"a":2,"c":{"x":[1,[2,3],{"y":4}]},"d":5})").IsNone());
+
+    auto members = document.GetRoot().GetMembers();
+
+    ASSERT_EQ(members.Size(), 4);
+    EXPECT_EQ(members[0].mKey, "b");
+    EXPECT_EQ(members[1].mKey, "a");
+    EXPECT_EQ(members[2].mKey, "c");
+    EXPECT_EQ(members[3].mKey, "d");
+    EXPECT_EQ(members[3].mValue.As<int>(), 5);
+
+    auto items = JsonObjectView(members[2].mValue).GetArray("x");
+
+    ASSERT_EQ(items.Size(), 3);
+    EXPECT_EQ(items[1].GetItems()[1].As<int>(), 3);
+    EXPECT_EQ(JsonObjectView(items[2]).GetValue<int>("y"), 4);
+}
+
+TEST(JsonDocumentTest, ParseFails)
+{
+    JsonDocument document;
+
+    for (const auto& json : {"", "{", R"({"a":1,})", "[1 2]", R"({"a" 1})", "tru", R"(["\x"])", "[1]x", "01",
+             "[\"a\tb\"]"}) {
+        EXPECT_FALSE(document.Parse(json).IsNone()) << json;
+        EXPECT_TRUE(document.GetRoot().IsNull());
+    }
+}
+
+TEST(JsonDocumentTest, ParseFileSucceeds)
+{
+    std::string path = "dom_test.json";
+
+    std::ofstream(path) << R"({"services":[{"id":"service1"},{"id":"service2"}]})";
+
+    JsonDocument document;
+
+    ASSERT_TRUE(document.ParseFile(path).IsNone());
+
+    // Values don't reference the file, so it may be truncated or removed.
+    std::ofstream(path, std::ios::trunc);
+    std::filesystem::remove(path);
+
+    auto services = JsonObjectView(document.GetRoot()).GetArray("services");
+
+    ASSERT_EQ(services.Size(), 2);
+    EXPECT_EQ(JsonObjectView(services[1]).GetValue<std::string>("id"), "service2");
+
+    EXPECT_TRUE(document.ParseFile(path).Is(ErrorEnum::eNotFound));
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "utils/jsonscanner.hpp"
+
+using namespace testing;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+static std::vector<uint32_t> Scan(const std::string& json, SIMDLevel level = SIMDLevel::eScalar)
+{
+    std::vector<uint32_t> index;
+
+    auto err = ScanJson(json, index, level);
+    EXPECT_TRUE(err.IsNone()) << json;
+
+    return index;
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(JsonScannerTest, BuildsStructuralIndex)
+{
+    EXPECT_EQ(
+        Scan(R"({"a": [1, true, "x\"y"]})"), (std::vector<uint32_t> {0, 1, 3, 4, 6, 7, 8, 10, 14, 16, 21, 22, 23}));
+    EXPECT_EQ(Scan(R"(  "a\\" )"), (std::vector<uint32_t> {2, 6}));
+    EXPECT_EQ(Scan("-12.5e3"), (std::vector<uint32_t> {0}));
+    EXPECT_EQ(Scan(R"("{[,:]}")"), (std::vector<uint32_t> {0, 7}));
+}
+
+TEST(JsonScannerTest, AllLevelsProduceSameIndex)
+{
+    const std::string alphabet = "{}[]:,\"\\ \t\nab01-.e";
+
+    std::mt19937 rng(42);
+
+    for (size_t size : {1, 63, 64, 65, 127, 128, 1000, 4096}) {
+        for (int iteration = 0; iteration < 16; iteration++) {
+            std::string json;
+
+            for (size_t i = 0; i < size; i++) {
+                json += alphabet[rng() % alphabet.size()];
+            }
+
+            std::vector<uint32_t> expected, index;
+
+            auto expectedErr = ScanJson(json, expected, SIMDLevel::eScalar);
+
+            for (auto level : {SIMDLevel::eSSE2, SIMDLevel::eAVX2, SIMDLevel::eNEON}) {
+                auto err = ScanJson(json, index, level);
+
+                ASSERT_EQ(err.IsNone(), expectedErr.IsNone());
+
+                if (err.IsNone()) {
+                    ASSERT_EQ(index, expected);
+                }
+            }
+        }
+    }
+}
+
+TEST(JsonScannerTest, ValidatesUTF8)
+{
+    std::vector<uint32_t> index;
+
+    for (auto level : {SIMDLevel::eScalar, GetSIMDLevel()}) {
+        std::string padding(62, ' ');
+
+        EXPECT_TRUE(ScanJson(u8"\"привіт ✓ 😀\"", index, level).IsNone());
+        EXPECT_TRUE(ScanJson(padding + u8"\"😀\"", index, level).IsNone());
+
+        for (const auto& invalid : {"\"\xC0\xAF\"", "\"\xE0\x80\xAF\"", "\"\xED\xA0\x80\"", "\"\xF4\x90\x80\x80\"",
+                 "\"\xF0\x9F\x98\"", "\"\xFF\"", "\"\x80\""}) {
+            EXPECT_TRUE(ScanJson(invalid, index, level).Is(ErrorEnum::eInvalidArgument));
+            EXPECT_TRUE(ScanJson(padding + invalid, index, level).Is(ErrorEnum::eInvalidArgument));
+        }
+    }
+}
+
+TEST(JsonScannerTest, FailsOnUnterminatedString)
+{
+    std::vector<uint32_t> index;
+
+    EXPECT_TRUE(ScanJson(R"({"key": "value})", index).Is(ErrorEnum::eInvalidArgument));
+    EXPECT_TRUE(ScanJson(R"({"key": "value\"})", index).Is(ErrorEnum::eInvalidArgument));
+}
+
+TEST(JsonScannerTest, ParsesOutOfRangeNumbers)
+{
+    const std::vector<std::pair<std::string, double>> numbers = {
+        {"1.0e400", HUGE_VAL},
+        {"-1e400", -HUGE_VAL},
+        {"123456e305", HUGE_VAL},
+        {"0.001e-400", 0.0},
+        {"-1e-400", -0.0},
+        {"1000e-330", 0.0},
+        {"1e-310", 1e-310},
+        {"0." + std::string(330, '0') + "1e5", 0.0},
+        {"1" + std::string(330, '0') + "e-5", HUGE_VAL},
+    };
+
+    for (const auto& [token, expected] : numbers) {
+        JsonNumber number;
+
+        ASSERT_TRUE(ParseJsonNumber(token, number).IsNone()) << token;
+        EXPECT_EQ(number.mType, JsonNumber::Type::eDouble) << token;
+        EXPECT_EQ(number.mDouble, expected) << token;
+        EXPECT_EQ(std::signbit(number.mDouble), std::signbit(expected)) << token;
+    }
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <Poco/JSON/Object.h>
+
+#include "utils/jsonstream.hpp"
+
+using namespace testing;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(JsonStreamReaderTest, ReadsConcatenatedJson)
+{
+    std::istringstream in(R"({"id":0,"text":"a}\"{"}
+[1,[2,3]] "str"  42 true{"id":1}
+
+invalid {"id":2}
+{"id":)");
+
+    JsonStreamReader   reader(in);
+    Poco::Dynamic::Var document;
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.extract<Poco::JSON::Object::Ptr>()->getValue<std::string>("text"), "a}\"{");
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.extract<Poco::JSON::Array::Ptr>()->size(), 2);
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.convert<std::string>(), "str");
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.convert<int>(), 42);
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.convert<bool>(), true);
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.extract<Poco::JSON::Object::Ptr>()->getValue<int>("id"), 1);
+
+    EXPECT_FALSE(reader.Next(document).IsNone());
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.extract<Poco::JSON::Object::Ptr>()->getValue<int>("id"), 2);
+
+    EXPECT_FALSE(reader.Next(document).IsNone());
+    EXPECT_TRUE(reader.Next(document).Is(ErrorEnum::eNotFound));
+    EXPECT_EQ(reader.GetRecordCount(), 9);
+}
+
+TEST(JsonStreamReaderTest, SkipsBrokenLines)
+{
+    std::istringstream in("{\"id\":0\n{\"id\":1}\n{\"text\":\"a\n[2] {\"id\":3}\r\n[\n{\"id\":4}");
+
+    JsonStreamReader   reader(in, JsonStreamReader::cDefaultMaxRecordSize, JsonStreamReader::Format::eLines);
+    Poco::Dynamic::Var document;
+
+    EXPECT_FALSE(reader.Next(document).IsNone());
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.extract<Poco::JSON::Object::Ptr>()->getValue<int>("id"), 1);
+
+    EXPECT_FALSE(reader.Next(document).IsNone());
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.extract<Poco::JSON::Array::Ptr>()->size(), 1);
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.extract<Poco::JSON::Object::Ptr>()->getValue<int>("id"), 3);
+
+    EXPECT_FALSE(reader.Next(document).IsNone());
+
+    ASSERT_TRUE(reader.Next(document).IsNone());
+    EXPECT_EQ(document.extract<Poco::JSON::Object::Ptr>()->getValue<int>("id"), 4);
+
+    EXPECT_TRUE(reader.Next(document).Is(ErrorEnum::eNotFound));
+    EXPECT_EQ(reader.GetRecordCount(), 7);
+}
+
+TEST(JsonStreamReaderTest, ReadsLargeStreamFromFD)
+{
+    const auto   cRecords = 10000;
+    std::string  content;
+    const auto   path = "stream.json";
+    Poco::UInt64 sum  = 0;
+
+    for (auto i = 0; i < cRecords; i++) {
+        content += R"({"id":)" + std::to_string(i) + R"(,"payload":")" + std::string(i % 100, 'x') + "\"}\n";
+        sum += i;
+    }
+
+    std::ofstream(path) << content;
+
+    for (size_t threads : {0, 4}) {
+        const auto fd = open(path, O_RDONLY);
+
+        ASSERT_GE(fd, 0);
+
+        JsonStreamReader reader(fd, JsonStreamReader::cDefaultMaxRecordSize, JsonStreamReader::Format::eLines);
+        std::mutex       mutex;
+        Poco::UInt64     idSum = 0, indexSum = 0;
+
+        auto err = reader.ForEach(
+            [&](size_t index, const RetWithError<Poco::Dynamic::Var>& record) {
+                ASSERT_TRUE(record.mError.IsNone());
+
+                std::lock_guard lock {mutex};
+
+                idSum += record.mValue.extract<Poco::JSON::Object::Ptr>()->getValue<int>("id");
+                indexSum += index;
+            },
+            threads);
+
+        close(fd);
+
+        EXPECT_TRUE(err.IsNone());
+        EXPECT_EQ(reader.GetRecordCount(), cRecords);
+        EXPECT_EQ(idSum, sum);
+        EXPECT_EQ(indexSum, sum);
+    }
+
+    std::remove(path);
+}
+
+TEST(JsonStreamReaderTest, FailsOnTooBigRecord)
+{
+    std::istringstream in(R"({"key":"value"} {"key":")" + std::string(1000, 'x') + "\"}");
+
+    JsonStreamReader   reader(in, 100);
+    Poco::Dynamic::Var document;
+
+    EXPECT_TRUE(reader.Next(document).IsNone());
+    EXPECT_TRUE(reader.Next(document).Is(ErrorEnum::eOutOfRange));
+    EXPECT_TRUE(reader.Next(document).Is(ErrorEnum::eOutOfRange));
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Poco/Dynamic/Struct.h>
+#include <Poco/JSON/Parser.h>
+#include <Poco/JSON/Stringifier.h>
+
+#include "utils/jsonwriter.hpp"
+
+using namespace testing;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(JsonWriterTest, WritesValues)
+{
+    JsonWriter writer;
+
+    writer.BeginObject()
+        .Key("str")
+        .Value("a\"b\\c/d\n\t\x01")
+        .Key("int")
+        .Value(-42)
+        .Key("uint")
+        .Value(std::numeric_limits<uint64_t>::max())
+        .Key("double")
+        .Value(2.5)
+        .Key("nan")
+        .Value(std::nan(""))
+        .Key("bool")
+        .Value(true)
+        .Key("null")
+        .Null()
+        .Key("array")
+        .BeginArray()
+        .Value(1)
+        .BeginObject()
+        .EndObject()
+        .BeginArray()
+        .EndArray()
+        .EndArray()
+        .EndObject();
+
+    ASSERT_TRUE(writer.GetError().IsNone());
+    EXPECT_EQ(writer.GetString(),
+        R"({"str":"a\"b\\c\/d\n\t\u0001","int":-42,"uint":18446744073709551615,"double":2.5,"nan":null,)"
+        R"("bool":true,"null":null,"array":[1,{},[]]})");
+}
+
+TEST(JsonWriterTest, WritesVar)
+{
+    const std::string json = R"({"key":"value","nested":{"array":[1,-2,2.5,true,null,"é"]},"empty":[]})";
+
+    auto var = Poco::JSON::Parser().parse(json);
+
+    JsonWriter writer;
+
+    writer.Value(var);
+
+    ASSERT_TRUE(writer.GetError().IsNone());
+
+    auto result = Poco::JSON::Parser().parse(writer.TakeString());
+    auto object = result.extract<Poco::JSON::Object::Ptr>();
+
+    EXPECT_EQ(object->getValue<std::string>("key"), "value");
+    EXPECT_EQ(object->getArray("empty")->size(), 0);
+
+    auto array = object->getObject("nested")->getArray("array");
+
+    ASSERT_EQ(array->size(), 6);
+    EXPECT_EQ(array->getElement<int>(0), 1);
+    EXPECT_EQ(array->getElement<int>(1), -2);
+    EXPECT_EQ(array->getElement<double>(2), 2.5);
+    EXPECT_EQ(array->getElement<bool>(3), true);
+    EXPECT_TRUE(array->isNull(4));
+    EXPECT_EQ(array->getElement<std::string>(5), "é");
+
+    EXPECT_TRUE(writer.GetString().empty());
+}
+
+TEST(JsonWriterTest, WritesVarAsStringifier)
+{
+    Poco::JSON::Object::Ptr object = new Poco::JSON::Object(Poco::JSON_PRESERVE_KEY_ORDER);
+    Poco::DynamicStruct     dynamicStruct;
+
+    dynamicStruct.insert("key", 1);
+
+    object->set("z", 1);
+    object->set("char", 'c');
+    object->set("vector", std::vector<Poco::Dynamic::Var>({1, "str"}));
+    object->set("struct", dynamicStruct);
+    object->set("a", "last");
+
+    std::ostringstream out;
+
+    Poco::JSON::Stringifier::stringify(object, out);
+
+    JsonWriter writer;
+
+    writer.Value(object);
+
+    ASSERT_TRUE(writer.GetError().IsNone());
+    EXPECT_EQ(writer.GetString(), out.str());
+    EXPECT_EQ(writer.GetString().substr(0, 15), R"({"z":1,"char":")");
+}
+
+TEST(JsonWriterTest, FlushesChunks)
+{
+    std::string output;
+    size_t      flushes = 0;
+
+    JsonWriter writer(
+        [&](std::string_view data) {
+            output.append(data);
+            flushes++;
+
+            return ErrorEnum::eNone;
+        },
+        16);
+
+    writer.BeginArray();
+
+    for (int i = 0; i < 100; i++) {
+        writer.Value("item");
+    }
+
+    writer.EndArray();
+
+    ASSERT_TRUE(writer.Flush().IsNone());
+    EXPECT_GT(flushes, 1);
+    EXPECT_EQ(output.size(), 2 + 100 * 6 + 99);
+    EXPECT_EQ(output.substr(0, 14), R"(["item","item")");
+}
+
+TEST(JsonWriterTest, ReportsErrors)
+{
+    JsonWriter writer;
+
+    EXPECT_FALSE(writer.BeginObject().Value(1).GetError().IsNone());
+
+    writer.Reset();
+
+    EXPECT_TRUE(writer.BeginArray().Value(1).EndArray().GetError().IsNone());
+
+    writer.Reset();
+
+    EXPECT_FALSE(writer.BeginArray().EndObject().GetError().IsNone());
+
+    JsonWriter failing([](std::string_view) { return Error(ErrorEnum::eFailed, "write failed"); }, 1);
+
+    failing.BeginArray().Value(1).EndArray();
+
+    EXPECT_TRUE(failing.Flush().Is(ErrorEnum::eFailed));
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "fileutils.hpp"
+#include "utils/merkle.hpp"
+
+using namespace testing;
+
+namespace fs = std::filesystem;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+// Changes one byte of the file in place.
+static void patchFile(const fs::path& path, size_t offset)
+{
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+
+    file.seekp(offset);
+    file.put('#');
+}
+
+class MerkleTreeTest : public Test {
+protected:
+    void SetUp() override
+    {
+        fs::remove_all(cTestDir);
+        fs::create_directories(cSourceDir / "etc" / "conf.d");
+        fs::create_directories(cSourceDir / "bin");
+
+        writeFile(cSourceDir / "etc" / "hosts", "127.0.0.1 localhost");
+        writeFile(cSourceDir / "etc" / "conf.d" / "app.conf", "key=value");
+        writeFile(cSourceDir / "etc-list", "etc");
+        writeFile(cSourceDir / "bin" / "app", makeContent(2 * cMerkleChunkSize + 17));
+        writeFile(cSourceDir / "empty", "");
+    }
+
+    void TearDown() override { fs::remove_all(cTestDir); }
+
+    const fs::path cTestDir   = "merkle_test";
+    const fs::path cSourceDir = cTestDir / "source";
+    const fs::path cTreePath  = cTestDir / "tree.merkle";
+};
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST_F(MerkleTreeTest, BuildsTree)
+{
+    MerkleTree tree;
+
+    ASSERT_EQ(tree.Scan(cSourceDir.string()), ErrorEnum::eNone);
+
+    std::vector<std::string> paths;
+
+    for (const auto& file : tree.GetFiles()) {
+        paths.push_back(file.mPath);
+    }
+
+    EXPECT_EQ(paths, std::vector<std::string>({"bin/app", "empty", "etc/conf.d/app.conf", "etc/hosts", "etc-list"}));
+
+    auto [file, err] = tree.FindFile("bin/app");
+
+    ASSERT_EQ(err, ErrorEnum::eNone);
+    EXPECT_EQ(file.mSize, 2 * cMerkleChunkSize + 17);
+    EXPECT_EQ(file.mChunks.size(), 3);
+
+    const auto hosts = tree.FindFile("etc/hosts").mValue;
+
+    EXPECT_EQ(hosts.mChunks, std::vector<std::string>({hosts.mHash}));
+    EXPECT_TRUE(tree.FindFile("empty").mValue.mChunks.empty());
+    EXPECT_EQ(tree.FindFile("etc").mError, ErrorEnum::eNotFound);
+    EXPECT_EQ(tree.FindFile("missing").mError, ErrorEnum::eNotFound);
+
+    // Flat digest is the one returned by HashDir.
+    EXPECT_EQ(tree.GetFlatDigest(), HashDir(cSourceDir.string()).mValue);
+    EXPECT_NE(tree.GetDigest(), tree.GetFlatDigest());
+
+    // Files order doesn't matter.
+    auto files = tree.GetFiles();
+
+    std::reverse(files.begin(), files.end());
+
+    MerkleTree other;
+
+    ASSERT_EQ(other.Build(files), ErrorEnum::eNone);
+    EXPECT_EQ(other.GetDigest(), tree.GetDigest());
+
+    files.push_back(files.back());
+    EXPECT_EQ(other.Build(files), ErrorEnum::eInvalidArgument);
+
+    files.back().mPath = "etc/hosts/file";
+    EXPECT_EQ(other.Build(files), ErrorEnum::eInvalidArgument);
+
+    files.back().mPath = "../file";
+    EXPECT_EQ(other.Build(files), ErrorEnum::eInvalidArgument);
+}
+
+TEST_F(MerkleTreeTest, SavesTree)
+{
+    MerkleTree tree;
+
+    ASSERT_EQ(tree.Scan(cSourceDir.string()), ErrorEnum::eNone);
+    ASSERT_EQ(tree.Save(cTreePath.string()), ErrorEnum::eNone);
+
+    MerkleTree loaded;
+
+    ASSERT_EQ(loaded.Load(cTreePath.string()), ErrorEnum::eNone);
+    EXPECT_EQ(loaded.GetDigest(), tree.GetDigest());
+    EXPECT_EQ(loaded.GetFlatDigest(), tree.GetFlatDigest());
+    EXPECT_EQ(loaded.FindFile("bin/app").mValue.mChunks, tree.FindFile("bin/app").mValue.mChunks);
+
+    // Stored directory hash doesn't match files.
+    auto data = readFile(cTreePath);
+    auto pos  = data.find("\nd ") + 3;
+
+    data[pos] = data[pos] == '0' ? '1' : '0';
+    writeFile(cTreePath, data);
+
+    EXPECT_EQ(loaded.Load(cTreePath.string()), ErrorEnum::eInvalidChecksum);
+
+    writeFile(cTreePath, "aosmerkle 1\nf 1 abc - file\n");
+    EXPECT_EQ(loaded.Load(cTreePath.string()), ErrorEnum::eInvalidArgument);
+
+    EXPECT_EQ(loaded.Load((cTestDir / "missing").string()), ErrorEnum::eNotFound);
+}
+
+TEST_F(MerkleTreeTest, VerifiesFiles)
+{
+    MerkleTree tree;
+
+    ASSERT_EQ(tree.Scan(cSourceDir.string()), ErrorEnum::eNone);
+
+    for (const auto& file : tree.GetFiles()) {
+        EXPECT_EQ(tree.VerifyFile(cSourceDir.string(), file.mPath), ErrorEnum::eNone) << file.mPath;
+    }
+
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(tree.VerifyChunk(cSourceDir.string(), "bin/app", i), ErrorEnum::eNone);
+    }
+
+    EXPECT_EQ(tree.VerifyChunk(cSourceDir.string(), "etc/hosts", 0), ErrorEnum::eNone);
+    EXPECT_EQ(tree.VerifyChunk(cSourceDir.string(), "bin/app", 3), ErrorEnum::eOutOfRange);
+    EXPECT_EQ(tree.VerifyChunk(cSourceDir.string(), "empty", 0), ErrorEnum::eOutOfRange);
+    EXPECT_EQ(tree.VerifyFile(cSourceDir.string(), "missing"), ErrorEnum::eNotFound);
+
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string()), ErrorEnum::eNone);
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string(), "etc"), ErrorEnum::eNone);
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string(), "etc/conf.d"), ErrorEnum::eNone);
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string(), "etc/hosts"), ErrorEnum::eNotFound);
+
+    // Only the changed chunk fails.
+    patchFile(cSourceDir / "bin" / "app", cMerkleChunkSize + 5);
+
+    EXPECT_EQ(tree.VerifyFile(cSourceDir.string(), "bin/app"), ErrorEnum::eInvalidChecksum);
+    EXPECT_EQ(tree.VerifyChunk(cSourceDir.string(), "bin/app", 0), ErrorEnum::eNone);
+    EXPECT_EQ(tree.VerifyChunk(cSourceDir.string(), "bin/app", 1), ErrorEnum::eInvalidChecksum);
+    EXPECT_EQ(tree.VerifyChunk(cSourceDir.string(), "bin/app", 2), ErrorEnum::eNone);
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string(), "bin"), ErrorEnum::eInvalidChecksum);
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string(), "etc"), ErrorEnum::eNone);
+
+    // Added and removed files are detected by the directory verification.
+    writeFile(cSourceDir / "etc" / "conf.d" / "extra.conf", "");
+
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string(), "etc/conf.d"), ErrorEnum::eInvalidChecksum);
+    EXPECT_EQ(tree.VerifyFile(cSourceDir.string(), "etc/conf.d/app.conf"), ErrorEnum::eNone);
+
+    fs::remove(cSourceDir / "etc" / "conf.d" / "extra.conf");
+    fs::remove(cSourceDir / "etc" / "hosts");
+
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string(), "etc"), ErrorEnum::eInvalidChecksum);
+    EXPECT_EQ(tree.VerifyDir(cSourceDir.string(), "etc/conf.d"), ErrorEnum::eNone);
+}
+
+TEST_F(MerkleTreeTest, DiffsTrees)
+{
+    MerkleTree tree, other;
+
+    ASSERT_EQ(tree.Scan(cSourceDir.string()), ErrorEnum::eNone);
+    ASSERT_EQ(other.Scan(cSourceDir.string()), ErrorEnum::eNone);
+
+    EXPECT_TRUE(tree.Diff(other).empty());
+
+    patchFile(cSourceDir / "bin" / "app", 0);
+    writeFile(cSourceDir / "etc" / "conf.d" / "extra.conf", "");
+    fs::remove(cSourceDir / "etc" / "hosts");
+    fs::remove(cSourceDir / "empty");
+
+    ASSERT_EQ(other.Scan(cSourceDir.string()), ErrorEnum::eNone);
+
+    const std::vector<std::string> expected({"bin/app", "empty", "etc/conf.d/extra.conf", "etc/hosts"});
+
+    EXPECT_EQ(tree.Diff(other), expected);
+    EXPECT_EQ(other.Diff(tree), expected);
+
+    // Whole directory replaced by a file.
+    fs::remove_all(cSourceDir / "etc");
+    writeFile(cSourceDir / "etc", "");
+
+    ASSERT_EQ(other.Scan(cSourceDir.string()), ErrorEnum::eNone);
+
+    EXPECT_EQ(tree.Diff(other),
+        std::vector<std::string>({"bin/app", "empty", "etc", "etc/conf.d/app.conf", "etc/hosts"}));
+    EXPECT_EQ(tree.Diff(MerkleTree()).size(), 5);
+}
+
+TEST_F(MerkleTreeTest, HashDirSavesTree)
+{
+    HashDirOptions options;
+
+    options.mMerklePath = cTreePath.string();
+    options.mCachePath  = (cTestDir / "hash.cache").string();
+
+    auto [digest, err] = HashDir(cSourceDir.string(), options);
+
+    ASSERT_EQ(err, ErrorEnum::eNone);
+    EXPECT_EQ(digest, HashDir(cSourceDir.string()).mValue);
+
+    MerkleTree tree, scanned;
+
+    ASSERT_EQ(tree.Load(cTreePath.string()), ErrorEnum::eNone);
+    ASSERT_EQ(scanned.Scan(cSourceDir.string()), ErrorEnum::eNone);
+
+    EXPECT_EQ(tree.GetFlatDigest(), digest);
+    EXPECT_EQ(tree.GetDigest(), scanned.GetDigest());
+
+    // Chunk hashes of cached files are reused from the tree.
+    options.mThreads = 4;
+
+    fs::remove(cSourceDir / "empty");
+
+    Tie(digest, err) = HashDir(cSourceDir.string(), options);
+
+    ASSERT_EQ(err, ErrorEnum::eNone);
+    ASSERT_EQ(tree.Load(cTreePath.string()), ErrorEnum::eNone);
+    ASSERT_EQ(scanned.Scan(cSourceDir.string()), ErrorEnum::eNone);
+
+    EXPECT_EQ(tree.GetFlatDigest(), digest);
+    EXPECT_EQ(tree.GetDigest(), scanned.GetDigest());
+    EXPECT_EQ(tree.FindFile("bin/app").mValue.mChunks.size(), 3);
+}
+
+} // namespace aos::common::utils
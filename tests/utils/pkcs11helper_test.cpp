@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <functional>
+#include <regex>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/pkcs11helper.hpp"
+
+using namespace testing;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+// Former regex based implementation used as the reference.
+static std::string createPKCS11URLRegex(const std::string& url)
+{
+    static const std::regex objLabelRegex {"object=[^&?;]*[&?;]?"};
+    static const std::regex modulePathRegex {"module\\-path=[^&?;]*[&?;]?"};
+
+    return std::regex_replace(std::regex_replace(url, objLabelRegex, ""), modulePathRegex, "");
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(PKCS11HelperTest, CreatePKCS11URL)
+{
+    auto result = CreatePKCS11URL(
+        "pkcs11:token=aos;object=diskencryption;id=%2b%3c?module-path=/usr/lib/softhsm/libsofthsm2.so&pin-value=1234");
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+    EXPECT_EQ(result.mValue, "pkcs11:token=aos;id=%2b%3c?pin-value=1234");
+}
+
+TEST(PKCS11HelperTest, CreatePKCS11URLMatchesRegex)
+{
+    // All strings up to 4 tokens: removing "object" may join "module" and "-path" into a new attribute.
+    const std::vector<std::string> tokens
+        = {"object=", "module-path=", "module", "-path=", "object", "=", "a", "&", "?", ";"};
+
+    std::function<void(const std::string&, size_t)> check = [&](const std::string& url, size_t depth) {
+        auto result = CreatePKCS11URL(url.c_str());
+
+        ASSERT_EQ(result.mError, ErrorEnum::eNone);
+        ASSERT_EQ(result.mValue, createPKCS11URLRegex(url)) << url;
+
+        if (depth == 4) {
+            return;
+        }
+
+        for (const auto& token : tokens) {
+            check(url + token, depth + 1);
+        }
+    };
+
+    check("", 0);
+}
+
+} // namespace aos::common::utils
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <sys/stat.h>
+
+#include <gtest/gtest.h>
+
+#include <Poco/Pipe.h>
+#include <Poco/PipeStream.h>
+#include <Poco/Process.h>
+#include <Poco/StreamCopier.h>
+
+#include "fileutils.hpp"
+#include "utils/tar.hpp"
+
+using namespace testing;
+
+namespace fs = std::filesystem;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+static void runTar(const Poco::Process::Args& args)
+{
+    Poco::Pipe          outPipe;
+    Poco::ProcessHandle ph = Poco::Process::launch("tar", args, nullptr, &outPipe, &outPipe);
+
+    if (ph.wait() != 0) {
+        std::string           output;
+        Poco::PipeInputStream istr(outPipe);
+        Poco::StreamCopier::copyToString(istr, output);
+
+        throw std::runtime_error("tar failed: " + output);
+    }
+}
+
+static std::string makeHeader(const std::string& name, char typeflag, size_t size, const std::string& linkName = "")
+{
+    std::string header(TarReader::cBlockSize, '\0');
+
+    name.copy(&header[0], 100);
+    std::snprintf(&header[100], 8, "%07o", 0644);
+    std::snprintf(&header[108], 8, "%07o", 0);
+    std::snprintf(&header[116], 8, "%07o", 0);
+    std::snprintf(&header[124], 12, "%011zo", size);
+    std::snprintf(&header[136], 12, "%011o", 1000000000);
+    header.replace(148, 8, 8, ' ');
+    header[156] = typeflag;
+    linkName.copy(&header[157], 100);
+    header.replace(257, 8, std::string("ustar\0" "00", 8));
+
+    unsigned checksum = 0;
+
+    for (auto c : header) {
+        checksum += static_cast<uint8_t>(c);
+    }
+
+    std::snprintf(&header[148], 8, "%06o", checksum);
+
+    return header;
+}
+
+static std::string makeEntry(const std::string& name, const std::string& data, char typeflag = '0')
+{
+    auto entry = makeHeader(name, typeflag, data.size()) + data;
+
+    entry.resize((entry.size() + TarReader::cBlockSize - 1) / TarReader::cBlockSize * TarReader::cBlockSize, '\0');
+
+    return entry;
+}
+
+static std::string makeArchive(const std::vector<std::string>& entries)
+{
+    std::string archive;
+
+    for (const auto& entry : entries) {
+        archive += entry;
+    }
+
+    return archive + std::string(2 * TarReader::cBlockSize, '\0');
+}
+
+static Error extract(const std::string& archive, const std::string& destination, size_t bufferSize = 512)
+{
+    std::istringstream in(archive);
+    TarReader          reader(in, bufferSize);
+
+    return ExtractTar(reader, destination);
+}
+
+class TarTest : public Test {
+protected:
+    void SetUp() override
+    {
+        fs::remove_all(cTestDir);
+        fs::create_directories(cSourceDir);
+        fs::create_directories(cDestinationDir);
+    }
+
+    void TearDown() override { RemoveAll(cTestDir); }
+
+    void RemoveAll(const fs::path& path)
+    {
+        for (const auto& entry : fs::recursive_directory_iterator(path)) {
+            if (entry.is_directory() && !entry.is_symlink()) {
+                fs::permissions(entry.path(), fs::perms::owner_all, fs::perm_options::add);
+            }
+        }
+
+        fs::remove_all(path);
+    }
+
+    void CreateSourceTree()
+    {
+        const auto longDir = cSourceDir / std::string(120, 'd') / std::string(150, 'e');
+
+        fs::create_directories(longDir);
+        fs::create_directories(cSourceDir / "dir" / "readonly");
+
+        writeFile(cSourceDir / "empty", "");
+        writeFile(cSourceDir / "dir" / "file", "file content");
+        writeFile(cSourceDir / "dir" / "readonly" / "file", "read only");
+        writeFile(longDir / std::string(200, 'f'), "long name");
+        writeFile(cSourceDir / "big", std::string(3 * 1024 * 1024 + 17, 'b'));
+
+        fs::create_symlink("dir/file", cSourceDir / "link");
+        fs::create_hard_link(cSourceDir / "dir" / "file", cSourceDir / "hardlink");
+
+        fs::permissions(cSourceDir / "dir" / "file",
+            fs::perms::owner_read | fs::perms::owner_write | fs::perms::owner_exec | fs::perms::group_read);
+        fs::last_write_time(cSourceDir / "dir" / "file",
+            std::chrono::time_point_cast<std::chrono::seconds>(fs::file_time_type::clock::now())
+                - std::chrono::hours(24 * 365));
+        fs::permissions(cSourceDir / "dir" / "readonly",
+            fs::perms::owner_read | fs::perms::owner_exec | fs::perms::group_read | fs::perms::group_exec);
+    }
+
+    const fs::path cTestDir        = "tar_test";
+    const fs::path cSourceDir      = cTestDir / "source";
+    const fs::path cDestinationDir = cTestDir / "destination";
+    const fs::path cArchivePath    = cTestDir / "archive.tar";
+};
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST_F(TarTest, ExtractsArchiveFormats)
+{
+    CreateSourceTree();
+
+    for (const auto* format : {"gnu", "pax", "oldgnu"}) {
+        fs::remove(cArchivePath);
+        RemoveAll(cDestinationDir);
+        fs::create_directories(cDestinationDir);
+
+        runTar({"--format", format, "-cf", cArchivePath.string(), "-C", cSourceDir.string(), "."});
+
+        std::ifstream archive(cArchivePath, std::ios::binary);
+        TarReader     reader(archive, 4096);
+
+        ASSERT_TRUE(ExtractTar(reader, cDestinationDir.string()).IsNone()) << format;
+
+        const auto longFile = cDestinationDir / std::string(120, 'd') / std::string(150, 'e') / std::string(200, 'f');
+
+        EXPECT_EQ(readFile(cDestinationDir / "dir" / "file"), "file content") << format;
+        EXPECT_EQ(readFile(cDestinationDir / "dir" / "readonly" / "file"), "read only") << format;
+        EXPECT_EQ(readFile(longFile), "long name") << format;
+        EXPECT_EQ(readFile(cDestinationDir / "big"), readFile(cSourceDir / "big")) << format;
+        EXPECT_TRUE(fs::is_regular_file(cDestinationDir / "empty")) << format;
+
+        EXPECT_TRUE(fs::is_symlink(cDestinationDir / "link")) << format;
+        EXPECT_EQ(fs::read_symlink(cDestinationDir / "link"), "dir/file") << format;
+        EXPECT_TRUE(fs::equivalent(cDestinationDir / "hardlink", cDestinationDir / "dir" / "file")) << format;
+
+        EXPECT_EQ(fs::status(cDestinationDir / "dir" / "file").permissions(),
+            fs::status(cSourceDir / "dir" / "file").permissions())
+            << format;
+        EXPECT_EQ(fs::status(cDestinationDir / "dir" / "readonly").permissions(),
+            fs::status(cSourceDir / "dir" / "readonly").permissions())
+            << format;
+        EXPECT_EQ(fs::last_write_time(cDestinationDir / "dir" / "file"),
+            fs::last_write_time(cSourceDir / "dir" / "file"))
+            << format;
+    }
+}
+
+TEST_F(TarTest, ReadsEntries)
+{
+    const auto archive = makeArchive({makeEntry("dir/", "", '5'), makeEntry("dir/file", std::string(1000, 'x')),
+        makeEntry("././@LongLink", std::string(300, 'n') + '\0', 'L'), makeEntry("short", "long"),
+        makeEntry("pax", "28 path=pax/overridden/path\n", 'x'), makeEntry("original", "pax"),
+        makeHeader("symlink", '2', 0, "dir/file")});
+
+    std::istringstream in(archive);
+    TarReader          reader(in, 700);
+    TarEntry           entry;
+    std::string        data;
+
+    ASSERT_TRUE(reader.Next(entry).IsNone());
+    EXPECT_EQ(entry.mPath, "dir/");
+    EXPECT_EQ(entry.mType, TarEntry::Type::eDirectory);
+    EXPECT_EQ(entry.mMode, 0644u);
+    EXPECT_EQ(entry.mMTime.tv_sec, 1000000000);
+
+    ASSERT_TRUE(reader.Next(entry).IsNone());
+    EXPECT_EQ(entry.mPath, "dir/file");
+    EXPECT_EQ(entry.mSize, 1000u);
+    EXPECT_EQ(entry.mOffset, 2 * TarReader::cBlockSize);
+
+    ASSERT_TRUE(reader.ReadData([&data](std::string_view chunk) {
+                          data.append(chunk);
+
+                          return ErrorEnum::eNone;
+                      })
+                    .IsNone());
+    EXPECT_EQ(data, std::string(1000, 'x'));
+
+    ASSERT_TRUE(reader.Next(entry).IsNone());
+    EXPECT_EQ(entry.mPath, std::string(300, 'n'));
+
+    ASSERT_TRUE(reader.Next(entry).IsNone());
+    EXPECT_EQ(entry.mPath, "pax/overridden/path");
+    EXPECT_EQ(entry.mSize, 3u);
+
+    ASSERT_TRUE(reader.Next(entry).IsNone());
+    EXPECT_EQ(entry.mType, TarEntry::Type::eSymLink);
+    EXPECT_EQ(entry.mLinkPath, "dir/file");
+
+    EXPECT_TRUE(reader.Next(entry).Is(ErrorEnum::eNotFound));
+    EXPECT_TRUE(reader.Next(entry).Is(ErrorEnum::eNotFound));
+    EXPECT_EQ(reader.GetOffset(), archive.size() - TarReader::cBlockSize);
+}
+
+TEST_F(TarTest, FailsOnMalformedArchive)
+{
+    auto corrupted = makeArchive({makeEntry("file", "data")});
+
+    corrupted[10] = 'x';
+
+    EXPECT_TRUE(extract(corrupted, cDestinationDir.string()).Is(ErrorEnum::eInvalidChecksum));
+
+    const auto truncated = makeEntry("file", std::string(2000, 'x')).substr(0, 1500);
+
+    EXPECT_TRUE(extract(truncated, cDestinationDir.string()).Is(ErrorEnum::eFailed));
+    EXPECT_TRUE(extract(std::string(100, 'x'), cDestinationDir.string()).Is(ErrorEnum::eFailed));
+    EXPECT_TRUE(extract(makeArchive({makeEntry("pax", "10 path\n", 'x'), makeEntry("file", "")}),
+        cDestinationDir.string())
+                    .Is(ErrorEnum::eFailed));
+    EXPECT_TRUE(extract(makeArchive({makeEntry("sparse", "", 'S')}), cDestinationDir.string())
+                    .Is(ErrorEnum::eNotSupported));
+    EXPECT_TRUE(extract("", cDestinationDir.string()).IsNone());
+}
+
+TEST_F(TarTest, RejectsUnsafePaths)
+{
+    EXPECT_TRUE(extract(makeArchive({makeEntry("dir/../../escaped", "data")}), cDestinationDir.string())
+                    .Is(ErrorEnum::eInvalidArgument));
+    EXPECT_TRUE(extract(makeArchive({makeHeader("escape", '2', 0, ".."), makeEntry("escape/escaped", "data")}),
+        cDestinationDir.string())
+                    .Is(ErrorEnum::eInvalidArgument));
+    EXPECT_TRUE(extract(makeArchive({makeHeader("hardlink", '1', 0, "../escaped")}), cDestinationDir.string())
+                    .Is(ErrorEnum::eInvalidArgument));
+    EXPECT_FALSE(fs::exists(cTestDir / "escaped"));
+
+    ASSERT_TRUE(extract(makeArchive({makeEntry("/absolute/./file", "data")}), cDestinationDir.string()).IsNone());
+    EXPECT_EQ(readFile(cDestinationDir / "absolute" / "file"), "data");
+}
+
+TEST_F(TarTest, ReplacesExistingEntries)
+{
+    fs::create_directories(cDestinationDir / "dir");
+    writeFile(cDestinationDir / "file", "old content");
+    writeFile(cDestinationDir / "target", "target");
+    fs::create_symlink("target", cDestinationDir / "symlink");
+
+    ASSERT_TRUE(extract(makeArchive({makeEntry("file", "new"), makeEntry("symlink", "regular"),
+                            makeHeader("file", '2', 0, "target"), makeEntry("dir/", "", '5')}),
+        cDestinationDir.string())
+                    .IsNone());
+
+    EXPECT_EQ(fs::read_symlink(cDestinationDir / "file"), "target");
+    EXPECT_EQ(readFile(cDestinationDir / "symlink"), "regular");
+    EXPECT_EQ(readFile(cDestinationDir / "target"), "target");
+    EXPECT_TRUE(extract(makeArchive({makeEntry("dir", "file")}), cDestinationDir.string())
+                    .Is(ErrorEnum::eAlreadyExist));
+}
+
+} // namespace aos::common::utils
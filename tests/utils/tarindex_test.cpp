@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2024 Renesas Electronics Corporation.
+ * Copyright (C) 2024 EPAM Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include <Poco/Process.h>
+
+#include "fileutils.hpp"
+#include "utils/tarindex.hpp"
+
+using namespace testing;
+
+namespace fs = std::filesystem;
+
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+class TarIndexTest : public Test {
+protected:
+    void SetUp() override
+    {
+        fs::remove_all(cTestDir);
+        fs::create_directories(cSourceDir / "dir" / std::string(150, 'd'));
+
+        writeFile(cSourceDir / "dir" / "config.json", R"({"key": "value"})");
+        writeFile(cSourceDir / "dir" / std::string(150, 'd') / std::string(150, 'f'), "long name");
+        writeFile(cSourceDir / "big", makeContent(3 * 1024 * 1024 + 17));
+        writeFile(cSourceDir / "empty", "");
+
+        fs::create_symlink("dir/config.json", cSourceDir / "link");
+        fs::create_hard_link(cSourceDir / "dir" / "config.json", cSourceDir / "hardlink");
+
+        Poco::Process::Args args {"--format", "gnu", "-cf", cArchivePath.string(), "-C", cSourceDir.string(), "."};
+
+        ASSERT_EQ(Poco::Process::launch("tar", args).wait(), 0);
+    }
+
+    void TearDown() override { fs::remove_all(cTestDir); }
+
+    const fs::path cTestDir     = "tar_index_test";
+    const fs::path cSourceDir   = cTestDir / "source";
+    const fs::path cArchivePath = cTestDir / "archive.tar";
+};
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST_F(TarIndexTest, ReadsEntries)
+{
+    TarIndex index;
+
+    ASSERT_EQ(index.Open(cArchivePath.string()), ErrorEnum::eNone);
+
+    EXPECT_TRUE(fs::exists(cArchivePath.string() + cTarIndexSuffix));
+    EXPECT_EQ(index.GetEntries().size(), 9);
+
+    auto [entry, err] = index.Find("/dir/./config.json");
+
+    ASSERT_EQ(err, ErrorEnum::eNone);
+    EXPECT_EQ(entry.mType, TarEntry::Type::eFile);
+    EXPECT_EQ(entry.mSize, 16);
+
+    EXPECT_EQ(index.ReadFile("dir/config.json").mValue, R"({"key": "value"})");
+    EXPECT_EQ(index.ReadFile("hardlink").mValue, R"({"key": "value"})");
+    EXPECT_EQ(index.ReadFile("dir/" + std::string(150, 'd') + "/" + std::string(150, 'f')).mValue, "long name");
+    EXPECT_EQ(index.ReadFile("big").mValue, readFile(cSourceDir / "big"));
+    EXPECT_EQ(index.ReadFile("empty").mValue, "");
+    EXPECT_EQ(index.Find("link").mValue.mLinkPath, "dir/config.json");
+
+    EXPECT_EQ(index.ReadFile("dir").mError, ErrorEnum::eInvalidArgument);
+    EXPECT_EQ(index.ReadFile("link").mError, ErrorEnum::eInvalidArgument);
+    EXPECT_EQ(index.ReadFile("missing").mError, ErrorEnum::eNotFound);
+    EXPECT_EQ(index.Find("../big").mError, ErrorEnum::eInvalidArgument);
+
+    // Partial reads.
+    Tie(entry, err) = index.Find("big");
+
+    char buffer[100];
+
+    auto result = index.Read(entry, entry.mSize - 10, buffer, sizeof(buffer));
+
+    ASSERT_EQ(result.mError, ErrorEnum::eNone);
+    EXPECT_EQ(std::string(buffer, result.mValue), makeContent(entry.mSize).substr(entry.mSize - 10));
+    EXPECT_EQ(index.Read(entry, entry.mSize, buffer, sizeof(buffer)).mValue, 0);
+}
+
+TEST_F(TarIndexTest, ReusesIndex)
+{
+    const auto indexPath = cTestDir / "index";
+
+    {
+        TarIndex index;
+
+        ASSERT_EQ(index.Open(cArchivePath.string(), indexPath.string()), ErrorEnum::eNone);
+    }
+
+    // Index file is used while the archive is unchanged: renamed entry is found by the new name.
+    auto data = readFile(indexPath);
+    auto pos  = data.find("config.json");
+
+    ASSERT_NE(pos, std::string::npos);
+
+    data.replace(pos, 6, "CONFIG");
+    writeFile(indexPath, data);
+
+    TarIndex index;
+
+    ASSERT_EQ(index.Open(cArchivePath.string(), indexPath.string()), ErrorEnum::eNone);
+    EXPECT_EQ(index.ReadFile("dir/CONFIG.json").mValue, R"({"key": "value"})");
+
+    // Changed archive is scanned again.
+    fs::last_write_time(cArchivePath, fs::last_write_time(cArchivePath) + std::chrono::seconds(1));
+
+    ASSERT_EQ(index.Open(cArchivePath.string(), indexPath.string()), ErrorEnum::eNone);
+    EXPECT_EQ(index.Find("dir/CONFIG.json").mError, ErrorEnum::eNotFound);
+    EXPECT_EQ(index.Find("dir/config.json").mError, ErrorEnum::eNone);
+
+    // Corrupted index is rebuilt.
+    writeFile(indexPath, readFile(indexPath).substr(0, 100));
+
+    ASSERT_EQ(index.Open(cArchivePath.string(), indexPath.string()), ErrorEnum::eNone);
+    EXPECT_EQ(index.GetEntries().size(), 9);
+
+    // Entry offset wrapping around with the size is rejected and the index is rebuilt.
+    data = readFile(indexPath);
+    pos  = data.find("dir/config.json");
+
+    ASSERT_NE(pos, std::string::npos);
+
+    // Offset is stored before size, mtime, five 32-bit fields, type and path length.
+    data.replace(pos - 57, sizeof(uint64_t), sizeof(uint64_t), '\xff');
+    writeFile(indexPath, data);
+
+    ASSERT_EQ(index.Open(cArchivePath.string(), indexPath.string()), ErrorEnum::eNone);
+    EXPECT_EQ(index.ReadFile("dir/config.json").mValue, R"({"key": "value"})");
+}
+
+TEST_F(TarIndexTest, RejectsInvalidArchives)
+{
+    TarIndex index;
+
+    EXPECT_EQ(index.Open((cTestDir / "missing.tar").string()), ErrorEnum::eNotFound);
+
+    // Truncated data of the skipped entry is detected.
+    fs::resize_file(cArchivePath, fs::file_size(cArchivePath) / 2);
+
+    EXPECT_EQ(index.Open(cArchivePath.string()), ErrorEnum::eFailed);
+
+    Poco::Process::Args args {"-czf", (cTestDir / "archive.tar.gz").string(), "-C", cSourceDir.string(), "."};
+
+    ASSERT_EQ(Poco::Process::launch("tar", args).wait(), 0);
+    EXPECT_EQ(index.Open((cTestDir / "archive.tar.gz").string()), ErrorEnum::eNotSupported);
+}
+
+} // namespace aos::common::utils
@@ -5,12 +5,68 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <functional>
+#include <map>
+#include <regex>
+
 #include <gtest/gtest.h>
 
 #include "utils/time.hpp"
 
 using namespace testing;
 
+namespace aos::common::utils {
+
+/***********************************************************************************************************************
+ * Static
+ **********************************************************************************************************************/
+
+// Former regex based implementation used as the reference.
+static RetWithError<Duration> parseDurationRegex(const std::string& durationStr)
+{
+    static const std::map<std::string, std::chrono::nanoseconds> units
+        = {{"ns", std::chrono::nanoseconds(1)}, {"us", std::chrono::microseconds(1)},
+            {"µs", std::chrono::microseconds(1)}, {"ms", std::chrono::milliseconds(1)}, {"s", std::chrono::seconds(1)},
+            {"m", std::chrono::minutes(1)}, {"h", std::chrono::hours(1)}, {"d", std::chrono::hours(24)},
+            {"w", std::chrono::hours(24 * 7)}, {"y", std::chrono::hours(24 * 365)}};
+
+    static const std::regex wholeStringPattern(R"((\d+(ns|us|µs|ms|s|m|h|d|w|y))+$)");
+    static const std::regex componentPattern(R"((\d+)(ns|us|µs|ms|s|m|h|d|w|y))");
+
+    if (!std::regex_match(durationStr, wholeStringPattern)) {
+        return {Duration {}, ErrorEnum::eInvalidArgument};
+    }
+
+    int64_t total      = 0;
+    bool    outOfRange = false;
+
+    for (auto it = std::sregex_iterator(durationStr.begin(), durationStr.end(), componentPattern);
+         it != std::sregex_iterator(); ++it) {
+        int64_t value = 0;
+
+        try {
+            value = std::stoll((*it)[1].str());
+        } catch (const std::out_of_range&) {
+            outOfRange = true;
+        }
+
+        int64_t component = 0;
+
+        if (__builtin_mul_overflow(units.at((*it)[2].str()).count(), value, &component)
+            || __builtin_add_overflow(total, component, &total)) {
+            outOfRange = true;
+        }
+    }
+
+    if (outOfRange) {
+        return {Duration {}, ErrorEnum::eOutOfRange};
+    }
+
+    return Duration(total);
+}
+
+} // namespace aos::common::utils
+
 /***********************************************************************************************************************
  * Tests
  **********************************************************************************************************************/
@@ -69,4 +125,45 @@ TEST(TimeTest, ParseDurationFromInvalidString)
     }
 }
 
+TEST(TimeTest, ParseDurationOutOfRange)
+{
+    EXPECT_EQ(ParseDuration("9223372036854775807ns").mValue.count(), 9223372036854775807);
+    EXPECT_EQ(ParseDuration("9223372036854775808ns").mError, ErrorEnum::eOutOfRange);
+    EXPECT_EQ(ParseDuration("292y").mError, ErrorEnum::eNone);
+    EXPECT_EQ(ParseDuration("300y").mError, ErrorEnum::eOutOfRange);
+    EXPECT_EQ(ParseDuration("292y292y").mError, ErrorEnum::eOutOfRange);
+    EXPECT_EQ(ParseDuration("99999999999999999999s1").mError, ErrorEnum::eInvalidArgument);
+}
+
+TEST(TimeTest, ParseDurationMatchesRegex)
+{
+    // All strings up to 5 tokens, "\xc2" is the first byte of "µ".
+    const std::vector<std::string> tokens
+        = {"0", "1", "9", "n", "u", "µ", "\xc2", "s", "m", "h", "y", "x", "-"};
+
+    std::function<void(const std::string&, size_t)> check = [&](const std::string& str, size_t depth) {
+        const auto expected = parseDurationRegex(str);
+        const auto result   = ParseDuration(str);
+
+        ASSERT_EQ(result.mError, expected.mError) << str;
+        ASSERT_EQ(result.mValue, expected.mValue) << str;
+
+        if (depth == 5) {
+            return;
+        }
+
+        for (const auto& token : tokens) {
+            check(str + token, depth + 1);
+        }
+    };
+
+    check("", 0);
+
+    for (const auto& str : {"20h20m20s200ms100us100ns", "1y1w1d1h1m1s1ms1us", "0001ms", "1µs1us", "1m1ms1s",
+             "15h20m20s20ms5", "12ms13"}) {
+        ASSERT_EQ(ParseDuration(str).mError, parseDurationRegex(str).mError) << str;
+        ASSERT_EQ(ParseDuration(str).mValue, parseDurationRegex(str).mValue) << str;
+    }
+}
+
 } // namespace aos::common::utils